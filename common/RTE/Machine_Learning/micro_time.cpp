@@ -15,55 +15,14 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/micro_time.h"
 
-// Set in micro/tools/make/targets/cortex_m_generic_makefile.inc.
-// Needed for the DWT and PMU counters.
-#ifdef CMSIS_DEVICE_ARM_CORTEX_M_XX_HEADER_FILE
-#include CMSIS_DEVICE_ARM_CORTEX_M_XX_HEADER_FILE
-#endif
+// Ticks come from the application's time base: the CPU cycle counter, at
+// SystemCoreClock ticks per second.
+#include "time_base.h"
 
 namespace tflite {
 
-uint32_t ticks_per_second() { return 0; }
+uint32_t ticks_per_second() { return time_base_ticks_per_second(); }
 
-uint32_t GetCurrentTimeTicks() {
-  static bool is_initialized = false;
-
-  if (!is_initialized) {
-#if (!defined(TF_LITE_STRIP_ERROR_STRINGS) && !defined(ARMCM0) && \
-     !defined(ARMCM0plus))
-#ifdef ARM_MODEL_USE_PMU_COUNTERS
-    ARM_PMU_Enable();
-    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
-
-    ARM_PMU_CYCCNT_Reset();
-    ARM_PMU_CNTR_Enable(PMU_CNTENSET_CCNTR_ENABLE_Msk);
-
-#else
-#ifdef ARMCM7
-    DWT->LAR = 0xC5ACCE55;
-#endif
-    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
-
-    // Reset and DWT cycle counter.
-    DWT->CYCCNT = 0;
-    DWT->CTRL |= 1UL;
-
-#endif
-#endif
-
-    is_initialized = true;
-  }
-
-#if (!defined(TF_LITE_STRIP_ERROR_STRINGS) && !defined(ARMCM0) && \
-     !defined(ARMCM0plus))
-#ifdef ARM_MODEL_USE_PMU_COUNTERS
-  return ARM_PMU_Get_CCNTR();
-#else
-  return DWT->CYCCNT;
-#endif
-#else
-  return 0;
-#endif
-}
+uint32_t GetCurrentTimeTicks() { return time_base_ticks(); }
 
 }  // namespace tflite
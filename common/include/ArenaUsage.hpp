@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ARENA_USAGE_HPP
+#define ARENA_USAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tflite {
+    class MicroAllocator;
+} /* namespace tflite */
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Reports how much of a tensor arena a model uses.
+     *
+     *          TFLM allocates non-persistent buffers (activations and scratch,
+     *          laid out by the memory planner) from the head of the arena and
+     *          persistent ones (tensor metadata, operator data) from its tail.
+     *          Both sizes are taken from the model's allocator.
+     *
+     *          The arena is also painted with a pattern before the model is
+     *          initialised, as a cross-check: the outermost bytes that no
+     *          longer hold the pattern show what was written. Model::Init()
+     *          writes temporary buffers above the head while it allocates, so
+     *          the written head may exceed the head the allocator keeps, and
+     *          the arena has to hold both.
+     *
+     *          Print() writes a line scripts/size_tensor_arena.py reads to set
+     *          ACTIVATION_BUF_SZ in the project.
+     */
+    class ArenaUsage {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   arena   Tensor arena.
+         * @param[in]   size    Size of the arena in bytes.
+         */
+        ArenaUsage(uint8_t* arena, size_t size);
+
+        /**
+         * @brief   Paints the arena. Call before Model::Init().
+         */
+        void Paint();
+
+        /**
+         * @brief       Reads the head and tail sizes from the allocator and
+         *              finds the written extent of the arena. Call after at
+         *              least one inference, once the activations have been
+         *              written. Takes 16 persistent bytes from the arena.
+         * @param[in]   allocator   Allocator of the model(s) in the arena,
+         *                          from Model::GetAllocator().
+         * @return      true if the sizes could be read.
+         */
+        bool Measure(tflite::MicroAllocator* allocator);
+
+        /** @brief  Bytes the allocator keeps at the head: non-persistent buffers. */
+        size_t GetHeadBytes() const;
+
+        /** @brief  Bytes the allocator keeps at the tail: persistent buffers. */
+        size_t GetTailBytes() const;
+
+        /** @brief  Bytes written from the head, including Init's temporary buffers. */
+        size_t GetHeadWrittenBytes() const;
+
+        /** @brief  Smallest arena the model is known to fit in. */
+        size_t GetUsedBytes() const;
+
+        /**
+         * @brief   Prints the measurements.
+         */
+        void Print() const;
+
+    private:
+        /* Persistent buffer allocated to find the end of the tail; TFLM
+         * aligns buffers in the arena to 16 bytes. */
+        static constexpr size_t ms_probeBytes = 16;
+
+        uint8_t* m_arena;
+        size_t m_size;
+        size_t m_head{0};
+        size_t m_tail{0};
+        size_t m_headWritten{0};
+        size_t m_probes{0};
+        bool m_painted{false};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* ARENA_USAGE_HPP */
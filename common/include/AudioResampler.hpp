@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AUDIO_RESAMPLER_HPP
+#define AUDIO_RESAMPLER_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Streaming, fixed-point polyphase sample-rate converter.
+     *
+     *          Converts a Q15 mono stream from the capture rate to the rate
+     *          the model expects (L/M rational resampling). The windowed-sinc
+     *          prototype filter is designed once at initialisation and split
+     *          into L branches; per output sample only one branch is evaluated,
+     *          so the cost is GetTapsPerPhase() MACs per output sample.
+     *          Filter history is carried across calls, so the input can be fed
+     *          block by block straight out of the DMA buffer.
+     *
+     * @note    Coefficients are allocated from the heap. 48 kHz needs under
+     *          200 bytes; 44.1 kHz (L = 160) uses the full ms_maxCoeffs budget.
+     */
+    class PolyphaseResampler {
+    public:
+        /* Upper bound on L. */
+        static constexpr uint32_t ms_maxPhases = 160;
+
+        /* Coefficient budget (Q15 values) shared by all branches. */
+        static constexpr uint32_t ms_maxCoeffs = 8192;
+
+        /* Taps per branch are a multiple of this to fill Helium Q15 vectors. */
+        static constexpr uint32_t ms_tapsAlignment = 8;
+
+        PolyphaseResampler() = default;
+        ~PolyphaseResampler() = default;
+
+        /**
+         * @brief       Initialises the converter for a given rate pair.
+         * @param[in]   inputRate       Sampling rate of the incoming stream (Hz).
+         * @param[in]   outputRate      Required sampling rate (Hz).
+         * @return      true if the rate pair is supported, false otherwise.
+         */
+        bool Init(uint32_t inputRate, uint32_t outputRate);
+
+        /**
+         * @brief       Resamples one block of input.
+         * @param[in]   src     Pointer to input samples.
+         * @param[in]   srcLen  Number of input samples.
+         * @param[out]  dst     Pointer to the output buffer.
+         * @param[in]   dstLen  Capacity of the output buffer in samples.
+         * @return      Number of output samples written.
+         */
+        uint32_t Process(const int16_t* src, uint32_t srcLen, int16_t* dst, uint32_t dstLen);
+
+        /**
+         * @brief   Clears the filter history and phase, e.g. after a capture gap.
+         */
+        void Reset();
+
+        /**
+         * @brief       Upper bound on output samples produced for an input block.
+         * @param[in]   srcLen  Number of input samples.
+         * @return      Maximum number of output samples.
+         */
+        uint32_t MaxOutputLen(uint32_t srcLen) const;
+
+        /** @brief  True if input and output rates are equal (plain copy). */
+        bool IsBypass() const;
+
+        /** @brief  Interpolation factor L. */
+        uint32_t GetUpFactor() const;
+
+        /** @brief  Decimation factor M. */
+        uint32_t GetDownFactor() const;
+
+        /** @brief  Number of MACs per output sample. */
+        uint32_t GetTapsPerPhase() const;
+
+    private:
+        /**
+         * @brief   Designs the windowed-sinc prototype and stores it as
+         *          time-reversed Q15 polyphase branches.
+         */
+        void DesignFilter();
+
+        uint32_t m_up{1};       /* Interpolation factor L. */
+        uint32_t m_down{1};     /* Decimation factor M. */
+        uint32_t m_taps{0};     /* Taps per branch. */
+        uint32_t m_phase{0};    /* Current polyphase branch (0..L-1). */
+        uint32_t m_position{0}; /* Index of the newest sample for the next output,
+                                 * counted from the start of the history. */
+        bool m_inited{false};
+
+        std::vector<int16_t> m_coeffs{};  /* L branches x m_taps, time-reversed. */
+        std::vector<int16_t> m_stitch{};  /* History (taps - 1) + head of current block. */
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* AUDIO_RESAMPLER_HPP */
@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AUDIO_SOURCE_HPP
+#define AUDIO_SOURCE_HPP
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   A set of mono Q15 clips that can be read block by block.
+     */
+    class AudioSource {
+    public:
+        virtual ~AudioSource() = default;
+
+        /** @brief  Number of clips available. */
+        virtual uint32_t GetNumClips() const = 0;
+
+        /**
+         * @brief       Selects a clip and rewinds to its first sample.
+         * @param[in]   idx     Clip index.
+         * @return      true if successful, false otherwise.
+         */
+        virtual bool SelectClip(uint32_t idx) = 0;
+
+        /** @brief  Name of the selected clip. */
+        virtual const char* GetClipName() const = 0;
+
+        /** @brief  Expected label of the selected clip, empty if unknown. */
+        virtual const char* GetClipLabel() const = 0;
+
+        /** @brief  Length of the selected clip in samples. */
+        virtual uint32_t GetClipLength() const = 0;
+
+        /**
+         * @brief       Copies the next samples of the selected clip.
+         * @param[out]  dst         Destination buffer.
+         * @param[in]   maxSamples  Number of samples requested.
+         * @return      Number of samples copied; less than requested at the end of the clip.
+         */
+        virtual uint32_t Read(int16_t* dst, uint32_t maxSamples) = 0;
+    };
+
+    /**
+     * @brief   Clips compiled into the image, accessed through the getters the
+     *          generated InputFiles sources provide.
+     */
+    class ArrayAudioSource : public AudioSource {
+    public:
+        using GetArrayFn    = const int16_t* (*)(const uint32_t);
+        using GetSizeFn     = uint32_t (*)(const uint32_t);
+        using GetFilenameFn = const char* (*)(const uint32_t);
+
+        ArrayAudioSource(uint32_t numClips,
+                         GetArrayFn getArray,
+                         GetSizeFn getSize,
+                         GetFilenameFn getFilename);
+
+        uint32_t GetNumClips() const override;
+        bool SelectClip(uint32_t idx) override;
+        const char* GetClipName() const override;
+        const char* GetClipLabel() const override;
+        uint32_t GetClipLength() const override;
+        uint32_t Read(int16_t* dst, uint32_t maxSamples) override;
+
+    private:
+        uint32_t m_numClips;
+        GetArrayFn m_getArray;
+        GetSizeFn m_getSize;
+        GetFilenameFn m_getFilename;
+
+        uint32_t m_clip{0};
+        uint32_t m_position{0};
+    };
+
+    /**
+     * @brief   Packed multi-clip corpus, typically in memory-mapped external flash.
+     *
+     *          Layout (little-endian), as written by scripts/pack_audio_corpus.py:
+     *          a CorpusHeader, numClips CorpusEntry records, then the samples of
+     *          each clip as 16-bit PCM at the offsets given by the entries.
+     */
+    class CorpusAudioSource : public AudioSource {
+    public:
+        /* 'KWSC' */
+        static constexpr uint32_t ms_magic   = 0x4353574B;
+        static constexpr uint16_t ms_version = 1;
+
+        struct CorpusHeader {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t entrySize;  /* sizeof(CorpusEntry). */
+            uint32_t numClips;
+            uint32_t sampleRate; /* Hz. */
+            uint32_t totalSize;  /* Bytes, header included. */
+            uint32_t crc32;      /* CRC-32 of bytes [sizeof(CorpusHeader), totalSize). */
+            uint32_t reserved[2];
+        };
+
+        struct CorpusEntry {
+            uint32_t offset;     /* Bytes from the start of the corpus, 16-byte aligned. */
+            uint32_t numSamples;
+            char label[24];      /* Expected keyword, NUL terminated. */
+            char name[32];       /* Source file name, NUL terminated. */
+        };
+
+        CorpusAudioSource() = default;
+
+        /**
+         * @brief       Parses and validates a corpus.
+         * @param[in]   base    Address of the corpus header.
+         * @param[in]   verify  Check the CRC over the whole corpus.
+         * @return      true if the corpus is usable, false otherwise.
+         */
+        bool Init(const void* base, bool verify);
+
+        /** @brief  Sampling rate the clips were packed at (Hz). */
+        uint32_t GetSampleRate() const;
+
+        uint32_t GetNumClips() const override;
+        bool SelectClip(uint32_t idx) override;
+        const char* GetClipName() const override;
+        const char* GetClipLabel() const override;
+        uint32_t GetClipLength() const override;
+        uint32_t Read(int16_t* dst, uint32_t maxSamples) override;
+
+    private:
+        const uint8_t* m_base{nullptr};
+        const CorpusHeader* m_header{nullptr};
+        const CorpusEntry* m_entries{nullptr};
+
+        uint32_t m_clip{0};
+        uint32_t m_position{0};
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* AUDIO_SOURCE_HPP */
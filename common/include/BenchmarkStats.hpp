@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BENCHMARK_STATS_HPP
+#define BENCHMARK_STATS_HPP
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Latency statistics over repeated runs of the same work, e.g. an
+     *          inference: min, mean, median, 99th percentile and max, in cycles
+     *          of the time base (time_base.h) and in microseconds.
+     *
+     *          Every sample is kept so that percentiles are exact; samples
+     *          beyond ms_maxSamples are counted in the mean, min and max only.
+     */
+    class BenchmarkStats {
+    public:
+        static constexpr uint32_t ms_maxSamples = 1024;
+
+        struct Summary {
+            uint32_t count;
+            uint32_t min;
+            uint32_t mean;
+            uint32_t p50;
+            uint32_t p99;
+            uint32_t max;
+        };
+
+        /**
+         * @brief       Adds a sample.
+         * @param[in]   cycles  Duration of one run.
+         */
+        void Add(uint32_t cycles);
+
+        /**
+         * @brief   Discards all samples.
+         */
+        void Reset();
+
+        /**
+         * @brief   Computes the statistics. Reorders the kept samples.
+         */
+        Summary Summarise();
+
+        /**
+         * @brief       Prints the statistics, readable and as one BENCHMARK line
+         *              for scripts.
+         * @param[in]   label   What was run, e.g. "inference".
+         */
+        void Print(const char* label);
+
+    private:
+        uint32_t m_samples[ms_maxSamples];
+        uint32_t m_count{0};
+        uint64_t m_sum{0};
+        uint32_t m_min{UINT32_MAX};
+        uint32_t m_max{0};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* BENCHMARK_STATS_HPP */
@@ -54,11 +54,36 @@
 /* Label section name */
 #define LABEL_SECTION section("labels")
 
+/* Set it to what the model needs with scripts/size_tensor_arena.py. */
 #ifndef ACTIVATION_BUF_SZ
 #warning "ACTIVATION_BUF_SZ needs to be defined. Using default value"
 #define ACTIVATION_BUF_SZ 0x00200000
 #endif /* ACTIVATION_BUF_SZ */
 
+/* Model copied from external flash into SRAM0 or SRAM1 at boot (ModelStaging.hpp). */
+#if defined(MODEL_STAGE_SRAM0)
+#define MODEL_STAGE_SECTION section(".bss.NoInit.model_stage_sram0")
+#elif defined(MODEL_STAGE_SRAM1)
+#define MODEL_STAGE_SECTION section(".bss.NoInit.model_stage_sram1")
+#endif /* defined(MODEL_STAGE_SRAM0) */
+
+#if defined(MODEL_STAGE_SECTION)
+#ifndef MODEL_STAGE_BUF_SZ
+#error "MODEL_STAGE_BUF_SZ needs to be defined to stage the model"
+#endif /* MODEL_STAGE_BUF_SZ */
+#ifndef MODEL_STAGE_CRC32
+#define MODEL_STAGE_CRC32 0 /* Unknown: the copy is checked against the source. */
+#endif /* MODEL_STAGE_CRC32 */
+#endif /* defined(MODEL_STAGE_SECTION) */
+
+/* Compressed model (scripts/compress_model.py) expanded into SRAM0 or SRAM1 at boot,
+ * next to a staged one (ModelCompression.hpp). */
+#if defined(MODEL_EXPAND_SRAM0)
+#define MODEL_EXPAND_SECTION section(".bss.NoInit.model_stage_sram0")
+#elif defined(MODEL_EXPAND_SRAM1)
+#define MODEL_EXPAND_SECTION section(".bss.NoInit.model_stage_sram1")
+#endif /* defined(MODEL_EXPAND_SRAM0) */
+
 /* IFM section name. */
 #define IFM_BUF_SECTION section("ifm")
 
@@ -68,6 +93,12 @@
 #define ACTIVATION_BUF_ATTRIBUTE MAKE_ATTRIBUTE(ACTIVATION_BUF_SECTION)
 #define IFM_BUF_ATTRIBUTE        MAKE_ATTRIBUTE(IFM_BUF_SECTION)
 #define LABELS_ATTRIBUTE         MAKE_ATTRIBUTE(LABEL_SECTION)
+#if defined(MODEL_STAGE_SECTION)
+#define MODEL_STAGE_ATTRIBUTE    MAKE_ATTRIBUTE(MODEL_STAGE_SECTION)
+#endif /* defined(MODEL_STAGE_SECTION) */
+#if defined(MODEL_EXPAND_SECTION)
+#define MODEL_EXPAND_ATTRIBUTE   MAKE_ATTRIBUTE(MODEL_EXPAND_SECTION)
+#endif /* defined(MODEL_EXPAND_SECTION) */
 
 #else /* HAVE_ATTRIBUTE(aligned) || (defined(__GNUC__) && !defined(__clang__)) */
 
@@ -75,6 +106,8 @@
 #define ACTIVATION_BUF_ATTRIBUTE
 #define IFM_BUF_ATTRIBUTE
 #define LABELS_ATTRIBUTE
+#define MODEL_STAGE_ATTRIBUTE
+#define MODEL_EXPAND_ATTRIBUTE
 
 #endif /* HAVE_ATTRIBUTE(aligned) || (defined(__GNUC__) && !defined(__clang__)) */
 
@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef GOLDEN_OUTPUT_HPP
+#define GOLDEN_OUTPUT_HPP
+
+#include "tensorflow/lite/c/common.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /** Reference contents of an output tensor. */
+    struct GoldenTensor {
+        TfLiteType type;
+        const uint8_t* data;
+        size_t bytes;
+    };
+
+    /**
+     * @brief   Compares output tensors with reference outputs recorded for the
+     *          same input, to show that a change to the model, its Vela variant
+     *          or the pre-processing keeps the outputs.
+     *
+     *          The reference outputs come from a run with GOLDEN_OUTPUT_DUMP,
+     *          turned into a source file by scripts/golden_output.py. Tensors
+     *          are checked in the order they were dumped, element by element:
+     *          the tolerance is in quantized steps for integer tensors, 0 for
+     *          bit-exact.
+     */
+    class GoldenOutput {
+    public:
+        /**
+         * @param[in]   golden      Reference tensors, in the order they are checked.
+         * @param[in]   count       Number of reference tensors.
+         * @param[in]   tolerance   Largest accepted difference of an element.
+         */
+        GoldenOutput(const GoldenTensor* golden, size_t count, float tolerance);
+
+        /**
+         * @brief       Compares a tensor with the next reference tensor and
+         *              prints its largest error.
+         * @param[in]   tensor  Output tensor after inference.
+         * @return      true if all elements are within the tolerance.
+         */
+        bool Check(const TfLiteTensor* tensor);
+
+        /**
+         * @brief   Prints the result over all checked tensors, readable and as
+         *          one GOLDEN line for scripts.
+         * @return  true if every reference tensor was checked and matched.
+         */
+        bool Print() const;
+
+        /**
+         * @brief       Prints the contents of a tensor as GOLDEN_DUMP lines, for
+         *              scripts/golden_output.py.
+         * @param[in]   tensor  Output tensor after inference.
+         * @param[in]   index   Position of the tensor in the run.
+         */
+        static void Dump(const TfLiteTensor* tensor, size_t index);
+
+    private:
+        const GoldenTensor* m_golden;
+        size_t m_count;
+        float m_tolerance;
+        size_t m_checked{0};
+        size_t m_failed{0};
+        float m_maxError{0.f};
+    };
+
+    namespace golden {
+        /* Reference outputs, from the source scripts/golden_output.py generates. */
+        extern const GoldenTensor tensors[];
+        extern const size_t numTensors;
+    } /* namespace golden */
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* GOLDEN_OUTPUT_HPP */
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Collects capture-to-decision latency for a streaming use case.
+     *
+     *          Each event is a set of tick timestamps, from the moment the newest
+     *          sample it covers was captured until the decision made on it. The
+     *          time spent in every stage, and the end-to-end total, is binned into
+     *          power-of-two millisecond buckets alongside min/mean/max.
+     */
+    class LatencyHistogram {
+    public:
+        enum Stage : uint32_t {
+            Capture = 0, /* Captured -> pre-processing started (buffering). */
+            PreProcess,  /* Pre-processing. */
+            Inference,   /* Inference. */
+            Decision,    /* Post-processing and decision. */
+            Total,       /* Captured -> decided. */
+            NumStages
+        };
+
+        /* Buckets: < 1 ms, < 2 ms, ..., < 1024 ms, and everything above. */
+        static constexpr uint32_t ms_numBuckets = 12;
+
+        /**
+         * @brief   Tick values taken along the pipeline for one event.
+         */
+        struct Timestamps {
+            uint32_t captured;        /* Newest sample of the window captured. */
+            uint32_t preProcessStart; /* Pre-processing started. */
+            uint32_t inferenceStart;  /* Inference started. */
+            uint32_t decisionStart;   /* Post-processing started. */
+            uint32_t decided;         /* Result available. */
+        };
+
+        /**
+         * @brief       Constructor.
+         * @param[in]   ticksPerSecond  Rate of the counter the timestamps come from.
+         */
+        explicit LatencyHistogram(uint32_t ticksPerSecond);
+
+        /**
+         * @brief       Adds an event.
+         * @param[in]   ts  Timestamps of the event.
+         * @return      End-to-end latency of the event in microseconds.
+         */
+        uint32_t Record(const Timestamps& ts);
+
+        /**
+         * @brief   Prints the histogram and per-stage statistics.
+         */
+        void Print() const;
+
+        /**
+         * @brief   Discards all recorded events.
+         */
+        void Reset();
+
+        /** @brief  Number of events recorded. */
+        uint32_t GetCount() const;
+
+    private:
+        uint32_t TicksToUs(uint32_t ticks) const;
+
+        uint32_t m_ticksPerSecond;
+        uint32_t m_count{0};
+        uint32_t m_buckets[NumStages][ms_numBuckets]{};
+        uint64_t m_sumUs[NumStages]{};
+        uint32_t m_minUs[NumStages]{};
+        uint32_t m_maxUs[NumStages]{};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* LATENCY_HISTOGRAM_HPP */
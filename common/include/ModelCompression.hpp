@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MODEL_COMPRESSION_HPP
+#define MODEL_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * Compressed models, as written by scripts/compress_model.py:
+     *
+     *      magic (u32), model bytes (u32), model CRC-32 (u32), block size (u32),
+     *      then per block: length (u32, bit 31 set if stored as is), data.
+     *
+     * Blocks are LZ4 blocks and expand to the block size, the last one to the
+     * rest of the model. All values are little-endian.
+     */
+    static constexpr uint32_t kModelLz4Magic  = 0x4D345A4C; /* "LZ4M" */
+    static constexpr uint32_t kModelLz4Stored = 0x80000000;
+
+    /**
+     * @brief       Size a compressed model expands to.
+     * @param[in]   src     Compressed model.
+     * @param[in]   srcLen  Its size in bytes.
+     * @return      Model bytes, or 0 if src is not a compressed model.
+     */
+    size_t ExpandedModelLen(const uint8_t* src, size_t srcLen);
+
+    /**
+     * @brief       Expands a compressed model into RAM, one block at a time,
+     *              and checks it against the CRC-32 it was compressed with.
+     *
+     *              The compressed data is read once, in order, so it can stay in
+     *              MRAM or in the external flash XIP window. Prints the
+     *              compression ratio and the time taken. The data cache is
+     *              cleaned over the model so that the NPU reads what the CPU
+     *              wrote, and with an NPU the model is registered read-only
+     *              with ethosu_mem_policy so inferences skip its maintenance.
+     * @param[in]   src     Compressed model.
+     * @param[in]   srcLen  Its size in bytes.
+     * @param[out]  dst     RAM to expand it to, aligned as models require.
+     * @param[in]   dstSize Size of dst in bytes.
+     * @return      dst, or nullptr if the model does not fit or is corrupted.
+     */
+    const uint8_t* ExpandModel(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstSize);
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* MODEL_COMPRESSION_HPP */
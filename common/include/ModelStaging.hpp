@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MODEL_STAGING_HPP
+#define MODEL_STAGING_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief       CRC-32 (IEEE 802.3, as zlib.crc32 and `crc32` compute it).
+     * @param[in]   data    Data.
+     * @param[in]   len     Size of the data in bytes.
+     * @param[in]   crc     CRC of the data before, to continue a running CRC.
+     * @return      CRC of all the data.
+     */
+    uint32_t Crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+    /**
+     * @brief       Copies a model, e.g. from the external flash XIP window, into
+     *              RAM and checks the copy.
+     *
+     *              The copy is compared to expectedCrc if given. Otherwise the
+     *              source is read again to compute its CRC, which is printed so
+     *              that it can be given next time (MODEL_STAGE_CRC32).
+     *              The data cache is cleaned over the copy so that the NPU reads
+     *              what the CPU wrote.
+     * @param[in]   src         Model flatbuffer.
+     * @param[in]   len         Size of the model in bytes.
+     * @param[out]  dst         RAM to copy it to, aligned as models require.
+     * @param[in]   dstSize     Size of dst in bytes.
+     * @param[in]   expectedCrc CRC-32 of the model, or 0 if not known.
+     * @return      dst, or nullptr if the model does not fit or the check fails.
+     */
+    const uint8_t* StageModel(const uint8_t* src,
+                              size_t len,
+                              uint8_t* dst,
+                              size_t dstSize,
+                              uint32_t expectedCrc = 0);
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* MODEL_STAGING_HPP */
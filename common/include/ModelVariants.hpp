@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MODEL_VARIANTS_HPP
+#define MODEL_VARIANTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   One build of a model: the CPU model, or its Vela output for an
+     *          Ethos-U configuration. The Ethos-U driver only runs command
+     *          streams compiled for the NPU's own number of MACs.
+     */
+    struct ModelVariant {
+        const char* name;                     /* e.g. "H256", as in the Vela file name. */
+        uint32_t npuArch;                     /* 55 or 65; 0 for the CPU model. */
+        uint32_t npuMacsPerCc;                /* 128, 256...; 0 for the CPU model. */
+        const uint8_t* (*getModelPointer)();
+        size_t (*getModelLen)();
+    };
+
+    /**
+     * @brief       Picks the variant of a model for the NPU found at boot, e.g.
+     *              with BoardGetNpuInfo: the first variant compiled for it,
+     *              else the first CPU variant. List the fastest variants first.
+     * @param[in]   variants    Variants of one model.
+     * @param[in]   count       Number of variants.
+     * @param[in]   npuArch     Ethos-U product, 55 or 65; 0 without an NPU.
+     * @param[in]   npuMacsPerCc MACs per cycle of the NPU; 0 without an NPU.
+     * @return      Variant to run, nullptr if none can run.
+     */
+    const ModelVariant* SelectModelVariant(const ModelVariant* variants,
+                                           size_t count,
+                                           uint32_t npuArch,
+                                           uint32_t npuMacsPerCc);
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* MODEL_VARIANTS_HPP */
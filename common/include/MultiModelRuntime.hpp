@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MULTI_MODEL_RUNTIME_HPP
+#define MULTI_MODEL_RUNTIME_HPP
+
+#include "ArenaUsage.hpp"
+#include "Model.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Runs several models out of one tensor arena.
+     *
+     *          The first model creates the TFLM allocator over the arena and
+     *          the others are initialised with the same allocator. Persistent
+     *          buffers of every model are stacked at the tail of the arena and
+     *          stay valid; the non-persistent buffers (activations, scratch,
+     *          and the input and output tensors) of all models start at the
+     *          head and overlay each other. The arena needs the sum of the
+     *          persistent sizes plus the largest non-persistent size, instead
+     *          of one arena per model.
+     *
+     *          Since the tensors overlay, only one model may be run at a time,
+     *          and its input must be written after any other model has run:
+     *          fill the input tensor, call RunInference(), and read the output
+     *          before running another model.
+     *
+     *          The allocator keeps the head at the largest non-persistent size
+     *          of the models initialised so far, and every Add() checks that
+     *          head plus the persistent buffers of all models against the
+     *          arena: models can be added in any order. Size the arena from
+     *          the report of PrintUsage() (scripts/size_tensor_arena.py reads
+     *          it).
+     */
+    class MultiModelRuntime {
+    public:
+        static constexpr size_t ms_maxModels = 4;
+
+        /**
+         * @brief       Constructor.
+         * @param[in]   arena   Tensor arena shared by the models.
+         * @param[in]   size    Size of the arena in bytes.
+         */
+        MultiModelRuntime(uint8_t* arena, size_t size);
+
+        /**
+         * @brief       Initialises a model in the shared arena.
+         * @param[in]   model       Model wrapper, not yet initialised. Must
+         *                          outlive the runtime.
+         * @param[in]   modelData   Model flatbuffer.
+         * @param[in]   modelLen    Size of the flatbuffer in bytes.
+         * @return      true if the model was initialised.
+         */
+        bool Add(Model& model, const uint8_t* modelData, uint32_t modelLen);
+
+        /**
+         * @brief       Runs one inference of a model added to the runtime.
+         * @param[in]   model   Model to run.
+         * @return      false if the model was not added, another model is
+         *              running, or the inference failed.
+         */
+        bool RunInference(Model& model);
+
+        /** @brief  Number of models added. */
+        size_t GetNumModels() const;
+
+        /**
+         * @brief   Prints the persistent bytes of each model and the arena use
+         *          of all of them, as held by the allocator. Call after every
+         *          model has run once.
+         */
+        void PrintUsage();
+
+    private:
+        int FindModel(const Model& model) const;
+
+        ArenaUsage m_usage;
+        uint8_t* m_arena;
+        size_t m_size;
+        Model* m_models[ms_maxModels]{};
+        size_t m_persistent[ms_maxModels]{}; /* Persistent bytes of each model. */
+        size_t m_numModels{0};
+        Model* m_running{nullptr};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* MULTI_MODEL_RUNTIME_HPP */
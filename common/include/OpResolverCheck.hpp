@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OP_RESOLVER_CHECK_HPP
+#define OP_RESOLVER_CHECK_HPP
+
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief       Checks, before the interpreter is built, that a resolver has
+     *              every operator a model uses. Each missing operator is reported.
+     * @param[in]   resolver    Populated resolver.
+     * @param[in]   modelData   Model flatbuffer.
+     * @param[out]  numUsed     Optional; number of distinct operators the model uses.
+     * @return      true if nothing is missing.
+     */
+    bool CheckOpResolver(const tflite::MicroOpResolver& resolver,
+                         const uint8_t* modelData,
+                         uint32_t* numUsed = nullptr);
+
+    /**
+     * @brief       Notes when more operators are registered than a model uses.
+     * @param[in]   numRegistered   Operators registered with the resolver.
+     * @param[in]   numUsed         Operators the model uses.
+     */
+    void ReportUnusedOperators(uint32_t numRegistered, uint32_t numUsed);
+
+    /**
+     * @brief       As above, also reporting operators registered but not used by
+     *              the model, i.e. kernels linked in for nothing.
+     */
+    template <unsigned int N>
+    bool CheckOpResolver(tflite::MicroMutableOpResolver<N>& resolver, const uint8_t* modelData)
+    {
+        uint32_t numUsed = 0;
+        if (!CheckOpResolver(static_cast<const tflite::MicroOpResolver&>(resolver),
+                             modelData,
+                             &numUsed)) {
+            return false;
+        }
+        ReportUnusedOperators(resolver.GetRegistrationLength(), numUsed);
+        return true;
+    }
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* OP_RESOLVER_CHECK_HPP */
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OPERATOR_PROFILER_HPP
+#define OPERATOR_PROFILER_HPP
+
+#include "Model.hpp"
+
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Per-operator profiler.
+     *
+     *          Acts as the op resolver of a model, handing out copies of the
+     *          registrations of the model's own resolver whose invoke is wrapped
+     *          with a measurement. For every node of the graph it accumulates
+     *          the CPU cycles spent in it and, where the core has a PMU, the
+     *          L1 data cache refills and MVE instructions retired. Nodes run by
+     *          the Ethos-U custom operator are reported as NPU, the rest as CPU
+     *          fallback.
+     *
+     *          Cycles of an NPU node are wall-clock: they include any overlap
+     *          work run while waiting for the NPU (see OverlappedInference).
+     *
+     *          Only one profiler can be measuring at a time.
+     */
+    class OperatorProfiler : public tflite::MicroOpResolver {
+    public:
+        /* Distinct operator types and graph nodes that can be profiled. */
+        static constexpr uint32_t ms_maxOpTypes = 24;
+        static constexpr uint32_t ms_maxNodes   = 160;
+
+        enum class Format { Table, Csv };
+
+        OperatorProfiler() = default;
+
+        /**
+         * @brief       Sets the resolver whose registrations are profiled.
+         * @param[in]   resolver    Resolver of the model, populated.
+         */
+        void Wrap(const tflite::MicroOpResolver& resolver);
+
+        /**
+         * @brief       Sets how often the profile is printed.
+         * @param[in]   inferences  Print after this many inferences, 0 for never.
+         * @param[in]   format      Output format.
+         */
+        void SetReportInterval(uint32_t inferences, Format format = Format::Table);
+
+        /**
+         * @brief       Prints the average per inference of every node.
+         * @param[in]   format  Output format.
+         */
+        void Print(Format format = Format::Table) const;
+
+        /** @brief  Discards the measurements. Registered operators are kept. */
+        void Reset();
+
+        /** @brief  Number of complete inferences measured. */
+        uint32_t GetInferenceCount() const;
+
+        /* tflite::MicroOpResolver overrides. */
+        const TfLiteRegistration* FindOp(tflite::BuiltinOperator op) const override;
+        const TfLiteRegistration* FindOp(const char* op) const override;
+        BuiltinParseFunction GetOpDataParser(tflite::BuiltinOperator op) const override;
+
+        /**
+         * @brief   Runs and measures a node for the active profiler. Called by
+         *          the wrapped registrations; not meant to be called directly.
+         */
+        static TfLiteStatus Dispatch(uint32_t opType, TfLiteContext* context, TfLiteNode* node);
+
+    private:
+        struct OpType {
+            TfLiteRegistration registration; /* Copy handed to the interpreter. */
+            TfLiteStatus (*invoke)(TfLiteContext*, TfLiteNode*); /* Original. */
+            const char* name;
+            bool npu;
+        };
+
+        struct NodeStats {
+            const TfLiteNode* node;
+            uint32_t opType;
+            uint64_t cycles;
+            uint64_t dcacheRefills;
+            uint64_t mveInstructions;
+        };
+
+        const TfLiteRegistration* Intercept(const TfLiteRegistration* reg, const char* name) const;
+        TfLiteStatus Invoke(uint32_t opType, TfLiteContext* context, TfLiteNode* node);
+        NodeStats* Lookup(const TfLiteNode* node, uint32_t opType);
+
+        const tflite::MicroOpResolver* m_resolver{nullptr};
+
+        /* Filled on demand while the interpreter resolves the graph. */
+        mutable OpType m_opTypes[ms_maxOpTypes]{};
+        mutable uint32_t m_numOpTypes{0};
+
+        NodeStats m_nodes[ms_maxNodes]{};
+        uint32_t m_numNodes{0};
+        uint32_t m_nextNode{0};
+        uint32_t m_inferences{0};
+        uint32_t m_reportInterval{0};
+        Format m_reportFormat{Format::Table};
+    };
+
+    /**
+     * @brief   A model whose operators are profiled: wraps the resolver of ModelT
+     *          in an OperatorProfiler. Declare it in place of the model, e.g.
+     *          ProfiledModel<MicroNetKwsModel>, and use it as before.
+     */
+    template <class ModelT>
+    class ProfiledModel : public ModelT {
+    public:
+        /** @brief  Profiler of this model, e.g. to set the report interval. */
+        OperatorProfiler& GetProfiler()
+        {
+            return this->m_profiler;
+        }
+
+    protected:
+        const tflite::MicroOpResolver& GetOpResolver() override
+        {
+            this->m_profiler.Wrap(ModelT::GetOpResolver());
+            return this->m_profiler;
+        }
+
+    private:
+        OperatorProfiler m_profiler;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+/* Format of the profiles the applications print with PROFILE_OPERATORS. */
+#if defined(PROFILE_OPERATORS_CSV)
+#define PROFILE_OPERATORS_FORMAT    arm::app::OperatorProfiler::Format::Csv
+#else
+#define PROFILE_OPERATORS_FORMAT    arm::app::OperatorProfiler::Format::Table
+#endif /* defined(PROFILE_OPERATORS_CSV) */
+
+#endif /* OPERATOR_PROFILER_HPP */
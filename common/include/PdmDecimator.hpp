@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PDM_DECIMATOR_HPP
+#define PDM_DECIMATOR_HPP
+
+#include "AudioResampler.hpp"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Converts a 1-bit PDM bitstream to Q15 PCM.
+     *
+     *          Stage 1 is a 4th order CIC decimating by 16. Its 61-tap impulse
+     *          response is applied through per-byte lookup tables, so one 16-bit
+     *          word of PDM bits (MSB first) costs eight table lookups.
+     *          Stage 2 is a 3-tap FIR that compensates the CIC pass-band droop.
+     *          Stage 3 is the polyphase low-pass decimator from
+     *          PolyphaseResampler, bringing the rate down to the PCM rate.
+     */
+    class PdmDecimator {
+    public:
+        /* CIC decimation factor; one 16-bit word of PDM bits per CIC output. */
+        static constexpr uint32_t ms_cicDecimation = 16;
+
+        /* CIC order. */
+        static constexpr uint32_t ms_cicOrder = 4;
+
+        PdmDecimator() = default;
+        ~PdmDecimator() = default;
+
+        /**
+         * @brief       Initialises the decimation chain.
+         * @param[in]   pcmRate         Output PCM sampling rate (Hz).
+         * @param[in]   oversampling    PDM clock / pcmRate; multiple of 16.
+         * @return      true if successful, false otherwise.
+         */
+        bool Init(uint32_t pcmRate, uint32_t oversampling);
+
+        /**
+         * @brief       Decimates a block of PDM bits.
+         * @param[in]   pdm     PDM words, MSB is the earliest bit.
+         * @param[in]   nWords  Number of 16-bit words.
+         * @param[out]  dst     PCM output buffer.
+         * @param[in]   dstLen  Capacity of the output buffer in samples.
+         * @return      Number of PCM samples written.
+         */
+        uint32_t Process(const uint16_t* pdm, uint32_t nWords, int16_t* dst, uint32_t dstLen);
+
+        /**
+         * @brief   Clears all filter state.
+         */
+        void Reset();
+
+        /** @brief  PDM clock frequency required for the configured PCM rate (Hz). */
+        uint32_t GetPdmClock() const;
+
+    private:
+        /* The CIC impulse response spans four words (64 bits); one table per byte. */
+        static constexpr uint32_t ms_cicWindowWords = 4;
+        static constexpr uint32_t ms_cicLutCount    = ms_cicWindowWords * 2;
+
+        /* CIC outputs handled per pass through the compensator and resampler. */
+        static constexpr uint32_t ms_chunkLen = 256;
+
+        uint32_t m_pdmClock{0};
+        int32_t m_compSide{0};    /* Compensator outer taps (Q14), negative. */
+        int32_t m_compCentre{0};  /* Compensator centre tap (Q14). */
+
+        int16_t m_cicLut[ms_cicLutCount][256]{};                  /* Signed partial sums. */
+        uint16_t m_pdmWork[ms_cicWindowWords - 1 + ms_chunkLen]{}; /* Word history + chunk. */
+        int16_t m_cicOut[ms_chunkLen]{};
+        int16_t m_compHistory[2]{};
+
+        PolyphaseResampler m_lowPass{};
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* PDM_DECIMATOR_HPP */
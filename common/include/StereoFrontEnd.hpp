@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STEREO_FRONT_END_HPP
+#define STEREO_FRONT_END_HPP
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Reduces an interleaved two-microphone stream to mono.
+     *
+     *          DelayAndSum delays one channel by a whole number of samples and
+     *          takes the rounded mean of both, steering the pair towards the
+     *          talker; a delay of zero is a plain (full precision) average.
+     *          BestChannel tracks the noise floor of each microphone and passes
+     *          through the one with the higher estimated SNR for each block.
+     *          Both modes accept in-place operation (mono == stereo).
+     */
+    class StereoFrontEnd {
+    public:
+        enum class Mode {
+            DelayAndSum,
+            BestChannel,
+        };
+
+        /* Largest steering delay supported, in samples (either direction). */
+        static constexpr int32_t ms_maxDelay = 32;
+
+        StereoFrontEnd() = default;
+        ~StereoFrontEnd() = default;
+
+        /**
+         * @brief       Configures the front-end.
+         * @param[in]   mode    Combining mode.
+         * @param[in]   delay   Steering delay in samples for DelayAndSum. Positive
+         *                      values delay the right channel, negative the left.
+         * @return      true if successful, false otherwise.
+         */
+        bool Init(Mode mode, int32_t delay);
+
+        /**
+         * @brief       Converts one block of interleaved stereo to mono.
+         * @param[in]   stereo  Interleaved L/R samples.
+         * @param[in]   frames  Number of stereo frames.
+         * @param[out]  mono    Output buffer of at least `frames` samples; may
+         *                      alias `stereo`.
+         */
+        void Process(const int16_t* stereo, uint32_t frames, int16_t* mono);
+
+        /**
+         * @brief   Clears the delay line and noise floor estimates.
+         */
+        void Reset();
+
+        /**
+         * @brief       Steering delay for a broadside-referenced direction.
+         * @param[in]   micSpacing  Distance between microphones (m).
+         * @param[in]   angle       Direction of arrival (degrees) from broadside,
+         *                          positive towards the right microphone.
+         * @param[in]   sampleRate  Sampling rate (Hz).
+         * @return      Delay in samples, clamped to +/- ms_maxDelay.
+         */
+        static int32_t SteeringDelay(float micSpacing, float angle, uint32_t sampleRate);
+
+        /** @brief  Channel used for the last BestChannel block (0 = left, 1 = right). */
+        uint32_t GetSelectedChannel() const;
+
+        /** @brief  Estimated SNR of a channel for the last block (dB). */
+        float GetChannelSnr(uint32_t channel) const;
+
+    private:
+        /**
+         * @brief   Updates the per-channel power, noise floor and SNR estimates
+         *          and picks the channel for this block.
+         */
+        void SelectChannel(const int16_t* stereo, uint32_t frames);
+
+        /* Stereo frames de-interleaved per pass. */
+        static constexpr uint32_t ms_chunkLen = 64;
+
+        Mode m_mode{Mode::DelayAndSum};
+        int32_t m_delay{0};
+        uint32_t m_selected{0};
+        float m_noiseFloor[2]{};
+        float m_snrDb[2]{};
+
+        /* Per-channel delay line: ms_maxDelay samples of history + one chunk. */
+        int16_t m_channel[2][ms_maxDelay + ms_chunkLen]{};
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* STEREO_FRONT_END_HPP */
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ETHOSU_NPU_PMU_H
+#define ETHOSU_NPU_PMU_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+struct ethosu_driver;
+
+/* Ethos-U AXI ports: AXI0 (SRAM) and AXI1 (M1, flash/external memory). */
+#define ETHOSU_NPU_PMU_AXI_PORTS    (2)
+
+/**
+ * @brief   Ethos-U PMU counts accumulated over the command streams run since
+ *          the last reset. The NPU has four event counters: active cycles and
+ *          MAC active cycles are counted on every command stream, the read and
+ *          write beats of the two AXI ports on the command streams of
+ *          alternate inferences.
+ */
+typedef struct _ethosu_npu_pmu_stats {
+    uint32_t command_streams;   /* Command streams measured. */
+    uint64_t cycles;            /* NPU cycles from start to end of the command streams. */
+    uint64_t cpu_ticks;         /* The same span in time base ticks (time_base.h). */
+    uint64_t active_cycles;     /* Cycles the NPU was active. */
+    uint64_t idle_cycles;       /* Cycles the NPU was idle, e.g. waiting for the CPU. */
+    uint64_t mac_active_cycles; /* Cycles the MAC array was active. */
+    uint64_t axi_read_beats[ETHOSU_NPU_PMU_AXI_PORTS];
+    uint64_t axi_write_beats[ETHOSU_NPU_PMU_AXI_PORTS];
+    uint32_t axi_sampled[ETHOSU_NPU_PMU_AXI_PORTS]; /* Command streams each port was counted on. */
+} ethosu_npu_pmu_stats;
+
+/**
+ * @brief       Configures and starts the NPU PMU. Called from the driver's
+ *              ethosu_inference_begin hook.
+ * @param[in]   drv     Driver about to run a command stream.
+ */
+void ethosu_npu_pmu_begin(struct ethosu_driver* drv);
+
+/**
+ * @brief       Stops the NPU PMU and accumulates its counts. Called from the
+ *              driver's ethosu_inference_end hook.
+ * @param[in]   drv     Driver that ran the command stream.
+ */
+void ethosu_npu_pmu_end(struct ethosu_driver* drv);
+
+/**
+ * @brief       Gets the counts accumulated since the last reset.
+ * @param[out]  stats   Counts.
+ */
+void ethosu_npu_pmu_get_stats(ethosu_npu_pmu_stats* stats);
+
+/**
+ * @brief   Clears the accumulated counts, e.g. before each inference.
+ */
+void ethosu_npu_pmu_reset(void);
+
+/**
+ * @brief   Marks the start of an inference and selects the AXI port counted
+ *          on its command streams. Call before each inference.
+ */
+void ethosu_npu_pmu_next_inference(void);
+
+/**
+ * @brief       Prints counts per inference, next to the CPU cycles of the same
+ *              inferences, and how those split between the NPU command streams
+ *              and the CPU. Counts of an AXI port sampled on fewer command
+ *              streams than the others are scaled up.
+ * @param[in]   stats       Counts, e.g. from ethosu_npu_pmu_get_stats.
+ * @param[in]   inferences  Number of inferences the counts cover.
+ * @param[in]   cpu_cycles  CPU cycles spent in those inferences.
+ */
+void ethosu_npu_pmu_print(const ethosu_npu_pmu_stats* stats,
+                          uint32_t inferences,
+                          uint64_t cpu_cycles);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ETHOSU_NPU_PMU_H */
@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TIME_BASE_H
+#define TIME_BASE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Time base built on the CPU cycle counter (DWT CYCCNT, or the PMU cycle
+ * counter with ARM_MODEL_USE_PMU_COUNTERS), ticking at SystemCoreClock.
+ *
+ * The 32-bit counter wraps every few seconds (10.7 s at 400 MHz). The 64-bit
+ * functions extend it in software, which only notices a wrap if the time base
+ * is read at least once per wrap period: boards call time_base_update() from
+ * a periodic interrupt, e.g. SysTick set up by time_base_start_systick().
+ *
+ * All functions can be called from interrupt handlers.
+ */
+
+/**
+ * @brief   Enables the cycle counter. Called on first use if not before.
+ */
+void time_base_init(void);
+
+/**
+ * @brief   Programs SysTick to interrupt a few times per counter wrap period,
+ *          for boards whose SysTick is otherwise unused. The board's
+ *          SysTick_Handler must call time_base_update().
+ */
+void time_base_start_systick(void);
+
+/**
+ * @brief   Accounts for counter wraps. Call at least once per wrap period.
+ */
+void time_base_update(void);
+
+/**
+ * @brief   Ticks per second: SystemCoreClock at the time of the call.
+ */
+uint32_t time_base_ticks_per_second(void);
+
+/**
+ * @brief   Current value of the 32-bit cycle counter. Differences of two values
+ *          are valid across one wrap.
+ */
+uint32_t time_base_ticks(void);
+
+/**
+ * @brief   Ticks since time_base_init(), extended to 64 bits.
+ */
+uint64_t time_base_ticks64(void);
+
+/**
+ * @brief   Microseconds since time_base_init().
+ */
+uint64_t time_base_us(void);
+
+/**
+ * @brief       Converts a tick count, e.g. a difference of time_base_ticks()
+ *              values, to microseconds.
+ * @param[in]   ticks   Tick count.
+ * @return      Microseconds.
+ */
+uint64_t time_base_ticks_to_us(uint64_t ticks);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TIME_BASE_H */
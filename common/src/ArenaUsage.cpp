@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ArenaUsage.hpp"
+
+#include "log_macros.h"
+
+#include "tensorflow/lite/micro/micro_allocator.h"
+
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    /* Byte unlikely to be written by chance. A used byte holding it by chance at
+     * the very edge of a region makes that region look a few bytes smaller. */
+    static constexpr uint8_t kPaint = 0xA5;
+
+    ArenaUsage::ArenaUsage(uint8_t* arena, size_t size) : m_arena{arena}, m_size{size} {}
+
+    void ArenaUsage::Paint()
+    {
+        std::memset(this->m_arena, kPaint, this->m_size);
+        this->m_painted = true;
+    }
+
+    bool ArenaUsage::Measure(tflite::MicroAllocator* allocator)
+    {
+        if (!allocator) {
+            printf_err("No allocator to measure the arena of\n");
+            return false;
+        }
+
+        /* Head and tail together, before the probe below adds to the tail. */
+        const size_t used = allocator->used_bytes();
+
+        /* Persistent buffers are stacked down from the end of the arena: a new
+         * one sits right below the lowest, so its address gives the tail. */
+        const uint8_t* probe =
+            static_cast<const uint8_t*>(allocator->AllocatePersistentBuffer(ms_probeBytes));
+        if (!probe || probe < this->m_arena || probe >= this->m_arena + this->m_size) {
+            printf_err("Allocator does not serve this arena\n");
+            return false;
+        }
+        const size_t tailAll = static_cast<size_t>(this->m_arena + this->m_size - probe) -
+                               ms_probeBytes;
+        if (tailAll > used) {
+            printf_err("Allocator reports %zu bytes used, below its %zu-byte tail\n",
+                       used,
+                       tailAll);
+            return false;
+        }
+
+        /* Probes of earlier calls are part of the tail but not of the model. */
+        this->m_head = used - tailAll;
+        this->m_tail = tailAll - this->m_probes * ms_probeBytes;
+        ++this->m_probes;
+
+        if (!this->m_painted) {
+            this->m_headWritten = this->m_head;
+            return true;
+        }
+
+        /* Outermost written byte below the tail. Beyond the head it is left
+         * by the temporary buffers of Init, which the arena must hold too. */
+        size_t end = this->m_size - tailAll - ms_probeBytes;
+        while (end > 0 && this->m_arena[end - 1] == kPaint) {
+            --end;
+        }
+        this->m_headWritten = end > this->m_head ? end : this->m_head;
+        return true;
+    }
+
+    size_t ArenaUsage::GetHeadBytes() const
+    {
+        return this->m_head;
+    }
+
+    size_t ArenaUsage::GetTailBytes() const
+    {
+        return this->m_tail;
+    }
+
+    size_t ArenaUsage::GetHeadWrittenBytes() const
+    {
+        return this->m_headWritten;
+    }
+
+    size_t ArenaUsage::GetUsedBytes() const
+    {
+        return this->m_headWritten + this->m_tail;
+    }
+
+    void ArenaUsage::Print() const
+    {
+        info("Tensor arena: %zu of %zu bytes used: head (non-persistent) %zu, "
+             "tail (persistent) %zu, %zu free\n",
+             this->GetUsedBytes(),
+             this->m_size,
+             this->m_head,
+             this->m_tail,
+             this->m_size - this->GetUsedBytes());
+        if (this->m_headWritten > this->m_head) {
+            info("Tensor arena: Init wrote %zu bytes of temporary buffers past the head\n",
+                 this->m_headWritten - this->m_head);
+        }
+
+        /* Read by scripts/size_tensor_arena.py. */
+        info("ARENA_USAGE size=%zu head=%zu tail=%zu used=%zu\n",
+             this->m_size,
+             this->m_head,
+             this->m_tail,
+             this->GetUsedBytes());
+    }
+
+} /* namespace app */
+} /* namespace arm */
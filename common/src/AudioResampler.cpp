@@ -0,0 +1,276 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AudioResampler.hpp"
+
+#if !defined(HOST_BUILD)
+#include "arm_math.h"   /* Pulls in arm_mve.h when Helium is available. */
+#endif /* !defined(HOST_BUILD) */
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /* Blackman window transition width is ~5.5 / N cycles per sample. Aiming for a
+     * transition band of 20% of the narrower sampling rate gives 27.5 taps per
+     * branch for every unit of max(L, M) / L. */
+    static constexpr float kTapsPerUnitRatio = 27.5f;
+
+    /* PI of arm_math.h, which the host build does not include. */
+    static constexpr float kPi = 3.14159265358979f;
+
+    static uint32_t GreatestCommonDivisor(uint32_t a, uint32_t b)
+    {
+        while (b) {
+            const uint32_t t = a % b;
+            a                = b;
+            b                = t;
+        }
+        return a;
+    }
+
+    /**
+     * @brief   Q15 dot product of a branch with the same number of samples.
+     * @param[in]   coeffs  Time-reversed branch coefficients.
+     * @param[in]   samples Oldest sample of the window.
+     * @param[in]   taps    Number of taps (multiple of ms_tapsAlignment).
+     * @return  Sum of products in Q30.
+     */
+    static inline int64_t
+    DotProductQ15(const int16_t* coeffs, const int16_t* samples, uint32_t taps)
+    {
+        int64_t acc = 0;
+#if defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE)
+        for (uint32_t i = 0; i < taps; i += 8) {
+            acc = vmlaldavaq_s16(acc, vldrhq_s16(samples + i), vldrhq_s16(coeffs + i));
+        }
+#else  /* defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE) */
+        for (uint32_t i = 0; i < taps; ++i) {
+            acc += static_cast<int32_t>(coeffs[i]) * samples[i];
+        }
+#endif /* defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE) */
+        return acc;
+    }
+
+    static inline int16_t RoundAndSaturateQ30(int64_t acc)
+    {
+        acc = (acc + (1 << 14)) >> 15;
+        return static_cast<int16_t>(
+            std::min<int64_t>(std::max<int64_t>(acc, INT16_MIN), INT16_MAX));
+    }
+
+    bool PolyphaseResampler::Init(uint32_t inputRate, uint32_t outputRate)
+    {
+        this->m_inited = false;
+
+        if (!inputRate || !outputRate) {
+            printf_err("Invalid resampler configuration\n");
+            return false;
+        }
+
+        const uint32_t gcd = GreatestCommonDivisor(inputRate, outputRate);
+        this->m_up         = outputRate / gcd;
+        this->m_down       = inputRate / gcd;
+
+        if (this->m_up > ms_maxPhases) {
+            printf_err("Unsupported rate conversion %" PRIu32 " -> %" PRIu32 " Hz (L=%" PRIu32
+                       ")\n",
+                       inputRate,
+                       outputRate,
+                       this->m_up);
+            return false;
+        }
+
+        if (this->IsBypass()) {
+            this->m_taps = 0;
+            this->m_coeffs.clear();
+            this->m_stitch.clear();
+        } else {
+            const float ratio = static_cast<float>(std::max(this->m_up, this->m_down)) /
+                                static_cast<float>(this->m_up);
+            const uint32_t wanted   = static_cast<uint32_t>(std::ceil(kTapsPerUnitRatio * ratio));
+            const uint32_t affordable = ms_maxCoeffs / this->m_up;
+
+            this->m_taps = std::min(wanted + ms_tapsAlignment - 1, affordable) /
+                           ms_tapsAlignment * ms_tapsAlignment;
+            if (wanted > affordable) {
+                warn("Resampler taps limited to %" PRIu32 " (wanted %" PRIu32 ")\n",
+                     this->m_taps,
+                     wanted);
+            }
+
+            this->DesignFilter();
+            this->m_stitch.assign(2 * (this->m_taps - 1), 0);
+        }
+
+        this->Reset();
+        this->m_inited = true;
+
+        info("Resampler: %" PRIu32 " Hz -> %" PRIu32 " Hz (L=%" PRIu32 ", M=%" PRIu32
+             ", %" PRIu32 " taps/branch)\n",
+             inputRate,
+             outputRate,
+             this->m_up,
+             this->m_down,
+             this->m_taps);
+        return true;
+    }
+
+    void PolyphaseResampler::DesignFilter()
+    {
+        const uint32_t taps   = this->m_taps;
+        const uint32_t length = this->m_up * taps;
+
+        /* Cut-off at the narrower Nyquist frequency, normalised to the upsampled rate. */
+        const float cutoff = 0.5f / static_cast<float>(std::max(this->m_up, this->m_down));
+        const float centre = 0.5f * static_cast<float>(length - 1);
+
+        std::vector<float> prototype(length);
+        float sum = 0.f;
+        for (uint32_t i = 0; i < length; ++i) {
+            const float t    = static_cast<float>(i) - centre;
+            const float sinc =
+                (t == 0.f) ? 2.f * cutoff : std::sin(2.f * kPi * cutoff * t) / (kPi * t);
+
+            /* Blackman window: ~74 dB stop-band, enough for 16-bit audio. */
+            const float x      = 2.f * kPi * static_cast<float>(i) / static_cast<float>(length - 1);
+            const float window = 0.42f - 0.5f * std::cos(x) + 0.08f * std::cos(2.f * x);
+
+            prototype[i] = sinc * window;
+            sum += prototype[i];
+        }
+
+        /* Zero stuffing by L divides the signal by L; each branch restores unity gain. */
+        const float gain = 32768.f * static_cast<float>(this->m_up) / sum;
+
+        /* Branch p holds h[p + k*L], stored reversed so it lines up with the
+         * oldest-to-newest order of the input samples. */
+        this->m_coeffs.assign(length, 0);
+        for (uint32_t p = 0; p < this->m_up; ++p) {
+            int16_t* branch = &this->m_coeffs[p * taps];
+            for (uint32_t k = 0; k < taps; ++k) {
+                const float c = std::round(prototype[p + k * this->m_up] * gain);
+                branch[taps - 1 - k] =
+                    static_cast<int16_t>(std::min(std::max(c, -32768.f), 32767.f));
+            }
+        }
+    }
+
+    void PolyphaseResampler::Reset()
+    {
+        std::fill(this->m_stitch.begin(), this->m_stitch.end(), 0);
+        this->m_phase    = 0;
+        this->m_position = this->m_taps ? this->m_taps - 1 : 0;
+    }
+
+    uint32_t PolyphaseResampler::MaxOutputLen(uint32_t srcLen) const
+    {
+        return static_cast<uint32_t>((static_cast<uint64_t>(srcLen) * this->m_up) /
+                                     this->m_down) +
+               1;
+    }
+
+    bool PolyphaseResampler::IsBypass() const
+    {
+        return this->m_up == this->m_down;
+    }
+
+    uint32_t PolyphaseResampler::GetUpFactor() const
+    {
+        return this->m_up;
+    }
+
+    uint32_t PolyphaseResampler::GetDownFactor() const
+    {
+        return this->m_down;
+    }
+
+    uint32_t PolyphaseResampler::GetTapsPerPhase() const
+    {
+        return this->m_taps;
+    }
+
+    uint32_t PolyphaseResampler::Process(const int16_t* src,
+                                         uint32_t srcLen,
+                                         int16_t* dst,
+                                         uint32_t dstLen)
+    {
+        if (!this->m_inited) {
+            printf_err("Resampler not initialised\n");
+            return 0;
+        }
+
+        if (this->IsBypass()) {
+            const uint32_t n = std::min(srcLen, dstLen);
+            std::memcpy(dst, src, n * sizeof(int16_t));
+            return n;
+        }
+
+        /* Positions index the virtual stream [history (taps - 1) | src (srcLen)].
+         * Windows that start inside the history are read from the stitch buffer,
+         * which holds the history followed by the head of this block; all other
+         * windows are read straight from the caller's buffer, so the block
+         * itself is never copied. */
+        const uint32_t historyLen = this->m_taps - 1;
+        int16_t* const stitch     = this->m_stitch.data();
+        const uint32_t headLen    = std::min(srcLen, historyLen);
+        std::memcpy(stitch + historyLen, src, headLen * sizeof(int16_t));
+        std::fill(stitch + historyLen + headLen, stitch + 2 * historyLen, 0);
+
+        const uint32_t end = historyLen + srcLen;
+        uint32_t written   = 0;
+
+        while (this->m_position < end && written < dstLen) {
+            const uint32_t start   = this->m_position - historyLen;
+            const int16_t* window =
+                (start < historyLen) ? stitch + start : src + start - historyLen;
+            const int16_t* branch  = &this->m_coeffs[this->m_phase * this->m_taps];
+
+            dst[written++] = RoundAndSaturateQ30(DotProductQ15(branch, window, this->m_taps));
+
+            /* Advance by M in the upsampled domain. */
+            this->m_phase += this->m_down;
+            this->m_position += this->m_phase / this->m_up;
+            this->m_phase %= this->m_up;
+        }
+
+        if (this->m_position < end) {
+            /* Output buffer exhausted: drop the rest of this block to stay in step. */
+            warn("Resampler output truncated at %" PRIu32 " samples\n", written);
+            this->m_position = end;
+        }
+
+        /* The newest taps - 1 samples become the history for the next block. */
+        if (srcLen >= historyLen) {
+            std::memcpy(stitch, src + srcLen - historyLen, historyLen * sizeof(int16_t));
+        } else {
+            std::memmove(stitch, stitch + srcLen, historyLen * sizeof(int16_t));
+        }
+        this->m_position -= srcLen;
+
+        return written;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,207 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AudioSource.hpp"
+
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    static_assert(sizeof(CorpusAudioSource::CorpusHeader) == 32, "Corpus header layout changed");
+    static_assert(sizeof(CorpusAudioSource::CorpusEntry) == 64, "Corpus entry layout changed");
+
+    /**
+     * @brief   CRC-32 (IEEE 802.3, as zlib.crc32) over a buffer.
+     */
+    static uint32_t Crc32(const uint8_t* data, uint32_t len)
+    {
+        static uint32_t table[256];
+        static bool tableReady = false;
+
+        if (!tableReady) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (uint32_t k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+                }
+                table[i] = c;
+            }
+            tableReady = true;
+        }
+
+        uint32_t crc = 0xFFFFFFFF;
+        for (uint32_t i = 0; i < len; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    ArrayAudioSource::ArrayAudioSource(uint32_t numClips,
+                                       GetArrayFn getArray,
+                                       GetSizeFn getSize,
+                                       GetFilenameFn getFilename)
+        : m_numClips{numClips}, m_getArray{getArray}, m_getSize{getSize},
+          m_getFilename{getFilename}
+    {}
+
+    uint32_t ArrayAudioSource::GetNumClips() const
+    {
+        return this->m_numClips;
+    }
+
+    bool ArrayAudioSource::SelectClip(uint32_t idx)
+    {
+        if (idx >= this->m_numClips) {
+            return false;
+        }
+        this->m_clip     = idx;
+        this->m_position = 0;
+        return true;
+    }
+
+    const char* ArrayAudioSource::GetClipName() const
+    {
+        return this->m_getFilename(this->m_clip);
+    }
+
+    const char* ArrayAudioSource::GetClipLabel() const
+    {
+        return "";
+    }
+
+    uint32_t ArrayAudioSource::GetClipLength() const
+    {
+        return this->m_getSize(this->m_clip);
+    }
+
+    uint32_t ArrayAudioSource::Read(int16_t* dst, uint32_t maxSamples)
+    {
+        const uint32_t n = std::min(maxSamples, this->GetClipLength() - this->m_position);
+        std::memcpy(dst, this->m_getArray(this->m_clip) + this->m_position, n * sizeof(int16_t));
+        this->m_position += n;
+        return n;
+    }
+
+    bool CorpusAudioSource::Init(const void* base, bool verify)
+    {
+        this->m_base   = static_cast<const uint8_t*>(base);
+        this->m_header = static_cast<const CorpusHeader*>(base);
+
+        const CorpusHeader& h = *this->m_header;
+        if (h.magic != ms_magic || h.version != ms_version || h.entrySize != sizeof(CorpusEntry)) {
+            printf_err("No audio corpus (v%" PRIu16 ") found at %p\n", ms_version, base);
+            this->m_header = nullptr;
+            return false;
+        }
+
+        const uint64_t tableEnd =
+            sizeof(CorpusHeader) + static_cast<uint64_t>(h.numClips) * sizeof(CorpusEntry);
+        if (tableEnd > h.totalSize) {
+            printf_err("Corpus clip table exceeds corpus size\n");
+            this->m_header = nullptr;
+            return false;
+        }
+        this->m_entries = reinterpret_cast<const CorpusEntry*>(this->m_base + sizeof(CorpusHeader));
+
+        for (uint32_t i = 0; i < h.numClips; ++i) {
+            const CorpusEntry& e = this->m_entries[i];
+            if (e.offset < tableEnd ||
+                e.offset + static_cast<uint64_t>(e.numSamples) * sizeof(int16_t) > h.totalSize) {
+                printf_err("Corpus clip %" PRIu32 " out of bounds\n", i);
+                this->m_header = nullptr;
+                return false;
+            }
+        }
+
+        if (verify) {
+            const uint32_t crc = Crc32(this->m_base + sizeof(CorpusHeader),
+                                       h.totalSize - sizeof(CorpusHeader));
+            if (crc != h.crc32) {
+                printf_err("Corpus CRC mismatch: 0x%08" PRIx32 " != 0x%08" PRIx32 "\n",
+                           crc,
+                           h.crc32);
+                this->m_header = nullptr;
+                return false;
+            }
+        }
+
+        info("Audio corpus: %" PRIu32 " clips at %" PRIu32 " Hz, %" PRIu32 " bytes\n",
+             h.numClips,
+             h.sampleRate,
+             h.totalSize);
+        this->m_clip     = 0;
+        this->m_position = 0;
+        return true;
+    }
+
+    uint32_t CorpusAudioSource::GetSampleRate() const
+    {
+        return this->m_header ? this->m_header->sampleRate : 0;
+    }
+
+    uint32_t CorpusAudioSource::GetNumClips() const
+    {
+        return this->m_header ? this->m_header->numClips : 0;
+    }
+
+    bool CorpusAudioSource::SelectClip(uint32_t idx)
+    {
+        if (idx >= this->GetNumClips()) {
+            return false;
+        }
+        this->m_clip     = idx;
+        this->m_position = 0;
+        return true;
+    }
+
+    const char* CorpusAudioSource::GetClipName() const
+    {
+        return this->m_entries[this->m_clip].name;
+    }
+
+    const char* CorpusAudioSource::GetClipLabel() const
+    {
+        return this->m_entries[this->m_clip].label;
+    }
+
+    uint32_t CorpusAudioSource::GetClipLength() const
+    {
+        return this->m_entries[this->m_clip].numSamples;
+    }
+
+    uint32_t CorpusAudioSource::Read(int16_t* dst, uint32_t maxSamples)
+    {
+        const CorpusEntry& e = this->m_entries[this->m_clip];
+        const uint32_t n     = std::min(maxSamples, e.numSamples - this->m_position);
+
+        /* A single copy per block keeps XIP reads sequential. */
+        std::memcpy(dst,
+                    this->m_base + e.offset + this->m_position * sizeof(int16_t),
+                    n * sizeof(int16_t));
+        this->m_position += n;
+        return n;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BenchmarkStats.hpp"
+
+#include "log_macros.h"
+#include "time_base.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+namespace arm {
+namespace app {
+
+    void BenchmarkStats::Add(uint32_t cycles)
+    {
+        if (this->m_count < ms_maxSamples) {
+            this->m_samples[this->m_count] = cycles;
+        }
+        ++this->m_count;
+        this->m_sum += cycles;
+        this->m_min = std::min(this->m_min, cycles);
+        this->m_max = std::max(this->m_max, cycles);
+    }
+
+    void BenchmarkStats::Reset()
+    {
+        this->m_count = 0;
+        this->m_sum   = 0;
+        this->m_min   = UINT32_MAX;
+        this->m_max   = 0;
+    }
+
+    BenchmarkStats::Summary BenchmarkStats::Summarise()
+    {
+        Summary s{};
+        if (!this->m_count) {
+            return s;
+        }
+
+        const uint32_t kept = this->m_count < ms_maxSamples ? this->m_count : ms_maxSamples;
+        std::sort(this->m_samples, this->m_samples + kept);
+
+        /* Nearest-rank percentiles. */
+        const auto percentile = [this, kept](uint32_t p) {
+            const uint32_t rank = (p * kept + 99) / 100;
+            return this->m_samples[rank ? rank - 1 : 0];
+        };
+
+        s.count = this->m_count;
+        s.min   = this->m_min;
+        s.mean  = static_cast<uint32_t>(this->m_sum / this->m_count);
+        s.p50   = percentile(50);
+        s.p99   = percentile(99);
+        s.max   = this->m_max;
+        return s;
+    }
+
+    void BenchmarkStats::Print(const char* label)
+    {
+        const Summary s = this->Summarise();
+        if (!s.count) {
+            info("Benchmark %s: no samples\n", label);
+            return;
+        }
+
+        info("Benchmark %s over %" PRIu32 " runs, cycles (us): min %" PRIu32 " (%" PRIu64
+             "), mean %" PRIu32 " (%" PRIu64 "), p50 %" PRIu32 " (%" PRIu64 "), p99 %" PRIu32
+             " (%" PRIu64 "), max %" PRIu32 " (%" PRIu64 ")\n",
+             label,
+             s.count,
+             s.min,
+             time_base_ticks_to_us(s.min),
+             s.mean,
+             time_base_ticks_to_us(s.mean),
+             s.p50,
+             time_base_ticks_to_us(s.p50),
+             s.p99,
+             time_base_ticks_to_us(s.p99),
+             s.max,
+             time_base_ticks_to_us(s.max));
+        info("BENCHMARK name=%s runs=%" PRIu32 " min=%" PRIu32 " mean=%" PRIu32 " p50=%" PRIu32
+             " p99=%" PRIu32 " max=%" PRIu32 " hz=%" PRIu32 "\n",
+             label,
+             s.count,
+             s.min,
+             s.mean,
+             s.p50,
+             s.p99,
+             s.max,
+             time_base_ticks_per_second());
+    }
+
+} /* namespace app */
+} /* namespace arm */
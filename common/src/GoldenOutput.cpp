@@ -0,0 +1,190 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "GoldenOutput.hpp"
+
+#include "log_macros.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    /** Bytes of a GOLDEN_DUMP data line. */
+    static constexpr size_t kDumpLineBytes = 32;
+
+    /** Size of an element of the types compared, 0 for others. */
+    static size_t ElementSize(TfLiteType type)
+    {
+        switch (type) {
+            case kTfLiteInt8:
+            case kTfLiteUInt8:
+                return 1;
+            case kTfLiteInt16:
+                return 2;
+            case kTfLiteInt32:
+            case kTfLiteFloat32:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+
+    /** Element i of a buffer as a float. Integer types up to 32 bits convert
+     *  exactly or, for int32, close enough for an error. */
+    static float Element(TfLiteType type, const uint8_t* data, size_t i)
+    {
+        switch (type) {
+            case kTfLiteInt8:
+                return static_cast<int8_t>(data[i]);
+            case kTfLiteUInt8:
+                return data[i];
+            case kTfLiteInt16: {
+                int16_t v;
+                memcpy(&v, data + i * sizeof(v), sizeof(v));
+                return v;
+            }
+            case kTfLiteInt32: {
+                int32_t v;
+                memcpy(&v, data + i * sizeof(v), sizeof(v));
+                return static_cast<float>(v);
+            }
+            case kTfLiteFloat32: {
+                float v;
+                memcpy(&v, data + i * sizeof(v), sizeof(v));
+                return v;
+            }
+            default:
+                return 0.f;
+        }
+    }
+
+    GoldenOutput::GoldenOutput(const GoldenTensor* golden, size_t count, float tolerance)
+        : m_golden{golden}, m_count{count}, m_tolerance{tolerance}
+    {}
+
+    bool GoldenOutput::Check(const TfLiteTensor* tensor)
+    {
+        const size_t index = this->m_checked++;
+        if (index >= this->m_count) {
+            printf_err("Golden output: no reference for tensor %zu\n", index);
+            ++this->m_failed;
+            return false;
+        }
+
+        const GoldenTensor& golden = this->m_golden[index];
+        const size_t elementSize   = ElementSize(tensor->type);
+        if (!elementSize || tensor->type != golden.type || tensor->bytes != golden.bytes) {
+            printf_err("Golden output: tensor %zu is %s of %zu bytes, reference %s of %zu\n",
+                       index,
+                       TfLiteTypeGetName(tensor->type),
+                       tensor->bytes,
+                       TfLiteTypeGetName(golden.type),
+                       golden.bytes);
+            ++this->m_failed;
+            return false;
+        }
+
+        const size_t elements = tensor->bytes / elementSize;
+        float maxError        = 0.f;
+        size_t mismatches     = 0;
+        for (size_t i = 0; i < elements; ++i) {
+            const float error = std::fabs(Element(tensor->type, tensor->data.uint8, i) -
+                                          Element(golden.type, golden.data, i));
+            /* Written so that a NaN counts as a mismatch and as the max error. */
+            if (!(error <= this->m_tolerance)) {
+                ++mismatches;
+            }
+            if (!(error <= maxError)) {
+                maxError = error;
+            }
+        }
+
+        /* The error as a real value, for quantized tensors. */
+        const float scale = tensor->type == kTfLiteFloat32 || tensor->params.scale == 0.f
+                                ? 1.f
+                                : tensor->params.scale;
+        info("Golden output %zu: %zu elements, max error %.6g (%.6g real), %zu over %.6g%s\n",
+             index,
+             elements,
+             maxError,
+             maxError * scale,
+             mismatches,
+             this->m_tolerance,
+             mismatches ? " FAIL" : "");
+
+        if (!(maxError <= this->m_maxError)) {
+            this->m_maxError = maxError;
+        }
+        if (mismatches) {
+            ++this->m_failed;
+            return false;
+        }
+        return true;
+    }
+
+    bool GoldenOutput::Print() const
+    {
+        const bool pass = !this->m_failed && this->m_checked == this->m_count;
+        if (this->m_checked != this->m_count) {
+            printf_err("Golden output: %zu tensors checked, %zu in the reference\n",
+                       this->m_checked,
+                       this->m_count);
+        }
+        info("Golden output: %s, %zu of %zu tensors failed, max error %.6g\n",
+             pass ? "PASS" : "FAIL",
+             this->m_failed,
+             this->m_checked,
+             this->m_maxError);
+        info("GOLDEN result=%s checked=%zu reference=%zu failed=%zu max_error=%.6g "
+             "tolerance=%.6g\n",
+             pass ? "PASS" : "FAIL",
+             this->m_checked,
+             this->m_count,
+             this->m_failed,
+             this->m_maxError,
+             this->m_tolerance);
+        return pass;
+    }
+
+    void GoldenOutput::Dump(const TfLiteTensor* tensor, size_t index)
+    {
+        info("GOLDEN_DUMP index=%zu type=%s bytes=%zu scale=%.9g zero_point=%" PRId32 "\n",
+             index,
+             TfLiteTypeGetName(tensor->type),
+             tensor->bytes,
+             tensor->params.scale,
+             tensor->params.zero_point);
+
+        char hex[2 * kDumpLineBytes + 1];
+        for (size_t offset = 0; offset < tensor->bytes; offset += kDumpLineBytes) {
+            const size_t n = tensor->bytes - offset < kDumpLineBytes ? tensor->bytes - offset
+                                                                     : kDumpLineBytes;
+            for (size_t i = 0; i < n; ++i) {
+                static const char digits[] = "0123456789abcdef";
+                hex[2 * i]     = digits[tensor->data.uint8[offset + i] >> 4];
+                hex[2 * i + 1] = digits[tensor->data.uint8[offset + i] & 0xf];
+            }
+            hex[2 * n] = '\0';
+            info("GOLDEN_DATA index=%zu offset=%zu hex=%s\n", index, offset, hex);
+        }
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LatencyHistogram.hpp"
+
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+namespace arm {
+namespace app {
+
+    static const char* const kStageNames[LatencyHistogram::NumStages] = {
+        "capture", "preproc", "infer", "decide", "total"};
+
+    static uint32_t BucketIndex(uint32_t us)
+    {
+        uint32_t bucket = 0;
+        for (uint32_t ms = us / 1000; ms; ms >>= 1) {
+            ++bucket;
+        }
+        return std::min(bucket, LatencyHistogram::ms_numBuckets - 1);
+    }
+
+    LatencyHistogram::LatencyHistogram(uint32_t ticksPerSecond) : m_ticksPerSecond{ticksPerSecond}
+    {
+        this->Reset();
+    }
+
+    uint32_t LatencyHistogram::TicksToUs(uint32_t ticks) const
+    {
+        return static_cast<uint32_t>(static_cast<uint64_t>(ticks) * 1000000 /
+                                     this->m_ticksPerSecond);
+    }
+
+    uint32_t LatencyHistogram::Record(const Timestamps& ts)
+    {
+        /* Unsigned differences stay correct across one counter wrap. */
+        uint32_t us[NumStages];
+        us[Capture]    = this->TicksToUs(ts.preProcessStart - ts.captured);
+        us[PreProcess] = this->TicksToUs(ts.inferenceStart - ts.preProcessStart);
+        us[Inference]  = this->TicksToUs(ts.decisionStart - ts.inferenceStart);
+        us[Decision]   = this->TicksToUs(ts.decided - ts.decisionStart);
+        us[Total]      = this->TicksToUs(ts.decided - ts.captured);
+
+        for (uint32_t s = 0; s < NumStages; ++s) {
+            ++this->m_buckets[s][BucketIndex(us[s])];
+            this->m_sumUs[s] += us[s];
+            this->m_minUs[s] = std::min(this->m_minUs[s], us[s]);
+            this->m_maxUs[s] = std::max(this->m_maxUs[s], us[s]);
+        }
+        ++this->m_count;
+
+        return us[Total];
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        this->m_count = 0;
+        std::memset(this->m_buckets, 0, sizeof(this->m_buckets));
+        std::fill(std::begin(this->m_sumUs), std::end(this->m_sumUs), 0);
+        std::fill(std::begin(this->m_minUs), std::end(this->m_minUs), UINT32_MAX);
+        std::fill(std::begin(this->m_maxUs), std::end(this->m_maxUs), 0);
+    }
+
+    uint32_t LatencyHistogram::GetCount() const
+    {
+        return this->m_count;
+    }
+
+    void LatencyHistogram::Print() const
+    {
+        info("Latency histogram over %" PRIu32 " events (counts per stage):\n", this->m_count);
+        if (!this->m_count) {
+            return;
+        }
+
+        info("%-10s %8s %8s %8s %8s %8s\n",
+             "ms",
+             kStageNames[0],
+             kStageNames[1],
+             kStageNames[2],
+             kStageNames[3],
+             kStageNames[4]);
+
+        for (uint32_t b = 0; b < ms_numBuckets; ++b) {
+            char label[16];
+            if (b + 1 < ms_numBuckets) {
+                snprintf(label, sizeof(label), "< %" PRIu32, static_cast<uint32_t>(1u << b));
+            } else {
+                snprintf(label, sizeof(label), ">= %" PRIu32, static_cast<uint32_t>(1u << (b - 1)));
+            }
+
+            info("%-10s %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 "\n",
+                 label,
+                 this->m_buckets[Capture][b],
+                 this->m_buckets[PreProcess][b],
+                 this->m_buckets[Inference][b],
+                 this->m_buckets[Decision][b],
+                 this->m_buckets[Total][b]);
+        }
+
+        for (uint32_t s = 0; s < NumStages; ++s) {
+            info("%-8s min %8.3f ms, mean %8.3f ms, max %8.3f ms\n",
+                 kStageNames[s],
+                 this->m_minUs[s] / 1000.f,
+                 static_cast<float>(this->m_sumUs[s]) / this->m_count / 1000.f,
+                 this->m_maxUs[s] / 1000.f);
+        }
+    }
+
+} /* namespace app */
+} /* namespace arm */
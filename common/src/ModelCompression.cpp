@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ModelCompression.hpp"
+
+#include "ModelStaging.hpp" /* Crc32 */
+#include "log_macros.h"
+#include "time_base.h"
+
+#include "RTE_Components.h"
+#include CMSIS_device_header
+
+/* As BufAttributes.hpp, without the arena settings it requires. */
+#if defined(ETHOSU55) || defined(ETHOSU65)
+#define ARM_NPU
+#include "ethosu_mem_policy.h"
+#endif /* defined(ETHOSU55) || defined(ETHOSU65) */
+
+#include <cinttypes>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    static constexpr size_t kHeaderSize = 16;
+
+    static uint32_t ReadU32(const uint8_t* p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    /**
+     * @brief       Reads the extension bytes of an LZ4 length.
+     * @return      false if the input ends first.
+     */
+    static bool ReadLength(const uint8_t*& ip, const uint8_t* iend, size_t& len)
+    {
+        uint8_t byte;
+        do {
+            if (ip >= iend) {
+                return false;
+            }
+            byte = *ip++;
+            len += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    /**
+     * @brief       Decodes one LZ4 block to exactly outLen bytes. Matches may
+     *              reach back into earlier blocks, down to window.
+     * @return      false if the block is malformed.
+     */
+    static bool DecodeBlock(const uint8_t* src,
+                            size_t srcLen,
+                            uint8_t* out,
+                            size_t outLen,
+                            const uint8_t* window)
+    {
+        const uint8_t* ip   = src;
+        const uint8_t* iend = src + srcLen;
+        uint8_t* op         = out;
+        uint8_t* oend       = out + outLen;
+
+        for (;;) {
+            if (ip >= iend) {
+                return false;
+            }
+            const uint32_t token = *ip++;
+
+            size_t literals = token >> 4;
+            if (literals == 15 && !ReadLength(ip, iend, literals)) {
+                return false;
+            }
+            if (literals > static_cast<size_t>(iend - ip) ||
+                literals > static_cast<size_t>(oend - op)) {
+                return false;
+            }
+            std::memcpy(op, ip, literals);
+            op += literals;
+            ip += literals;
+
+            /* The last sequence has literals only. */
+            if (ip == iend) {
+                return op == oend;
+            }
+
+            if (iend - ip < 2) {
+                return false;
+            }
+            const size_t offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+            if (!offset || offset > static_cast<size_t>(op - window)) {
+                return false;
+            }
+
+            size_t length = token & 15;
+            if (length == 15 && !ReadLength(ip, iend, length)) {
+                return false;
+            }
+            length += 4;
+            if (length > static_cast<size_t>(oend - op)) {
+                return false;
+            }
+
+            const uint8_t* match = op - offset;
+            if (offset >= length) {
+                std::memcpy(op, match, length);
+                op += length;
+            } else {
+                /* Overlapping: a run repeating the last offset bytes. */
+                while (length--) {
+                    *op++ = *match++;
+                }
+            }
+        }
+    }
+
+    size_t ExpandedModelLen(const uint8_t* src, size_t srcLen)
+    {
+        if (srcLen < kHeaderSize || ReadU32(src) != kModelLz4Magic) {
+            return 0;
+        }
+        return ReadU32(src + 4);
+    }
+
+    const uint8_t* ExpandModel(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstSize)
+    {
+        const size_t len = ExpandedModelLen(src, srcLen);
+        if (!len) {
+            printf_err("Not a compressed model\n");
+            return nullptr;
+        }
+        if (len > dstSize) {
+            printf_err("Model of %zu bytes does not fit in the %zu byte buffer\n", len, dstSize);
+            return nullptr;
+        }
+
+        const uint32_t crc       = ReadU32(src + 8);
+        const uint32_t blockSize = ReadU32(src + 12);
+        const uint8_t* ip        = src + kHeaderSize;
+        const uint8_t* iend      = src + srcLen;
+        size_t done              = 0;
+
+        const uint32_t start = time_base_ticks();
+        while (blockSize && done < len) {
+            if (iend - ip < 4) {
+                break;
+            }
+            const uint32_t word  = ReadU32(ip);
+            const size_t size    = word & ~kModelLz4Stored;
+            const size_t outSize = len - done < blockSize ? len - done : blockSize;
+            ip += 4;
+            if (size > static_cast<size_t>(iend - ip)) {
+                break;
+            }
+
+            if (word & kModelLz4Stored) {
+                if (size != outSize) {
+                    break;
+                }
+                std::memcpy(dst + done, ip, size);
+            } else if (!DecodeBlock(ip, size, dst + done, outSize, dst)) {
+                break;
+            }
+            ip += size;
+            done += outSize;
+        }
+        const uint32_t expanded = time_base_ticks();
+
+        if (done != len) {
+            printf_err("Compressed model corrupted at byte %zu of %zu\n", done, len);
+            return nullptr;
+        }
+        const uint32_t dstCrc = Crc32(dst, len);
+        if (dstCrc != crc) {
+            printf_err("Expanded model CRC 0x%08" PRIx32 " does not match 0x%08" PRIx32 "\n",
+                       dstCrc,
+                       crc);
+            return nullptr;
+        }
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+        SCB_CleanDCache_by_Addr(dst, static_cast<int32_t>(len));
+#endif /* defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U) */
+#if defined(ARM_NPU)
+        /* Written once above, cleaned to memory: no maintenance per inference. */
+        ethosu_mem_policy_add(dst, len, ETHOSU_MEM_INHERIT | ETHOSU_MEM_READ_ONLY,
+                              "Expanded model");
+#endif /* defined(ARM_NPU) */
+
+        const size_t ratio = len * 100 / srcLen;
+        info("Model expanded: %zu bytes from %zu (%zu.%02zu:1) in %" PRIu64
+             " us, CRC-32 0x%08" PRIx32 "\n",
+             len,
+             srcLen,
+             ratio / 100,
+             ratio % 100,
+             time_base_ticks_to_us(expanded - start),
+             dstCrc);
+        return dst;
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ModelStaging.hpp"
+
+#include "log_macros.h"
+#include "time_base.h"
+
+#include "RTE_Components.h"
+#include CMSIS_device_header
+
+#include <cinttypes>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    /* Reflected polynomial of CRC-32. */
+    static constexpr uint32_t kCrc32Poly = 0xEDB88320;
+
+    uint32_t Crc32(const uint8_t* data, size_t len, uint32_t crc)
+    {
+        static uint32_t table[256];
+        static bool tableReady = false;
+
+        if (!tableReady) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    c = (c & 1) ? (c >> 1) ^ kCrc32Poly : c >> 1;
+                }
+                table[i] = c;
+            }
+            tableReady = true;
+        }
+
+        crc = ~crc;
+        for (size_t i = 0; i < len; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    const uint8_t* StageModel(const uint8_t* src,
+                              size_t len,
+                              uint8_t* dst,
+                              size_t dstSize,
+                              uint32_t expectedCrc)
+    {
+        if (len > dstSize) {
+            printf_err("Model of %zu bytes does not fit in the %zu byte staging buffer\n",
+                       len,
+                       dstSize);
+            return nullptr;
+        }
+
+        const uint32_t start = time_base_ticks();
+        std::memcpy(dst, src, len);
+        const uint32_t copied = time_base_ticks();
+
+        /* Without a reference, only the copy itself can be checked. */
+        const uint32_t srcCrc = expectedCrc ? expectedCrc : Crc32(src, len);
+        const uint32_t dstCrc = Crc32(dst, len);
+        if (dstCrc != srcCrc) {
+            printf_err("Staged model CRC 0x%08" PRIx32 " does not match %s 0x%08" PRIx32 "\n",
+                       dstCrc,
+                       expectedCrc ? "expected" : "source",
+                       srcCrc);
+            return nullptr;
+        }
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+        SCB_CleanDCache_by_Addr(dst, static_cast<int32_t>(len));
+#endif /* defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U) */
+
+        info("Model staged: %zu bytes from %p to %p in %" PRIu64 " us, CRC-32 0x%08" PRIx32
+             "%s\n",
+             len,
+             static_cast<const void*>(src),
+             static_cast<void*>(dst),
+             time_base_ticks_to_us(copied - start),
+             dstCrc,
+             expectedCrc ? " (as expected)" : "");
+        return dst;
+    }
+
+} /* namespace app */
+} /* namespace arm */
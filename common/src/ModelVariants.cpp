@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ModelVariants.hpp"
+
+#include "log_macros.h"
+
+#include <cinttypes>
+
+namespace arm {
+namespace app {
+
+    const ModelVariant* SelectModelVariant(const ModelVariant* variants,
+                                           size_t count,
+                                           uint32_t npuArch,
+                                           uint32_t npuMacsPerCc)
+    {
+        const ModelVariant* cpuVariant = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            const ModelVariant& variant = variants[i];
+            if (!variant.npuArch) {
+                cpuVariant = cpuVariant ? cpuVariant : &variant;
+            } else if (npuArch && variant.npuArch == npuArch &&
+                       variant.npuMacsPerCc == npuMacsPerCc) {
+                info("Model variant %s for Ethos-U%" PRIu32 "-%" PRIu32 "\n",
+                     variant.name,
+                     npuArch,
+                     npuMacsPerCc);
+                return &variant;
+            }
+        }
+
+        if (!cpuVariant) {
+            if (npuArch) {
+                printf_err("No model variant for Ethos-U%" PRIu32 "-%" PRIu32 " or the CPU\n",
+                           npuArch,
+                           npuMacsPerCc);
+            } else {
+                printf_err("No NPU and no CPU model variant\n");
+            }
+            return nullptr;
+        }
+
+        if (npuArch) {
+            info("No model variant for Ethos-U%" PRIu32 "-%" PRIu32 ", running %s on the CPU\n",
+                 npuArch,
+                 npuMacsPerCc,
+                 cpuVariant->name);
+        } else {
+            info("No NPU, running model variant %s on the CPU\n", cpuVariant->name);
+        }
+        return cpuVariant;
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MultiModelRuntime.hpp"
+
+#include "log_macros.h"
+
+namespace arm {
+namespace app {
+
+    MultiModelRuntime::MultiModelRuntime(uint8_t* arena, size_t size)
+        : m_usage{arena, size}, m_arena{arena}, m_size{size}
+    {}
+
+    bool MultiModelRuntime::Add(Model& model, const uint8_t* modelData, uint32_t modelLen)
+    {
+        if (this->m_numModels == ms_maxModels) {
+            printf_err("At most %zu models can share the arena\n", ms_maxModels);
+            return false;
+        }
+        if (this->m_running || this->FindModel(model) >= 0) {
+            printf_err("Model cannot be added\n");
+            return false;
+        }
+
+        /* The first model creates the allocator over the whole arena. */
+        tflite::MicroAllocator* allocator = nullptr;
+        if (this->m_numModels) {
+            allocator = this->m_models[0]->GetAllocator();
+        } else {
+            this->m_usage.Paint();
+        }
+
+        if (!model.Init(this->m_arena, this->m_size, modelData, modelLen, allocator)) {
+            printf_err("Failed to initialise model %zu in the shared arena\n", this->m_numModels);
+            return false;
+        }
+
+        /* Init allocates this model's persistent buffers below those of the
+         * models before it, and grows the shared head if its plan needs more:
+         * the growth of the tail the allocator reports is this model's share. */
+        const size_t tail = this->m_usage.GetTailBytes();
+        if (!this->m_usage.Measure(model.GetAllocator())) {
+            return false;
+        }
+        this->m_persistent[this->m_numModels] = this->m_usage.GetTailBytes() - tail;
+
+        this->m_models[this->m_numModels++] = &model;
+        return true;
+    }
+
+    bool MultiModelRuntime::RunInference(Model& model)
+    {
+        if (this->FindModel(model) < 0) {
+            printf_err("Model was not added to the runtime\n");
+            return false;
+        }
+        if (this->m_running) {
+            /* The running model's tensors would be overwritten. */
+            printf_err("Another model is running\n");
+            return false;
+        }
+
+        this->m_running = &model;
+        const bool ok   = model.RunInference();
+        this->m_running = nullptr;
+        return ok;
+    }
+
+    size_t MultiModelRuntime::GetNumModels() const
+    {
+        return this->m_numModels;
+    }
+
+    void MultiModelRuntime::PrintUsage()
+    {
+        if (!this->m_numModels || !this->m_usage.Measure(this->m_models[0]->GetAllocator())) {
+            return;
+        }
+
+        size_t persistent = 0;
+        for (size_t i = 0; i < this->m_numModels; ++i) {
+            info("Model %zu: %zu persistent bytes\n", i, this->m_persistent[i]);
+            persistent += this->m_persistent[i];
+        }
+        info("Shared arena: %zu persistent bytes for %zu models, %zu non-persistent bytes "
+             "shared\n",
+             persistent,
+             this->m_numModels,
+             this->m_usage.GetHeadBytes());
+        this->m_usage.Print();
+    }
+
+    int MultiModelRuntime::FindModel(const Model& model) const
+    {
+        for (size_t i = 0; i < this->m_numModels; ++i) {
+            if (this->m_models[i] == &model) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+} /* namespace app */
+} /* namespace arm */
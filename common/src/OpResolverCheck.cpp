@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "OpResolverCheck.hpp"
+
+#include "log_macros.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
+
+#include <cinttypes>
+
+namespace arm {
+namespace app {
+
+    bool CheckOpResolver(const tflite::MicroOpResolver& resolver,
+                         const uint8_t* modelData,
+                         uint32_t* numUsed)
+    {
+        const tflite::Model* model = tflite::GetModel(modelData);
+        const auto* opCodes        = model ? model->operator_codes() : nullptr;
+        if (!opCodes) {
+            printf_err("Model has no operator codes\n");
+            return false;
+        }
+
+        /* Operator codes are unique per model, so each is one distinct operator. */
+        uint32_t missing = 0;
+        for (const tflite::OperatorCode* opCode : *opCodes) {
+            const tflite::BuiltinOperator op = tflite::GetBuiltinCode(opCode);
+
+            if (op == tflite::BuiltinOperator_CUSTOM) {
+                const char* name = opCode->custom_code() ? opCode->custom_code()->c_str() : "";
+                if (!resolver.FindOp(name)) {
+                    printf_err("Op resolver is missing custom operator %s\n", name);
+                    ++missing;
+                }
+            } else if (!resolver.FindOp(op)) {
+                printf_err("Op resolver is missing operator %s\n",
+                           tflite::EnumNameBuiltinOperator(op));
+                ++missing;
+            }
+        }
+
+        if (numUsed) {
+            *numUsed = opCodes->size();
+        }
+        if (missing) {
+            printf_err("%" PRIu32 " operators missing; regenerate the resolver for this model "
+                       "(scripts/gen_op_resolver.py)\n", missing);
+            return false;
+        }
+        return true;
+    }
+
+    void ReportUnusedOperators(uint32_t numRegistered, uint32_t numUsed)
+    {
+        if (numRegistered > numUsed) {
+            info("Op resolver registers %" PRIu32 " operators, the model uses %" PRIu32
+                 "; scripts/gen_op_resolver.py can trim it\n", numRegistered, numUsed);
+        }
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,289 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "OperatorProfiler.hpp"
+
+#include "log_macros.h"
+#include "tensorflow/lite/micro/micro_time.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#include "RTE_Components.h"
+#include CMSIS_device_header
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__PMU_PRESENT) && (__PMU_PRESENT == 1U)
+#define OP_PROFILER_USE_PMU
+#endif
+
+namespace arm {
+namespace app {
+
+    /* Profiler the invoke thunks report to. */
+    static OperatorProfiler* s_profiler = nullptr;
+
+    /* Name of the custom operator running an Ethos-U command stream. */
+    static const char* const kEthosUOpName = "ethos-u";
+
+#if defined(OP_PROFILER_USE_PMU)
+    /* Event counters are 16 bits; each event uses a pair chained to 32 bits. */
+    static constexpr uint32_t kDcacheCounter = 0;
+    static constexpr uint32_t kMveCounter    = 2;
+
+    static void PmuInit()
+    {
+        static bool initialised = false;
+        if (initialised) {
+            return;
+        }
+        DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+        ARM_PMU_Enable();
+        ARM_PMU_Set_EVTYPER(kDcacheCounter, ARM_PMU_L1D_CACHE_REFILL);
+        ARM_PMU_Set_EVTYPER(kDcacheCounter + 1, ARM_PMU_CHAIN);
+        ARM_PMU_Set_EVTYPER(kMveCounter, ARM_PMU_MVE_INST_RETIRED);
+        ARM_PMU_Set_EVTYPER(kMveCounter + 1, ARM_PMU_CHAIN);
+        ARM_PMU_CNTR_Enable((0xFU << kDcacheCounter));
+        initialised = true;
+    }
+
+    static uint32_t PmuRead(uint32_t counter)
+    {
+        /* Re-read the high half in case the low half wrapped in between. */
+        uint32_t high;
+        uint32_t low;
+        do {
+            high = ARM_PMU_Get_EVCNTR(counter + 1);
+            low  = ARM_PMU_Get_EVCNTR(counter);
+        } while (high != ARM_PMU_Get_EVCNTR(counter + 1));
+        return (high << 16) | (low & 0xFFFF);
+    }
+#else
+    static void PmuInit() {}
+
+    static uint32_t PmuRead(uint32_t)
+    {
+        return 0;
+    }
+
+    static constexpr uint32_t kDcacheCounter = 0;
+    static constexpr uint32_t kMveCounter    = 0;
+#endif /* OP_PROFILER_USE_PMU */
+
+    using InvokeFn = TfLiteStatus (*)(TfLiteContext*, TfLiteNode*);
+
+    template <uint32_t I>
+    static TfLiteStatus InvokeThunk(TfLiteContext* context, TfLiteNode* node)
+    {
+        return OperatorProfiler::Dispatch(I, context, node);
+    }
+
+    /* One thunk per operator type: the thunk's index says which invoke to call. */
+    static const InvokeFn kThunks[] = {
+        InvokeThunk<0>,  InvokeThunk<1>,  InvokeThunk<2>,  InvokeThunk<3>,  InvokeThunk<4>,
+        InvokeThunk<5>,  InvokeThunk<6>,  InvokeThunk<7>,  InvokeThunk<8>,  InvokeThunk<9>,
+        InvokeThunk<10>, InvokeThunk<11>, InvokeThunk<12>, InvokeThunk<13>, InvokeThunk<14>,
+        InvokeThunk<15>, InvokeThunk<16>, InvokeThunk<17>, InvokeThunk<18>, InvokeThunk<19>,
+        InvokeThunk<20>, InvokeThunk<21>, InvokeThunk<22>, InvokeThunk<23>};
+    static_assert(sizeof(kThunks) / sizeof(kThunks[0]) == OperatorProfiler::ms_maxOpTypes,
+                  "One thunk is needed per operator type");
+
+    TfLiteStatus
+    OperatorProfiler::Dispatch(uint32_t opType, TfLiteContext* context, TfLiteNode* node)
+    {
+        return s_profiler->Invoke(opType, context, node);
+    }
+
+    void OperatorProfiler::Wrap(const tflite::MicroOpResolver& resolver)
+    {
+        this->m_resolver = &resolver;
+        s_profiler       = this;
+        PmuInit();
+    }
+
+    void OperatorProfiler::SetReportInterval(uint32_t inferences, Format format)
+    {
+        this->m_reportInterval = inferences;
+        this->m_reportFormat   = format;
+    }
+
+    const TfLiteRegistration* OperatorProfiler::FindOp(tflite::BuiltinOperator op) const
+    {
+        return this->Intercept(this->m_resolver->FindOp(op), tflite::EnumNameBuiltinOperator(op));
+    }
+
+    const TfLiteRegistration* OperatorProfiler::FindOp(const char* op) const
+    {
+        return this->Intercept(this->m_resolver->FindOp(op), op);
+    }
+
+    OperatorProfiler::BuiltinParseFunction
+    OperatorProfiler::GetOpDataParser(tflite::BuiltinOperator op) const
+    {
+        return this->m_resolver->GetOpDataParser(op);
+    }
+
+    const TfLiteRegistration* OperatorProfiler::Intercept(const TfLiteRegistration* reg,
+                                                          const char* name) const
+    {
+        if (!reg || !reg->invoke) {
+            return reg;
+        }
+
+        for (uint32_t i = 0; i < this->m_numOpTypes; ++i) {
+            if (this->m_opTypes[i].invoke == reg->invoke &&
+                0 == std::strcmp(this->m_opTypes[i].name, name)) {
+                return &this->m_opTypes[i].registration;
+            }
+        }
+
+        if (this->m_numOpTypes == ms_maxOpTypes) {
+            printf_err("Too many operator types to profile; %s is not profiled\n", name);
+            return reg;
+        }
+
+        OpType& type      = this->m_opTypes[this->m_numOpTypes];
+        type.registration = *reg;
+        type.invoke       = reg->invoke;
+        type.name         = name;
+        type.npu          = 0 == std::strcmp(name, kEthosUOpName);
+
+        type.registration.invoke = kThunks[this->m_numOpTypes++];
+        return &type.registration;
+    }
+
+    OperatorProfiler::NodeStats* OperatorProfiler::Lookup(const TfLiteNode* node, uint32_t opType)
+    {
+        /* Nodes run in the same order every inference: try the expected one. */
+        if (this->m_nextNode < this->m_numNodes &&
+            this->m_nodes[this->m_nextNode].node == node) {
+            return &this->m_nodes[this->m_nextNode++];
+        }
+
+        for (uint32_t i = 0; i < this->m_numNodes; ++i) {
+            if (this->m_nodes[i].node == node) {
+                this->m_nextNode = i + 1;
+                return &this->m_nodes[i];
+            }
+        }
+
+        if (this->m_numNodes == ms_maxNodes) {
+            return nullptr;
+        }
+
+        NodeStats& stats = this->m_nodes[this->m_numNodes++];
+        stats            = NodeStats{node, opType, 0, 0, 0};
+        this->m_nextNode = this->m_numNodes;
+        return &stats;
+    }
+
+    TfLiteStatus OperatorProfiler::Invoke(uint32_t opType, TfLiteContext* context, TfLiteNode* node)
+    {
+        /* Coming back to the first node means an inference has completed. */
+        if (this->m_numNodes && this->m_nodes[0].node == node) {
+            this->m_nextNode = 0;
+            ++this->m_inferences;
+            if (this->m_reportInterval && 0 == this->m_inferences % this->m_reportInterval) {
+                this->Print(this->m_reportFormat);
+            }
+        }
+
+        NodeStats* const stats = this->Lookup(node, opType);
+
+        const uint32_t dcache = PmuRead(kDcacheCounter);
+        const uint32_t mve    = PmuRead(kMveCounter);
+        const uint32_t start  = tflite::GetCurrentTimeTicks();
+
+        const TfLiteStatus status = this->m_opTypes[opType].invoke(context, node);
+
+        const uint32_t cycles = tflite::GetCurrentTimeTicks() - start;
+        if (stats) {
+            stats->cycles += cycles;
+            stats->dcacheRefills += PmuRead(kDcacheCounter) - dcache;
+            stats->mveInstructions += PmuRead(kMveCounter) - mve;
+        }
+        return status;
+    }
+
+    void OperatorProfiler::Print(Format format) const
+    {
+        const uint32_t n = this->GetInferenceCount();
+        if (!n) {
+            info("No complete inference profiled yet\n");
+            return;
+        }
+
+        uint64_t total = 0;
+        uint64_t cpu   = 0;
+        for (uint32_t i = 0; i < this->m_numNodes; ++i) {
+            total += this->m_nodes[i].cycles;
+            if (!this->m_opTypes[this->m_nodes[i].opType].npu) {
+                cpu += this->m_nodes[i].cycles;
+            }
+        }
+
+        if (format == Format::Csv) {
+            printf("node,operator,unit,cycles,percent,dcache_refills,mve_instructions\n");
+        } else {
+            info("Operator profile, average of %" PRIu32 " inferences:\n", n);
+            info("%4s %-24s %-4s %12s %6s %10s %10s\n",
+                 "node", "operator", "unit", "cycles", "%", "D$ refill", "MVE inst");
+        }
+
+        for (uint32_t i = 0; i < this->m_numNodes; ++i) {
+            const NodeStats& s = this->m_nodes[i];
+            const OpType& type = this->m_opTypes[s.opType];
+            const uint64_t permille = total ? s.cycles * 1000 / total : 0;
+
+            if (format == Format::Csv) {
+                printf("%" PRIu32 ",%s,%s,%" PRIu64 ",%" PRIu64 ".%" PRIu64 ",%" PRIu64
+                       ",%" PRIu64 "\n",
+                       i, type.name, type.npu ? "NPU" : "CPU", s.cycles / n,
+                       permille / 10, permille % 10, s.dcacheRefills / n, s.mveInstructions / n);
+            } else {
+                info("%4" PRIu32 " %-24.24s %-4s %12" PRIu64 " %4" PRIu64 ".%" PRIu64
+                     " %10" PRIu64 " %10" PRIu64 "\n",
+                     i, type.name, type.npu ? "NPU" : "CPU", s.cycles / n,
+                     permille / 10, permille % 10, s.dcacheRefills / n, s.mveInstructions / n);
+            }
+        }
+
+        if (format == Format::Table) {
+            info("Total %" PRIu64 " cycles per inference, %" PRIu64 " (%" PRIu64
+                 "%%) in CPU operators\n",
+                 total / n, cpu / n, total ? cpu * 100 / total : 0);
+        }
+    }
+
+    void OperatorProfiler::Reset()
+    {
+        this->m_numNodes   = 0;
+        this->m_nextNode   = 0;
+        this->m_inferences = 0;
+    }
+
+    uint32_t OperatorProfiler::GetInferenceCount() const
+    {
+        /* Inferences are counted when the next one starts; the latest is
+         * complete once all of its nodes have run. */
+        const bool latestDone = this->m_numNodes && this->m_nextNode == this->m_numNodes;
+        return this->m_inferences + (latestDone ? 1 : 0);
+    }
+
+} /* namespace app */
+} /* namespace arm */
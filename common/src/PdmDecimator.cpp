@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PdmDecimator.hpp"
+
+#include "arm_math.h"   /* Pulls in arm_mve.h when Helium is available. */
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /* Length of the CIC impulse response: order * (R - 1) + 1. */
+    static constexpr uint32_t kCicLength =
+        PdmDecimator::ms_cicOrder * (PdmDecimator::ms_cicDecimation - 1) + 1;
+
+    /* The droop is corrected exactly at this fraction of the PCM rate, which is
+     * the pass-band edge of the final low-pass stage. */
+    static constexpr float kDroopReference = 0.4f;
+
+    static inline int16_t SaturateQ15(int32_t value)
+    {
+        return static_cast<int16_t>(
+            std::min<int32_t>(std::max<int32_t>(value, INT16_MIN), INT16_MAX));
+    }
+
+    bool PdmDecimator::Init(uint32_t pcmRate, uint32_t oversampling)
+    {
+        if (!pcmRate || !oversampling || (oversampling % ms_cicDecimation)) {
+            printf_err("PDM oversampling must be a non-zero multiple of %" PRIu32 "\n",
+                       ms_cicDecimation);
+            return false;
+        }
+
+        this->m_pdmClock          = pcmRate * oversampling;
+        const uint32_t cicRate    = this->m_pdmClock / ms_cicDecimation;
+
+        if (!this->m_lowPass.Init(cicRate, pcmRate)) {
+            return false;
+        }
+
+        /* CIC impulse response: the order-fold convolution of an R-long boxcar.
+         * Its sum is R^order = 65536, i.e. a full-scale bitstream maps to +/-2^16. */
+        int32_t impulse[kCicLength] = {1};
+        uint32_t length = 1;
+        for (uint32_t stage = 0; stage < ms_cicOrder; ++stage) {
+            int32_t next[kCicLength] = {0};
+            for (uint32_t i = 0; i < length; ++i) {
+                for (uint32_t j = 0; j < ms_cicDecimation; ++j) {
+                    next[i + j] += impulse[i];
+                }
+            }
+            length += ms_cicDecimation - 1;
+            std::memcpy(impulse, next, sizeof(impulse));
+        }
+
+        /* Bit j of the 64-bit window (0 = oldest) is weighted by h[63 - j]. Table p
+         * holds the signed partial sum for every value of the p-th byte, with a set
+         * bit counting as +1 and a clear bit as -1. */
+        constexpr uint32_t windowBits = ms_cicWindowWords * 16;
+        for (uint32_t p = 0; p < ms_cicLutCount; ++p) {
+            for (uint32_t value = 0; value < 256; ++value) {
+                int32_t sum = 0;
+                for (uint32_t i = 0; i < 8; ++i) {
+                    const uint32_t k = windowBits - 1 - (8 * p + i);
+                    if (k < kCicLength) {
+                        sum += (value & (0x80 >> i)) ? impulse[k] : -impulse[k];
+                    }
+                }
+                this->m_cicLut[p][value] = static_cast<int16_t>(sum);
+            }
+        }
+
+        /* Compensator [s, c, s] with c = 1 - 2s has unity DC gain and a response of
+         * 1 - 2s(1 - cos w). Pick s so it cancels the CIC droop at the reference. */
+        const float fRef  = kDroopReference * static_cast<float>(pcmRate);
+        const float x     = PI * fRef / static_cast<float>(this->m_pdmClock);
+        const float droop = std::pow(std::sin(ms_cicDecimation * x) /
+                                         (ms_cicDecimation * std::sin(x)),
+                                     static_cast<float>(ms_cicOrder));
+        const float w     = 2.f * PI * fRef / static_cast<float>(cicRate);
+        const float side  = -(1.f / droop - 1.f) / (2.f * (1.f - std::cos(w)));
+
+        this->m_compSide   = static_cast<int32_t>(std::round(side * 16384.f));
+        this->m_compCentre = 16384 - 2 * this->m_compSide;
+
+        this->Reset();
+
+        info("PDM decimator: %" PRIu32 " Hz clock -> CIC%" PRIu32 "/%" PRIu32 " -> %" PRIu32
+             " Hz (droop %.2f dB compensated)\n",
+             this->m_pdmClock,
+             ms_cicOrder,
+             ms_cicDecimation,
+             pcmRate,
+             -20.f * std::log10(droop));
+        return true;
+    }
+
+    void PdmDecimator::Reset()
+    {
+        /* 0x5555 is a 50% density pattern, i.e. silence. */
+        std::fill(std::begin(this->m_pdmWork), std::end(this->m_pdmWork), 0x5555);
+        std::fill(std::begin(this->m_compHistory), std::end(this->m_compHistory), 0);
+        this->m_lowPass.Reset();
+    }
+
+    uint32_t PdmDecimator::GetPdmClock() const
+    {
+        return this->m_pdmClock;
+    }
+
+    uint32_t
+    PdmDecimator::Process(const uint16_t* pdm, uint32_t nWords, int16_t* dst, uint32_t dstLen)
+    {
+        constexpr uint32_t historyLen = ms_cicWindowWords - 1;
+        uint32_t written = 0;
+
+        while (nWords) {
+            const uint32_t chunk = std::min(nWords, ms_chunkLen);
+            std::memcpy(this->m_pdmWork + historyLen, pdm, chunk * sizeof(uint16_t));
+
+            /* Stage 1: CIC. Output n covers words n..n+3 of the work buffer. Words
+             * are little-endian, so the earlier (high) byte of each word sits at
+             * the odd address: byte p of the window is at address 2n + (p ^ 1). */
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(this->m_pdmWork);
+            uint32_t n = 0;
+#if defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE)
+            const uint32x4_t lanes = vidupq_n_u32(0, 2);
+            for (; n + 4 <= chunk; n += 4) {
+                int32x4_t acc = vdupq_n_s32(0);
+                for (uint32_t p = 0; p < ms_cicLutCount; ++p) {
+                    const uint32x4_t value =
+                        vldrbq_gather_offset_u32(bytes + 2 * n, vaddq_n_u32(lanes, p ^ 1));
+                    acc = vaddq_s32(acc,
+                                    vldrhq_gather_shifted_offset_s32(this->m_cicLut[p], value));
+                }
+                acc = vshrq_n_s32(acc, 1);
+                acc = vmaxq_s32(vminq_s32(acc, vdupq_n_s32(INT16_MAX)), vdupq_n_s32(INT16_MIN));
+                vstrhq_s32(this->m_cicOut + n, acc);
+            }
+#endif /* defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE) */
+            for (; n < chunk; ++n) {
+                int32_t acc = 0;
+                for (uint32_t p = 0; p < ms_cicLutCount; ++p) {
+                    acc += this->m_cicLut[p][bytes[2 * n + (p ^ 1)]];
+                }
+                this->m_cicOut[n] = SaturateQ15(acc >> 1);
+            }
+
+            /* Stage 2: droop compensation, in place (one sample of delay). */
+            int16_t prev2 = this->m_compHistory[0];
+            int16_t prev1 = this->m_compHistory[1];
+            for (n = 0; n < chunk; ++n) {
+                const int16_t cur = this->m_cicOut[n];
+                const int32_t acc = this->m_compSide * (cur + prev2) + this->m_compCentre * prev1;
+                this->m_cicOut[n] = SaturateQ15((acc + (1 << 13)) >> 14);
+                prev2             = prev1;
+                prev1             = cur;
+            }
+            this->m_compHistory[0] = prev2;
+            this->m_compHistory[1] = prev1;
+
+            /* Stage 3: low-pass and decimate to the PCM rate. */
+            written += this->m_lowPass.Process(
+                this->m_cicOut, chunk, dst + written, dstLen - written);
+
+            std::memmove(this->m_pdmWork, this->m_pdmWork + chunk, historyLen * sizeof(uint16_t));
+            pdm += chunk;
+            nWords -= chunk;
+        }
+
+        return written;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StereoFrontEnd.hpp"
+
+#include "arm_math.h"   /* Pulls in arm_mve.h when Helium is available. */
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /* Speed of sound in air (m/s). */
+    static constexpr float kSpeedOfSound = 343.f;
+
+    /* Per-block growth of the noise floor estimate when the power is above it
+     * (minimum statistics); about 0.4 dB per block. */
+    static constexpr float kNoiseFloorRise = 1.1f;
+
+    /* SNR advantage the other channel needs before BestChannel switches to it. */
+    static constexpr float kSwitchHysteresisDb = 1.5f;
+
+    bool StereoFrontEnd::Init(Mode mode, int32_t delay)
+    {
+        if (delay > ms_maxDelay || delay < -ms_maxDelay) {
+            printf_err("Steering delay %" PRId32 " out of range (+/-%" PRId32 ")\n",
+                       delay,
+                       ms_maxDelay);
+            return false;
+        }
+
+        this->m_mode  = mode;
+        this->m_delay = (mode == Mode::DelayAndSum) ? delay : 0;
+        this->Reset();
+
+        info("Stereo front-end: %s (delay %" PRId32 " samples)\n",
+             (mode == Mode::DelayAndSum) ? "delay-and-sum" : "best channel",
+             this->m_delay);
+        return true;
+    }
+
+    void StereoFrontEnd::Reset()
+    {
+        std::memset(this->m_channel, 0, sizeof(this->m_channel));
+        std::fill(std::begin(this->m_noiseFloor), std::end(this->m_noiseFloor), 0.f);
+        std::fill(std::begin(this->m_snrDb), std::end(this->m_snrDb), 0.f);
+        this->m_selected = 0;
+    }
+
+    int32_t StereoFrontEnd::SteeringDelay(float micSpacing, float angle, uint32_t sampleRate)
+    {
+        /* A source towards the right reaches the right microphone first, so the
+         * right channel is the one delayed to line the two up. */
+        const float seconds = micSpacing * std::sin(angle * PI / 180.f) / kSpeedOfSound;
+        const int32_t delay =
+            static_cast<int32_t>(std::round(seconds * static_cast<float>(sampleRate)));
+        return std::min(std::max(delay, -ms_maxDelay), ms_maxDelay);
+    }
+
+    uint32_t StereoFrontEnd::GetSelectedChannel() const
+    {
+        return this->m_selected;
+    }
+
+    float StereoFrontEnd::GetChannelSnr(uint32_t channel) const
+    {
+        return this->m_snrDb[channel & 1];
+    }
+
+    void StereoFrontEnd::SelectChannel(const int16_t* stereo, uint32_t frames)
+    {
+        if (!frames) {
+            return;
+        }
+
+        int64_t energy[2] = {0, 0};
+        uint32_t i        = 0;
+#if defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE)
+        for (; i + 8 <= frames; i += 8) {
+            const int16x8x2_t v = vld2q_s16(stereo + 2 * i);
+            energy[0]           = vmlaldavaq_s16(energy[0], v.val[0], v.val[0]);
+            energy[1]           = vmlaldavaq_s16(energy[1], v.val[1], v.val[1]);
+        }
+#endif /* defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE) */
+        for (; i < frames; ++i) {
+            energy[0] += static_cast<int32_t>(stereo[2 * i]) * stereo[2 * i];
+            energy[1] += static_cast<int32_t>(stereo[2 * i + 1]) * stereo[2 * i + 1];
+        }
+
+        for (uint32_t c = 0; c < 2; ++c) {
+            const float power = std::max(static_cast<float>(energy[c]) / frames, 1.f);
+            float& floor      = this->m_noiseFloor[c];
+
+            floor = (floor <= 0.f || power < floor) ? power : floor * kNoiseFloorRise;
+            this->m_snrDb[c] = 10.f * std::log10(power / floor);
+        }
+
+        const uint32_t other = 1 - this->m_selected;
+        if (this->m_snrDb[other] > this->m_snrDb[this->m_selected] + kSwitchHysteresisDb) {
+            this->m_selected = other;
+        }
+
+        debug("SNR L: %.1f dB, R: %.1f dB; using %s\n",
+              this->m_snrDb[0],
+              this->m_snrDb[1],
+              this->m_selected ? "right" : "left");
+    }
+
+    void StereoFrontEnd::Process(const int16_t* stereo, uint32_t frames, int16_t* mono)
+    {
+        if (this->m_mode == Mode::BestChannel) {
+            this->SelectChannel(stereo, frames);
+        }
+
+        int16_t* const left  = this->m_channel[0] + ms_maxDelay;
+        int16_t* const right = this->m_channel[1] + ms_maxDelay;
+
+        /* The delayed channel is read from further back in its delay line. */
+        const int16_t* const a = left - std::max<int32_t>(0, -this->m_delay);
+        const int16_t* const b = right - std::max<int32_t>(0, this->m_delay);
+
+        /* Each chunk is fully de-interleaved before any output is written. Output
+         * sample n only overwrites input frames up to n / 2, all of which have
+         * been consumed by then, so in-place operation is safe. */
+        for (uint32_t done = 0; done < frames;) {
+            const uint32_t chunk = std::min(frames - done, ms_chunkLen);
+            const int16_t* in    = stereo + 2 * done;
+            int16_t* out         = mono + done;
+
+            uint32_t i = 0;
+#if defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE)
+            for (; i + 8 <= chunk; i += 8) {
+                const int16x8x2_t v = vld2q_s16(in + 2 * i);
+                vstrhq_s16(left + i, v.val[0]);
+                vstrhq_s16(right + i, v.val[1]);
+            }
+#endif /* defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE) */
+            for (; i < chunk; ++i) {
+                left[i]  = in[2 * i];
+                right[i] = in[2 * i + 1];
+            }
+
+            if (this->m_mode == Mode::BestChannel) {
+                std::memcpy(out, this->m_selected ? right : left, chunk * sizeof(int16_t));
+            } else {
+                /* Rounded mean: keeps the LSB that (L >> 1) + (R >> 1) drops. */
+                i = 0;
+#if defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE)
+                for (; i + 8 <= chunk; i += 8) {
+                    vstrhq_s16(out + i, vrhaddq_s16(vldrhq_s16(a + i), vldrhq_s16(b + i)));
+                }
+#endif /* defined(ARM_MATH_MVEI) && !defined(ARM_MATH_AUTOVECTORIZE) */
+                for (; i < chunk; ++i) {
+                    out[i] = static_cast<int16_t>((static_cast<int32_t>(a[i]) + b[i] + 1) >> 1);
+                }
+            }
+
+            /* Keep the newest ms_maxDelay samples of each channel as history. */
+            for (auto& channel : this->m_channel) {
+                std::memmove(channel, channel + chunk, ms_maxDelay * sizeof(int16_t));
+            }
+            done += chunk;
+        }
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,189 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ethosu_npu_pmu.h"
+
+#include "RTE_Components.h"         /* Tells whether the NPU driver is present */
+
+#if defined(RTE_ETHOS_U_CORE_DRIVER)
+
+#include "ethosu_driver.h"          /* Arm Ethos-U driver header */
+#include "pmu_ethosu.h"             /* Arm Ethos-U PMU access */
+#include "log_macros.h"             /* Logging macros */
+#include "time_base.h"              /* CPU time of the command streams */
+
+#include <inttypes.h>
+#include <string.h>
+
+/** Bytes per AXI data beat: the data bus is 64 bits wide on Ethos-U55 and
+ *  128 bits wide on Ethos-U65. */
+#if defined(ETHOSU65)
+#define ETHOSU_NPU_PMU_BEAT_BYTES   16
+#else
+#define ETHOSU_NPU_PMU_BEAT_BYTES   8
+#endif /* defined(ETHOSU65) */
+
+/** Event counters in use. */
+#define ETHOSU_NPU_PMU_COUNTERS_Msk \
+    (ETHOSU_PMU_CCNT_Msk | ETHOSU_PMU_CNT1_Msk | ETHOSU_PMU_CNT2_Msk | \
+     ETHOSU_PMU_CNT3_Msk | ETHOSU_PMU_CNT4_Msk)
+
+/** Read and write beat events of each AXI port. */
+static const enum ethosu_pmu_event_type s_axi_events[ETHOSU_NPU_PMU_AXI_PORTS][2] = {
+    {ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED, ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN},
+    {ETHOSU_PMU_AXI1_RD_DATA_BEAT_RECEIVED, ETHOSU_PMU_AXI1_WR_DATA_BEAT_WRITTEN},
+};
+
+static ethosu_npu_pmu_stats s_stats;
+
+/** AXI port counted on the command streams of the current inference. */
+static uint32_t s_axi_port;
+
+/** Inferences started since the last reset. */
+static uint32_t s_inferences;
+
+/** Time base at the start of the current command stream. */
+static uint32_t s_start_ticks;
+
+void ethosu_npu_pmu_begin(struct ethosu_driver* drv)
+{
+    /* Counters are reprogrammed for every command stream: the driver may
+     * reset or power down the NPU in between. */
+    ETHOSU_PMU_Enable(drv);
+    ETHOSU_PMU_Set_EVTYPER(drv, 0, ETHOSU_PMU_NPU_ACTIVE);
+    ETHOSU_PMU_Set_EVTYPER(drv, 1, ETHOSU_PMU_MAC_ACTIVE);
+    ETHOSU_PMU_Set_EVTYPER(drv, 2, s_axi_events[s_axi_port][0]);
+    ETHOSU_PMU_Set_EVTYPER(drv, 3, s_axi_events[s_axi_port][1]);
+    ETHOSU_PMU_EVCNTR_ALL_Reset(drv);
+    ETHOSU_PMU_CYCCNT_Reset(drv);
+    ETHOSU_PMU_CNTR_Enable(drv, ETHOSU_NPU_PMU_COUNTERS_Msk);
+
+    s_start_ticks = time_base_ticks();
+}
+
+void ethosu_npu_pmu_end(struct ethosu_driver* drv)
+{
+    const uint32_t end_ticks = time_base_ticks();
+    ETHOSU_PMU_CNTR_Disable(drv, ETHOSU_NPU_PMU_COUNTERS_Msk);
+
+    const uint64_t cycles = ETHOSU_PMU_Get_CCNTR(drv);
+    const uint32_t active = ETHOSU_PMU_Get_EVCNTR(drv, 0);
+
+    ++s_stats.command_streams;
+    s_stats.cycles += cycles;
+    s_stats.cpu_ticks += end_ticks - s_start_ticks;
+    s_stats.active_cycles += active;
+    s_stats.idle_cycles += cycles > active ? cycles - active : 0;
+    s_stats.mac_active_cycles += ETHOSU_PMU_Get_EVCNTR(drv, 1);
+    s_stats.axi_read_beats[s_axi_port] += ETHOSU_PMU_Get_EVCNTR(drv, 2);
+    s_stats.axi_write_beats[s_axi_port] += ETHOSU_PMU_Get_EVCNTR(drv, 3);
+    ++s_stats.axi_sampled[s_axi_port];
+
+    ETHOSU_PMU_Disable(drv);
+}
+
+void ethosu_npu_pmu_get_stats(ethosu_npu_pmu_stats* stats)
+{
+    *stats = s_stats;
+}
+
+void ethosu_npu_pmu_reset(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_inferences = 0;
+    s_axi_port   = 0;
+}
+
+void ethosu_npu_pmu_next_inference(void)
+{
+    /* The port rotates per inference rather than per command stream: with an
+     * even number of command streams per inference, the latter would count
+     * each command stream on the same port every time. */
+    s_axi_port = s_inferences++ % ETHOSU_NPU_PMU_AXI_PORTS;
+}
+
+/** Scales the counts of a port to all command streams, per inference. */
+static uint64_t ethosu_npu_pmu_scale(const ethosu_npu_pmu_stats* stats,
+                                     uint64_t count,
+                                     uint32_t port,
+                                     uint32_t inferences)
+{
+    if (!stats->axi_sampled[port]) {
+        return 0;
+    }
+    return count * stats->command_streams / stats->axi_sampled[port] / inferences;
+}
+
+void ethosu_npu_pmu_print(const ethosu_npu_pmu_stats* stats,
+                          uint32_t inferences,
+                          uint64_t cpu_cycles)
+{
+    if (!inferences || !stats->command_streams) {
+        info("NPU PMU: no command streams measured\n");
+        return;
+    }
+
+    const uint64_t cycles = stats->cycles / inferences;
+    info("NPU PMU (per inference, %" PRIu32 " inferences): CPU cycles %" PRIu64
+         ", NPU cycles %" PRIu64 " over %" PRIu32 " command streams\n",
+         inferences,
+         cpu_cycles / inferences,
+         cycles,
+         stats->command_streams / inferences);
+
+    /* The NPU may run at another clock than the CPU: the split is in CPU time. */
+    const uint64_t npu_ticks = stats->cpu_ticks / inferences;
+    const uint64_t cpu_ticks = cpu_cycles / inferences;
+    const uint64_t cpu_only  = cpu_ticks > npu_ticks ? cpu_ticks - npu_ticks : 0;
+    info("  Split: NPU command streams %" PRIu64 " us (%" PRIu64 "%%), CPU %" PRIu64
+         " us (%" PRIu64 "%%)\n",
+         time_base_ticks_to_us(npu_ticks),
+         cpu_ticks ? npu_ticks * 100 / cpu_ticks : 0,
+         time_base_ticks_to_us(cpu_only),
+         cpu_ticks ? cpu_only * 100 / cpu_ticks : 0);
+    info("  NPU active %" PRIu64 ", idle %" PRIu64 ", MAC active %" PRIu64
+         " (%" PRIu64 "%% of active)\n",
+         stats->active_cycles / inferences,
+         stats->idle_cycles / inferences,
+         stats->mac_active_cycles / inferences,
+         stats->active_cycles ? stats->mac_active_cycles * 100 / stats->active_cycles : 0);
+
+    for (uint32_t port = 0; port < ETHOSU_NPU_PMU_AXI_PORTS; ++port) {
+        if (!stats->axi_sampled[port]) {
+            info("  AXI%" PRIu32 ": not sampled\n", port);
+            continue;
+        }
+        const uint64_t rd = ethosu_npu_pmu_scale(stats, stats->axi_read_beats[port], port,
+                                                 inferences);
+        const uint64_t wr = ethosu_npu_pmu_scale(stats, stats->axi_write_beats[port], port,
+                                                 inferences);
+
+        /* Beats per 100 active cycles: how busy the port kept the NPU. */
+        info("  AXI%" PRIu32 ": read %" PRIu64 " beats (%" PRIu64 " bytes), write %" PRIu64
+             " beats (%" PRIu64 " bytes), %" PRIu64 " beats per 100 active cycles%s\n",
+             port,
+             rd,
+             rd * ETHOSU_NPU_PMU_BEAT_BYTES,
+             wr,
+             wr * ETHOSU_NPU_PMU_BEAT_BYTES,
+             stats->active_cycles ? (rd + wr) * 100 * inferences / stats->active_cycles : 0,
+             stats->axi_sampled[port] < stats->command_streams ? " (estimated)" : "");
+    }
+}
+
+#endif /* defined(RTE_ETHOS_U_CORE_DRIVER) */
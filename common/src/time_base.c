@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "time_base.h"
+
+#include "RTE_Components.h"         /* Provides definition for CMSIS_device_header */
+#include CMSIS_device_header
+
+#include <stdbool.h>
+
+#if defined(ARM_MODEL_USE_PMU_COUNTERS) && defined(__PMU_PRESENT) && (__PMU_PRESENT == 1U)
+#define TIME_BASE_USE_PMU
+#endif
+
+/** Software extension of the 32-bit counter. */
+typedef struct _time_base_state {
+    uint32_t last;      /* Counter value at the previous read. */
+    uint32_t wraps;     /* Upper 32 bits of the extended count. */
+    bool initialised;
+} time_base_state;
+
+static time_base_state s_time_base;
+
+static inline uint32_t time_base_read(void)
+{
+#if defined(TIME_BASE_USE_PMU)
+    return ARM_PMU_Get_CCNTR();
+#else
+    return DWT->CYCCNT;
+#endif /* defined(TIME_BASE_USE_PMU) */
+}
+
+void time_base_init(void)
+{
+    if (s_time_base.initialised) {
+        return;
+    }
+
+#if defined(DCB)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif /* defined(DCB) */
+
+#if defined(TIME_BASE_USE_PMU)
+    ARM_PMU_Enable();
+    ARM_PMU_CYCCNT_Reset();
+    ARM_PMU_CNTR_Enable(PMU_CNTENSET_CCNTR_ENABLE_Msk);
+#else
+#if defined(__CM7_REV)
+    /* Cortex-M7 locks the DWT registers against software writes. */
+    DWT->LAR = 0xC5ACCE55;
+#endif /* defined(__CM7_REV) */
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif /* defined(TIME_BASE_USE_PMU) */
+
+    s_time_base.last        = 0;
+    s_time_base.wraps       = 0;
+    s_time_base.initialised = true;
+}
+
+void time_base_start_systick(void)
+{
+    time_base_init();
+
+    /* Longest period SysTick allows: 2^24 cycles, far below the 2^32 cycles
+     * between counter wraps, at the lowest interrupt priority. */
+    SysTick_Config(SysTick_LOAD_RELOAD_Msk + 1);
+}
+
+uint32_t time_base_ticks_per_second(void)
+{
+    return SystemCoreClock;
+}
+
+uint32_t time_base_ticks(void)
+{
+    if (!s_time_base.initialised) {
+        time_base_init();
+    }
+    return time_base_read();
+}
+
+uint64_t time_base_ticks64(void)
+{
+    if (!s_time_base.initialised) {
+        time_base_init();
+    }
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    const uint32_t now = time_base_read();
+    if (now < s_time_base.last) {
+        ++s_time_base.wraps;
+    }
+    s_time_base.last    = now;
+    const uint64_t high = s_time_base.wraps;
+
+    __set_PRIMASK(primask);
+    return (high << 32) | now;
+}
+
+void time_base_update(void)
+{
+    (void)time_base_ticks64();
+}
+
+uint64_t time_base_ticks_to_us(uint64_t ticks)
+{
+    const uint32_t hz = time_base_ticks_per_second();
+    if (!hz) {
+        return 0;
+    }
+    /* Split to keep ticks * 10^6 from overflowing. */
+    return (ticks / hz) * 1000000 + (ticks % hz) * 1000000 / hz;
+}
+
+uint64_t time_base_us(void)
+{
+    return time_base_ticks_to_us(time_base_ticks64());
+}
@@ -22,6 +22,25 @@
 #include <string>
 #include <vector>
 
+#ifndef AUDIO_CAPTURE_SAMPLING_RATE
+/* Rate the I2S receiver is clocked at; set per project for codecs that
+ * cannot run at 16 kHz (e.g. 48000 or 44100). */
+#define AUDIO_CAPTURE_SAMPLING_RATE (16000U)
+#endif /* AUDIO_CAPTURE_SAMPLING_RATE */
+
+#if defined(AUDIO_CAPTURE_PDM_RAW)
+/* PDM microphone on the I2S data line, decimated in software to mono PCM. */
+#define AUDIO_CAPTURE_CHANNELS (1U)
+
+#ifndef AUDIO_PDM_OVERSAMPLING
+/* PDM clock / PCM rate; 64 gives a 1.024 MHz clock for 16 kHz output. */
+#define AUDIO_PDM_OVERSAMPLING (64U)
+#endif /* AUDIO_PDM_OVERSAMPLING */
+#else  /* defined(AUDIO_CAPTURE_PDM_RAW) */
+/* I2S codec, or with AUDIO_CAPTURE_PDM the on-board PDM microphone pair. */
+#define AUDIO_CAPTURE_CHANNELS (2U)
+#endif /* defined(AUDIO_CAPTURE_PDM_RAW) */
+
 /**
  * @brief   Audio buffer descriptor
  */
@@ -84,6 +103,18 @@ public:
      * @brief   Gets if the recorded audio is stereo
      */
     bool IsStereo() const;
+
+    /**
+     * @brief   Gets the sampling rate the audio interface is capturing at.
+     * @return  Sampling rate in Hz.
+     */
+    uint32_t GetSamplingRate() const;
+
+    /**
+     * @brief   Gets when the last sample of the most recent buffer was captured.
+     * @return  tflite::GetCurrentTimeTicks() value taken in the driver callback.
+     */
+    uint32_t GetCaptureTimestamp() const;
 };
 
 #endif /* BOARD_AUDIO_UTILS_HPP */
@@ -69,6 +69,13 @@ int CameraCaptureStart(uint8_t* raw_image);
  */
 void CameraCaptureWaitForFrame();
 
+/**
+ * @brief   Checks, without waiting, whether the capture started last has completed.
+ *
+ * @return bool: true once the frame is in the raw image buffer.
+ */
+bool CameraCaptureIsFrameReady();
+
 /**
  * @brief Get a cropped, colour corrected RGB frame from a RAW frame.
  *
@@ -94,6 +101,58 @@ bool CropAndDebayer(
     uint32_t rgbImgHeight,
     ColourFilter bayerFormat);
 
+/**
+ * @brief Get a cropped, colour corrected greyscale frame from a RAW frame, e.g.
+ *        straight into the input tensor of a greyscale model.
+ *
+ * @param[in] rawImgData        Pointer to the source (RAW) image.
+ * @param[in] rawImgWidth       Width of the source image.
+ * @param[in] rawImgHeight      Height of the source image.
+ * @param[in] rawImgCropOffsetX Offset for X-axis from the source image (crop starts here).
+ * @param[in] rawImgCropOffsetY Offset for Y-axis from the source image (crop starts here).
+ * @param[out] grayImgData      Pointer to the destination image (8 bit) buffer.
+ * @param[in] grayImgWidth      Width of destination image.
+ * @param[in] grayImgHeight     Height of destination image.
+ * @param[in] bayerFormat       Bayer format description code.
+ * @return bool                 True if successful, false otherwise.
+ */
+bool CropAndDebayerToGray(
+    const uint8_t* rawImgData,
+    uint32_t rawImgWidth,
+    uint32_t rawImgHeight,
+    uint32_t rawImgCropOffsetX,
+    uint32_t rawImgCropOffsetY,
+    uint8_t* grayImgData,
+    uint32_t grayImgWidth,
+    uint32_t grayImgHeight,
+    ColourFilter bayerFormat);
+
+/**
+ * @brief Get rows of a colour corrected RGB frame downscaled from a RAW frame,
+ *        one 2x2 tile of the source per pixel, e.g. for a preview of the whole
+ *        frame.
+ *
+ * @param[in] rawImgData        Pointer to the source (RAW) image.
+ * @param[in] rawImgWidth       Width of the source image.
+ * @param[in] rawImgHeight      Height of the source image.
+ * @param[in] scale             Downscaling factor; even.
+ * @param[out] rgbImgData       Pointer to the destination image (RGB) buffer, of
+ *                              rawImgWidth / scale by rawImgHeight / scale pixels.
+ * @param[in] rgbImgRowOffset   First destination row to populate.
+ * @param[in] rgbImgRows        Number of destination rows to populate.
+ * @param[in] bayerFormat       Bayer format description code.
+ * @return bool                 True if successful, false otherwise.
+ */
+bool DownscaleAndDebayer(
+    const uint8_t* rawImgData,
+    uint32_t rawImgWidth,
+    uint32_t rawImgHeight,
+    uint32_t scale,
+    uint8_t* rgbImgData,
+    uint32_t rgbImgRowOffset,
+    uint32_t rgbImgRows,
+    ColourFilter bayerFormat);
+
 } /* namespace app */
 } /* namespace arm */
 
@@ -45,6 +45,18 @@ enum class ColourFormat {
      */
 void RotateClockwise90(uint8_t* img, uint32_t width, uint32_t height);
 
+/**
+ * @brief Rotate an image 90 degrees clockwise into another buffer. The image
+ *        need not be square.
+ *
+ * @param[in] src           Pointer to the source image data.
+ * @param[out] dst          Pointer to the rotated image, height pixels wide and
+ *                          width pixels high. Must not overlap src.
+ * @param[in] width         Source width in pixels.
+ * @param[in] height        Source height in pixels.
+ */
+void RotateClockwise90(const uint8_t* src, uint8_t* dst, uint32_t width, uint32_t height);
+
 /**
  * @brief Initialises the LCD Display
  *
@@ -0,0 +1,152 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MODEL_UPDATE_HPP
+#define MODEL_UPDATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/* Two model slots in the OSPI flash, as offsets from its start. Keep them clear
+ * of the image linked into the flash (nn_model_ext_flash). */
+#if !defined(MODEL_SLOT_OFFSET)
+#define MODEL_SLOT_OFFSET   (0x01000000)
+#endif /* !defined(MODEL_SLOT_OFFSET) */
+#if !defined(MODEL_SLOT_SIZE)
+#define MODEL_SLOT_SIZE     (0x00800000)
+#endif /* !defined(MODEL_SLOT_SIZE) */
+
+/* Line rate during a transfer unless the sender asks for another; the console
+ * rate is restored afterwards. */
+#if !defined(MODEL_UPDATE_BAUDRATE)
+#define MODEL_UPDATE_BAUDRATE   (921600)
+#endif /* !defined(MODEL_UPDATE_BAUDRATE) */
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   A/B model slots in external flash.
+     *
+     *          Each slot starts with a header followed, at ms_dataOffset, by
+     *          the model. The header is written last, once the model is in
+     *          flash and checked: a slot without a valid header is ignored, so
+     *          an interrupted update leaves the previous model in use. The
+     *          valid slot with the highest sequence number is the active one,
+     *          the other one receives the next update.
+     */
+    class ModelSlots {
+    public:
+        static constexpr uint32_t ms_numSlots   = 2;
+        static constexpr uint32_t ms_magic      = 0x534C444D; /* "MDLS" */
+        static constexpr uint32_t ms_dataOffset = 256;        /* One flash page. */
+
+        struct Header {
+            uint32_t magic;
+            uint32_t length;    /* Model bytes. */
+            uint32_t crc32;     /* CRC-32 of the model. */
+            uint32_t sequence;  /* Higher is newer. */
+            uint32_t headerCrc; /* CRC-32 of the fields above. */
+        };
+
+        /**
+         * @brief       Chooses the model to run: the newest slot holding a
+         *              valid model, or the model linked into the image.
+         * @param[in]   fallback    Model linked into the image.
+         * @param[in]   fallbackLen Its size in bytes.
+         * @param[out]  modelLen    Size of the chosen model in bytes.
+         * @return      Chosen model, in the XIP window if it is in a slot.
+         */
+        static const uint8_t* Select(const uint8_t* fallback,
+                                     size_t fallbackLen,
+                                     size_t* modelLen);
+
+        /**
+         * @brief       Checks a slot, including the CRC of its model.
+         * @param[in]   slot    Slot index.
+         * @param[out]  header  Its header, if valid.
+         * @return      true if the slot holds a valid model.
+         */
+        static bool IsValid(uint32_t slot, Header* header);
+
+        /** @brief  Flash offset of a slot. */
+        static uint32_t Offset(uint32_t slot);
+
+        /** @brief  Address of a slot in the XIP window. */
+        static const uint8_t* Address(uint32_t slot);
+    };
+
+    /**
+     * @brief   Receives a model over the console UART into the inactive slot.
+     *
+     *          scripts/send_model_update.py is the sending side. Frames carry a
+     *          fixed-size chunk and a CRC-32; each is acknowledged (or a resend
+     *          from it requested) by sequence number. The transfer runs at
+     *          MODEL_UPDATE_BAUDRATE with ms_window frames in flight: one is
+     *          checked and programmed while the next arrives in the other
+     *          buffer, so the line does not idle waiting for acknowledgements.
+     *
+     *          Nothing may run from the OSPI flash during an update, including
+     *          the NPU: the flash leaves XIP mode while it is written.
+     */
+    class ModelUpdater {
+    public:
+        /* Model bytes per frame. */
+        static constexpr uint32_t ms_chunkSize = 4096;
+
+        /* Frames the sender may have unacknowledged, one per receive buffer. */
+        static constexpr uint32_t ms_window = 2;
+
+        enum class Result {
+            NoUpdate, /* No sender within the wait. */
+            Updated,  /* A new model is in the inactive slot; used after reset. */
+            Failed,   /* A transfer started but did not complete. */
+        };
+
+        /**
+         * @brief       Waits for a sender and receives a model if one comes.
+         * @param[in]   waitMs  How long to wait for the first frame.
+         * @return      Outcome.
+         */
+        Result Run(uint32_t waitMs);
+
+    private:
+        enum FrameType : uint8_t { Start = 1, Data = 2, End = 3 };
+
+        static constexpr uint32_t ms_headerSize = 8;
+        static constexpr uint32_t ms_frameSize  = ms_headerSize + ms_chunkSize + 4;
+
+        bool ReceiveFrame(uint8_t* frame, uint32_t timeoutUs);
+        bool PostReceive(uint8_t* frame);
+        bool WaitReceive(uint32_t timeoutUs);
+        bool CheckFrame(const uint8_t* frame) const;
+        void Respond(uint8_t code, uint16_t seq);
+        void Drain();
+        bool SetBaudrate(uint32_t baudrate);
+        bool Erase(uint32_t offset, uint32_t length);
+        bool Program(uint32_t offset, const uint8_t* data, uint32_t length);
+        bool Commit(uint32_t slot, const ModelSlots::Header& header);
+        Result Transfer(const uint8_t* start);
+
+        uint8_t m_frames[ms_window][ms_frameSize];
+        uint32_t m_pending = 0; /* Bytes of the receive in progress. */
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* MODEL_UPDATE_HPP */
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OVERLAPPED_INFERENCE_HPP
+#define OVERLAPPED_INFERENCE_HPP
+
+#include "Model.hpp"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Runs an inference synchronously, doing other work on the CPU
+     *          whenever it would otherwise wait for the NPU.
+     *
+     *          This is not an asynchronous API: Run() returns only once the
+     *          inference has finished. The TFLM interpreter is synchronous and
+     *          runs on the CPU, and there is no RTOS to run it from. CPU
+     *          operators execute in order, and each Ethos-U operator starts a
+     *          command stream and waits for the NPU interrupt
+     *          (ethosu_irq_handler, installed by NpuInit). That wait is where
+     *          the overlap work runs, cooperatively, one slice at a time, until
+     *          the NPU signals completion. Work left over when the interpreter
+     *          returns (e.g. all of it for a model without NPU operators) is
+     *          finished before Run() returns.
+     *
+     *          Typical use, preparing input N+1 while the NPU runs N:
+     *
+     *              inference.Overlap(PrepareNextSlice, &next);
+     *              inference.Run(model, OnDone, &ctx);
+     */
+    class OverlappedInference {
+    public:
+        /**
+         * @brief   Called when the interpreter returns, before left-over
+         *          overlap work runs.
+         * @param[in]   success     Whether the inference succeeded.
+         * @param[in]   arg         User argument given to Run().
+         */
+        using CompletionFn = void (*)(bool success, void* arg);
+
+        /**
+         * @brief   One slice of overlap work. The NPU completion is only
+         *          noticed between slices, so a slice delays the operators
+         *          after a command stream by up to its own length: keep slices
+         *          short where the work can be split.
+         * @param[in]   arg     User argument given to Overlap().
+         * @return      true while more work remains, false once done.
+         */
+        using WorkFn = bool (*)(void* arg);
+
+        OverlappedInference() = default;
+
+        /**
+         * @brief       Sets the work to run while the NPU is busy during the
+         *              next Run(). Replaces any unfinished work.
+         * @param[in]   work    Work function, nullptr for none.
+         * @param[in]   arg     Argument for the work function.
+         */
+        void Overlap(WorkFn work, void* arg);
+
+        /**
+         * @brief       Runs an inference and the overlap work to completion.
+         * @param[in]   model       Initialised model with its input populated.
+         * @param[in]   onComplete  Optional callback for the end of the inference.
+         * @param[in]   arg         Argument for the callback.
+         * @return      true if the inference succeeded.
+         */
+        bool Run(Model& model, CompletionFn onComplete = nullptr, void* arg = nullptr);
+
+        /** @brief  CPU cycles of overlap work done while the NPU was busy. */
+        uint32_t GetOverlappedCycles() const;
+
+        /** @brief  CPU cycles spent idle waiting for the NPU. */
+        uint32_t GetIdleCycles() const;
+
+        /**
+         * @brief   Runs one slice of the active overlap work, if any. Called by
+         *          the NPU driver's wait; not meant to be called directly.
+         * @return  false if there is no work left to do.
+         */
+        static bool RunWorkSlice();
+
+        /** @brief  Accounts cycles spent idle in the NPU driver's wait. */
+        static void AddIdleCycles(uint32_t cycles);
+
+    private:
+        WorkFn m_work{nullptr};
+        void* m_workArg{nullptr};
+        uint32_t m_overlappedCycles{0};
+        uint32_t m_idleCycles{0};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* OVERLAPPED_INFERENCE_HPP */
@@ -33,6 +33,23 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** Cache maintenance counters, accumulated over NPU invocations. */
+typedef struct _ethosu_cache_stats {
+    uint32_t invocations;        /* NPU command streams started. */
+    uint32_t requests;           /* Flush and invalidate calls from the driver. */
+    uint32_t skipped;            /* Requests for RO/uncached or already maintained memory. */
+    uint32_t by_addr_ops;        /* Requests maintained by address. */
+    uint32_t whole_cache_ops;    /* Requests that maintained the whole cache. */
+    uint64_t bytes_by_addr;      /* Bytes maintained by address. */
+    uint64_t cycles_spent;       /* CPU cycles spent maintaining the cache. */
+    uint64_t cycles_whole_cache; /* Estimated cycles had every invocation cleaned and
+                                  * invalidated the whole cache. */
+} ethosu_cache_stats;
+
 /**
  * @brief   Clears all the cache state members.
  */
@@ -40,8 +57,9 @@ void ethosu_clear_cache_states(void);
 
 /**
  * @brief   Precheck hook for ethosu_flush_dcache. Default weak implementation
- *          returns true if the data cache is enabled. Can be overridden to
- *          skip flush/clean for certain regions (eg TCM, or write-through cached areas).
+ *          returns true if the data cache is enabled and the memory policy
+ *          (ethosu_mem_policy.h) says the area may hold dirty lines; TCM,
+ *          write-through, read-only and NPU private areas are skipped.
  * @param[in]   p       Pointer to the start address.
  * @param[in]   bytes   Number of bytes to flush beginning at start address.
  * @return      true if a flush/clean is required
@@ -50,8 +68,9 @@ bool ethosu_area_needs_flush_dcache(const uint32_t *p, size_t bytes);
 
 /**
  * @brief   Precheck hook for ethosu_invalidate_dcache. Default weak implementation
- *          returns true if the data cache is enabled. Can be overridden to
- *          skip invalidates for certain regions (eg TCM).
+ *          returns true if the data cache is enabled and the memory policy
+ *          (ethosu_mem_policy.h) says the area may be cached; TCM, non-cacheable,
+ *          read-only and NPU private areas are skipped.
  * @param[in]   p       Pointer to the start address (or NULL).
  * @param[in]   bytes   Number of bytes to flush beginning at start address.
  * @return      true if an invalidate is required
@@ -60,7 +79,9 @@ bool ethosu_area_needs_invalidate_dcache(const uint32_t *p, size_t bytes);
 
 /**
  * @brief   Flush/clean the data cache by address and size. Passing NULL as p argument
- *          expects the whole cache to be flushed.
+ *          expects the whole cache to be flushed. Ranges already cleaned during the
+ *          current NPU invocation are skipped; the whole cache is cleaned instead once
+ *          the ranges add up to more than ETHOSU_CACHE_BY_ADDR_LIMIT bytes.
  * @param[in]   p       Pointer to the start address.
  * @param[in]   bytes   Number of bytes to flush beginning at start address.
  */
@@ -68,10 +89,27 @@ void ethosu_flush_dcache(uint32_t *p, size_t bytes);
 
 /**
  * @brief   Invalidate the data cache by address and size. Passing NULL as p argument
- *          expects the whole cache to be invalidated.
+ *          expects the whole cache to be invalidated. Lines are cleaned as well, and
+ *          ranges are coalesced as for ethosu_flush_dcache.
  * @param[in]   p       Pointer to the start address.
  * @param[in]   bytes   Number of bytes to flush beginning at start address.
  */
 void ethosu_invalidate_dcache(uint32_t *p, size_t bytes);
 
+/**
+ * @brief       Copies the cache maintenance counters. Cycles saved over
+ *              maintaining the whole cache are cycles_whole_cache - cycles_spent.
+ * @param[out]  stats   Destination.
+ */
+void ethosu_get_cache_stats(ethosu_cache_stats* stats);
+
+/**
+ * @brief   Resets the cache maintenance counters, e.g. between inferences.
+ */
+void ethosu_reset_cache_stats(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
 #endif /* ETHOSU_CPU_CACHE */
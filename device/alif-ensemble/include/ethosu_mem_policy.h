@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ETHOSU_MEM_POLICY_H
+#define ETHOSU_MEM_POLICY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Memory policy flags. Memory without any of them is neither cached nor
+ * shared with the NPU in a way that needs CPU cache maintenance. */
+#define ETHOSU_MEM_CACHEABLE    (1U << 0)   /* CPU accesses allocate in the data cache. */
+#define ETHOSU_MEM_WRITE_BACK   (1U << 1)   /* Cached lines may be dirty. */
+#define ETHOSU_MEM_READ_ONLY    (1U << 2)   /* Never written while running. */
+#define ETHOSU_MEM_NPU_PRIVATE  (1U << 3)   /* Only ever accessed by the NPU. */
+
+/* Flags taken from the memory underneath when adding a named region. */
+#define ETHOSU_MEM_INHERIT      (1U << 31)
+
+/**
+ * @brief   Builds the policy table. The memory map comes from the MPU regions
+ *          programmed by MPU_Load_Regions() (or the default memory map where
+ *          no region applies), refined with the TCM windows and the buffers
+ *          the linker script exports. Called on first lookup if not before.
+ */
+void ethosu_mem_policy_init(void);
+
+/**
+ * @brief       Adds or overrides a region, e.g. a buffer only the NPU uses.
+ * @param[in]   base    Start address.
+ * @param[in]   bytes   Size in bytes.
+ * @param[in]   flags   ETHOSU_MEM_* flags, or ETHOSU_MEM_INHERIT to only name it.
+ * @param[in]   name    Name printed by ethosu_mem_policy_print (static storage).
+ * @return      false if the table is full.
+ */
+bool ethosu_mem_policy_add(const void *base, size_t bytes, uint32_t flags, const char *name);
+
+/**
+ * @brief       Whether the CPU must clean the data cache for a buffer before
+ *              the NPU reads it: any part of it may hold dirty lines.
+ * @param[in]   p       Start address.
+ * @param[in]   bytes   Size in bytes.
+ * @return      true if a clean is required.
+ */
+bool ethosu_mem_needs_clean(const void *p, size_t bytes);
+
+/**
+ * @brief       Whether the CPU must invalidate the data cache for a buffer
+ *              after the NPU wrote it: any part of it may be cached.
+ * @param[in]   p       Start address.
+ * @param[in]   bytes   Size in bytes.
+ * @return      true if an invalidate is required.
+ */
+bool ethosu_mem_needs_invalidate(const void *p, size_t bytes);
+
+/**
+ * @brief   Prints the policy table.
+ */
+void ethosu_mem_policy_print(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ETHOSU_MEM_POLICY_H */
@@ -11,17 +11,47 @@
 #define OSPI_FLASH_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * @brief Initialize OSPI driver and flash chip. Enables XIP mode.
+ * @brief XIP read configuration of OSPI1.
+ */
+typedef struct _ospi_xip_profile {
+    const char *name;
+    bool prefetch;      /* Controller prefetches the data following each read */
+    bool continuous;    /* Chip select held between sequential bursts */
+    bool wrap;          /* Wrapping bursts use OSPI_XIP_WRAP_INST (if defined) */
+    bool cacheable;     /* XIP window write-through cacheable, not non-cacheable */
+} ospi_xip_profile;
+
+/* Profiles to choose from. The first one is the configuration of old: all off */
+extern const ospi_xip_profile ospi_xip_profiles[];
+extern const uint32_t ospi_xip_num_profiles;
+
+/**
+ * @brief Initialize OSPI driver and flash chip. Enables XIP mode with profile
+ *        OSPI_XIP_PROFILE (index in ospi_xip_profiles, default 0).
  *
  */
 int32_t ospi_flash_init(void);
 
+/**
+ * @brief Reconfigure XIP. Nothing may read the XIP window meanwhile, including
+ *        the NPU.
+ *
+ */
+void ospi_flash_set_xip_profile(const ospi_xip_profile *profile);
+
+/**
+ * @brief XIP profile in use.
+ *
+ */
+const ospi_xip_profile *ospi_flash_get_xip_profile(void);
+
 #ifdef __cplusplus
 }
 #endif
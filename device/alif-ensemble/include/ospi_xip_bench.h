@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OSPI_XIP_BENCH_H_
+#define OSPI_XIP_BENCH_H_
+
+#include <stdint.h>
+
+#include "ospi_flash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Strides of the strided read test, in bytes */
+#define OSPI_XIP_BENCH_STRIDES  3
+extern const uint32_t ospi_xip_bench_strides[OSPI_XIP_BENCH_STRIDES];
+
+/**
+ * @brief Read timings of an XIP range under one profile.
+ */
+typedef struct _ospi_xip_read_stats {
+    uint32_t bytes;                                 /* Bytes read sequentially */
+    uint32_t seq_cycles;                            /* Cycles of the sequential read */
+    uint32_t stride_reads[OSPI_XIP_BENCH_STRIDES];  /* Words read at each stride */
+    uint32_t stride_cycles[OSPI_XIP_BENCH_STRIDES]; /* Cycles of those reads */
+    uint32_t checksum;                              /* Of the data read sequentially */
+} ospi_xip_read_stats;
+
+/**
+ * @brief Reads a range of the XIP window sequentially, then one word every
+ *        stride, each from a cold data cache. Two profiles return the same
+ *        data if their checksums match.
+ *
+ */
+void ospi_xip_bench_reads(const void *base, uint32_t bytes, ospi_xip_read_stats *stats);
+
+/**
+ * @brief Print the read timings of a profile.
+ *
+ */
+void ospi_xip_bench_print(const ospi_xip_profile *profile, const ospi_xip_read_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -17,9 +17,14 @@
  */
 
 #include "BoardAudioUtils.hpp"
+
+#if !defined(AUDIO_CAPTURE_PDM) && !defined(AUDIO_CAPTURE_PDM_RAW)
+
 #include <assert.h>
 #include <cstring>
 
+#include "tensorflow/lite/micro/micro_time.h"
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* C */
@@ -45,6 +50,7 @@ typedef struct _audio_capture_state {
 } audio_capture_state;
 
 static volatile audio_capture_state s_cap_state;
+static volatile uint32_t s_captureTick = 0;
 
 static void set_capture_completed(bool val)
 {
@@ -66,6 +72,7 @@ static void set_capture_started(bool val)
 static void I2SCallback(uint32_t event)
 {
     if (event & ARM_SAI_EVENT_RECEIVE_COMPLETE) {
+        s_captureTick            = tflite::GetCurrentTimeTicks();
         s_cap_state.capCompleted = true;
     }
 }
@@ -79,7 +86,7 @@ static audio_buf* s_stereoBufferDMA     = NULL;
 static bool InitializeI2SDriver(void)
 {
     int32_t status = 0;
-    constexpr uint32_t audioSamplingRate = 16000;
+    constexpr uint32_t audioSamplingRate = AUDIO_CAPTURE_SAMPLING_RATE;
     constexpr uint32_t wlen = 16;
 
     set_capture_completed(false);
@@ -211,6 +218,16 @@ bool AudioUtils::IsStereo() const
     return true;
 }
 
+uint32_t AudioUtils::GetSamplingRate() const
+{
+    return AUDIO_CAPTURE_SAMPLING_RATE;
+}
+
+uint32_t AudioUtils::GetCaptureTimestamp() const
+{
+    return s_captureTick;
+}
+
 void AudioUtils::SetVolumeIn(uint8_t vol)
 {}
 
@@ -232,3 +249,5 @@ void AudioUtils::SetAudioEmpty()
     set_capture_completed(false);
     set_capture_started(false);
 }
+
+#endif /* !defined(AUDIO_CAPTURE_PDM) && !defined(AUDIO_CAPTURE_PDM_RAW) */
@@ -0,0 +1,297 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * AudioUtils backend for the on-board PDM microphones, read through the
+ * Ensemble PDM peripheral.
+ *
+ * The two microphones share data line BOARD_PDM_INSTANCE, one on each clock
+ * edge, which the peripheral presents as channels 2n and 2n + 1. It runs the
+ * CIC and FIR decimation in hardware and writes the two channels interleaved as
+ * 16-bit PCM, the same stereo layout the I2S backend delivers, straight into
+ * the buffer passed to AudioInit(). The CPU only sees one interrupt per capture.
+ */
+
+#include "BoardAudioUtils.hpp"
+
+#if defined(AUDIO_CAPTURE_PDM)
+
+#include "tensorflow/lite/micro/micro_time.h"
+
+#include <cstring>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* C */
+
+#include "RTE_Components.h"
+#include "RTE_Device.h"
+#include <Driver_PDM.h>
+#include CMSIS_device_header
+#include "board.h"
+#include <stdio.h>
+
+#ifndef AUDIO_PDM_CHANNEL
+/* First channel of the microphone pair: both edges of data line BOARD_PDM_INSTANCE. */
+#define AUDIO_PDM_CHANNEL (BOARD_PDM_INSTANCE * 2U)
+#endif /* AUDIO_PDM_CHANNEL */
+
+#ifndef AUDIO_PDM_MODE
+/* 1.024 MHz PDM clock, decimated 64x to 16 kHz. */
+#define AUDIO_PDM_MODE ARM_PDM_MODE_HIGH_QUALITY_1024_CLK_FRQ
+#if AUDIO_CAPTURE_SAMPLING_RATE != 16000
+#error "Set AUDIO_PDM_MODE to the PDM mode producing AUDIO_CAPTURE_SAMPLING_RATE"
+#endif /* AUDIO_CAPTURE_SAMPLING_RATE != 16000 */
+#endif /* AUDIO_PDM_MODE */
+
+extern ARM_DRIVER_PDM Driver_PDM;
+ARM_DRIVER_PDM*       s_pdm_drv;
+
+typedef struct _audio_capture_state {
+    volatile bool capStarted;
+    volatile bool capCompleted;
+    volatile bool capError;
+} audio_capture_state;
+
+/**
+ * @brief   Per-channel filter settings: the FIR decimation coefficients, DC
+ *          blocking IIR coefficient, clock-edge sampling phase and gain. Values
+ *          from Alif's PDM example for the microphone pair of one data line.
+ */
+typedef struct _pdm_channel_settings {
+    uint32_t fir[18];
+    uint32_t iir;
+    uint32_t phase;
+    uint32_t gain;
+} pdm_channel_settings;
+
+static const pdm_channel_settings s_channelSettings[AUDIO_CAPTURE_CHANNELS] = {
+    {{0x00000001, 0x00000003, 0x00000003, 0x000007F4, 0x00000004, 0x000007ED,
+      0x000007F5, 0x000007F4, 0x000007D3, 0x000007FE, 0x000007BC, 0x000007E5,
+      0x000007D9, 0x00000793, 0x00000029, 0x0000072C, 0x00000072, 0x000002FD},
+     0x00000004, 0x0000001F, 0x0000000D},
+    {{0x00000000, 0x000007FF, 0x00000000, 0x00000004, 0x00000004, 0x000007FC,
+      0x00000000, 0x000007FB, 0x000007E4, 0x00000000, 0x0000002B, 0x00000009,
+      0x00000016, 0x00000049, 0x00000793, 0x000006F8, 0x00000045, 0x00000178},
+     0x00000004, 0x00000003, 0x00000013},
+};
+
+static volatile audio_capture_state s_cap_state;
+static volatile uint32_t s_captureTick = 0;
+
+static void set_capture_state(bool started, bool completed)
+{
+    NVIC_DisableIRQ(PDM_IRQn);
+    s_cap_state.capStarted   = started;
+    s_cap_state.capCompleted = completed;
+    s_cap_state.capError     = false;
+    NVIC_EnableIRQ(PDM_IRQn);
+}
+
+/**
+ * @brief Callback routine from the PDM driver.
+ *
+ * @param[in]  event  Event for which the callback has been called.
+ */
+static void PDMCallback(uint32_t event)
+{
+    if (event & ARM_PDM_EVENT_CAPTURE_COMPLETE) {
+        s_captureTick            = tflite::GetCurrentTimeTicks();
+        s_cap_state.capCompleted = true;
+    }
+    if (event & ARM_PDM_EVENT_ERROR) {
+        s_cap_state.capError = true;
+    }
+}
+
+static audio_buf* s_stereoBuffer = NULL;
+
+#if defined(__cplusplus)
+}
+#endif /* C */
+
+static bool ConfigurePDMChannel(uint32_t channel, const pdm_channel_settings& settings)
+{
+    PDM_CH_CONFIG config;
+    config.ch_num = channel;
+    std::memcpy(config.ch_fir_coef, settings.fir, sizeof(config.ch_fir_coef));
+    config.ch_iir_coef = settings.iir;
+
+    int32_t status = s_pdm_drv->Config(&config);
+    if (!status) {
+        status = s_pdm_drv->Control(ARM_PDM_CHANNEL_PHASE, channel, settings.phase);
+    }
+    if (!status) {
+        status = s_pdm_drv->Control(ARM_PDM_CHANNEL_GAIN, channel, settings.gain);
+    }
+    if (status) {
+        printf("PDM channel %u config status = %d\n", static_cast<unsigned>(channel), status);
+        return false;
+    }
+    return true;
+}
+
+static bool InitializePDMDriver(void)
+{
+    int32_t status = 0;
+
+    set_capture_state(false, false);
+
+    s_pdm_drv = &Driver_PDM;
+
+    /* Verify the PDM API version for compatibility */
+    ARM_DRIVER_VERSION version = s_pdm_drv->GetVersion();
+    printf("PDM API version = %d\n", version.api);
+
+    /* Initializes PDM interface */
+    status = s_pdm_drv->Initialize(PDMCallback);
+    if (status) {
+        printf("PDM Initialize failed status = %d\n", status);
+        goto pdmInitializeError;
+    }
+
+    /* Enable the power for PDM */
+    status = s_pdm_drv->PowerControl(ARM_POWER_FULL);
+    if (status) {
+        printf("PDM Power failed status = %d\n", status);
+        goto pdmPowerError;
+    }
+
+    /* Both microphones of the pair; samples arrive interleaved, lower channel first. */
+    status = s_pdm_drv->Control(ARM_PDM_SELECT_CHANNEL, 3U << AUDIO_PDM_CHANNEL, 0);
+    if (!status) {
+        status = s_pdm_drv->Control(ARM_PDM_MODE, AUDIO_PDM_MODE, 0);
+    }
+    if (status) {
+        printf("PDM Control status = %d\n", status);
+        goto pdmControlError;
+    }
+
+    for (uint32_t i = 0; i < AUDIO_CAPTURE_CHANNELS; ++i) {
+        if (!ConfigurePDMChannel(AUDIO_PDM_CHANNEL + i, s_channelSettings[i])) {
+            goto pdmControlError;
+        }
+    }
+    return true;
+
+pdmControlError:
+    s_pdm_drv->PowerControl(ARM_POWER_OFF);
+pdmPowerError:
+    s_pdm_drv->Uninitialize();
+pdmInitializeError:
+    return false;
+}
+
+static void UninitializePDMDriver(void)
+{
+    /* Uninitialize turns the power off beforehand */
+    s_pdm_drv->Uninitialize();
+}
+
+void AudioUtils::StartAudioRecording()
+{
+    if (!s_stereoBuffer) {
+        return;
+    }
+
+    set_capture_state(true, false);
+
+    /* Receive data; the count is of 16-bit samples across both channels. */
+    int32_t status = s_pdm_drv->Receive(s_stereoBuffer->data, s_stereoBuffer->n_elements);
+    if (status) {
+        printf("PDM Receive status = %d\n", status);
+        return;
+    }
+}
+
+void AudioUtils::StopAudioRecording()
+{
+    this->SetAudioEmpty();
+}
+
+AudioUtils::AudioUtils()
+{}
+
+AudioUtils::~AudioUtils()
+{
+    UninitializePDMDriver();
+}
+
+bool AudioUtils::AudioInit(audio_buf* audioBufferInStereo)
+{
+    if (!InitializePDMDriver()) {
+        printf("Failed to initialise audio\n");
+        return false;
+    }
+
+    s_stereoBuffer = audioBufferInStereo;
+
+    /* Start and stop recording as a test */
+    this->StartAudioRecording();
+    this->StopAudioRecording();
+
+    printf("PDM audio recording configured (channels %u and %u).\n",
+           static_cast<unsigned>(AUDIO_PDM_CHANNEL),
+           static_cast<unsigned>(AUDIO_PDM_CHANNEL + 1));
+    return true;
+}
+
+bool AudioUtils::IsStereo() const
+{
+    return true;
+}
+
+uint32_t AudioUtils::GetSamplingRate() const
+{
+    return AUDIO_CAPTURE_SAMPLING_RATE;
+}
+
+uint32_t AudioUtils::GetCaptureTimestamp() const
+{
+    return s_captureTick;
+}
+
+void AudioUtils::SetVolumeIn(uint8_t vol)
+{}
+
+void AudioUtils::SetVolumeOut(uint8_t vol)
+{}
+
+bool AudioUtils::IsAudioAvailable()
+{
+    if (s_cap_state.capError) {
+        /* The FIFO overflowed: the samples no longer follow on from each other. */
+        printf("PDM capture error: capture restarted\n");
+        this->StartAudioRecording();
+        return false;
+    }
+
+    if (s_cap_state.capStarted) {
+        return s_cap_state.capCompleted;
+    }
+
+    printf("No audio available\n");
+    return false;
+}
+
+void AudioUtils::SetAudioEmpty()
+{
+    set_capture_state(false, false);
+}
+
+#endif /* defined(AUDIO_CAPTURE_PDM) */
@@ -0,0 +1,372 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * AudioUtils backend for a raw PDM bitstream read through the I2S receiver,
+ * for sources the PDM peripheral cannot take (see BoardAudioUtilsPdm.cpp for
+ * the on-board microphones).
+ *
+ * Wiring: this path needs an external PDM microphone with its clock input on
+ * the I2S serial clock (SCLK) of BOARD_I2S_INSTANCE and its data output on the
+ * I2S data input (SDI).
+ *
+ * With 16-bit slots the receiver shifts the bitstream in continuously, so each
+ * received word holds 16 consecutive PDM bits, earliest bit first. The driver
+ * callback only queues the received block in a ring and re-arms the receiver.
+ * The blocks are decimated to mono PCM at AUDIO_CAPTURE_SAMPLING_RATE in thread
+ * context, when the application polls IsAudioAvailable(), straight into the
+ * buffer passed to AudioInit(). The ring holds a whole capture, so the
+ * application may run inference for as long as a capture lasts in between.
+ */
+
+#include "BoardAudioUtils.hpp"
+
+#if defined(AUDIO_CAPTURE_PDM_RAW)
+
+#include "PdmDecimator.hpp"
+#include "tensorflow/lite/micro/micro_time.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* C */
+
+#include "RTE_Components.h"
+#include "RTE_Device.h"
+#include <Driver_SAI.h>
+#include CMSIS_device_header
+#include "board.h"
+#include <stdio.h>
+
+#define I2S_ADC       BOARD_I2S_INSTANCE
+
+#define _I2S_IRQ(n)      I2S##n##_IRQ_IRQn
+#define  I2S_IRQ(n)     _I2S_IRQ(n)
+
+/* PDM words per block: 16 ms at 16 kHz with 64x oversampling. */
+#define PDM_BLOCK_WORDS (1024U)
+
+/* PDM words in the half second the application's buffer holds. */
+#define PDM_CAPTURE_WORDS \
+    (AUDIO_CAPTURE_SAMPLING_RATE * AUDIO_PDM_OVERSAMPLING / 16U / 2U)
+
+#ifndef AUDIO_PDM_RING_BLOCKS
+/* Blocks queued for decimation: one capture, plus the block being received and
+ * one of slack. */
+#define AUDIO_PDM_RING_BLOCKS \
+    ((PDM_CAPTURE_WORDS + PDM_BLOCK_WORDS - 1U) / PDM_BLOCK_WORDS + 2U)
+#endif /* AUDIO_PDM_RING_BLOCKS */
+
+/* PCM samples produced per block (plus one for the resampler phase). */
+#define PDM_BLOCK_PCM_LEN \
+    (PDM_BLOCK_WORDS * arm::app::audio::PdmDecimator::ms_cicDecimation / AUDIO_PDM_OVERSAMPLING + 1)
+
+extern ARM_DRIVER_SAI ARM_Driver_SAI_(I2S_ADC);
+ARM_DRIVER_SAI*       s_i2s_drv;
+
+typedef struct _audio_capture_state {
+    volatile bool capStarted;
+    volatile bool capCompleted;
+} audio_capture_state;
+
+static volatile audio_capture_state s_cap_state;
+static volatile bool s_streaming  = false;
+static uint32_t s_filled = 0;
+static uint32_t s_captureTick = 0;
+
+/* Ring of received blocks. The callback owns s_ringHead, thread context
+ * s_ringTail; both only ever increase. */
+static uint16_t s_pdmBlocks[AUDIO_PDM_RING_BLOCKS][PDM_BLOCK_WORDS];
+static uint32_t s_blockTicks[AUDIO_PDM_RING_BLOCKS];
+static volatile uint32_t s_ringHead = 0;  /* Blocks received. */
+static volatile uint32_t s_ringTail = 0;  /* Blocks decimated or dropped. */
+static volatile bool s_overrun = false;   /* A block was lost to a full ring. */
+static bool s_warmUp = true;              /* Next block only settles the filters. */
+
+static int16_t s_pcmBlock[PDM_BLOCK_PCM_LEN];
+
+static arm::app::audio::PdmDecimator s_decimator;
+static audio_buf* s_monoBuffer = NULL;
+
+static void set_capture_state(bool started, bool completed)
+{
+    NVIC_DisableIRQ((IRQn_Type)I2S_IRQ(I2S_ADC));
+    s_filled                 = 0;
+    s_cap_state.capStarted   = started;
+    s_cap_state.capCompleted = completed;
+    NVIC_EnableIRQ((IRQn_Type)I2S_IRQ(I2S_ADC));
+}
+
+/**
+ * @brief   Decimates a block and appends it to the user buffer. The stream is
+ *          decimated even when no capture is pending so the filter state
+ *          always follows the microphone.
+ *
+ * @param[in]  block      Block of PDM words.
+ * @param[in]  blockTick  Tick count when the block was received.
+ */
+static void DecimateBlock(const uint16_t* block, uint32_t blockTick)
+{
+    const uint32_t produced =
+        s_decimator.Process(block, PDM_BLOCK_WORDS, s_pcmBlock, PDM_BLOCK_PCM_LEN);
+
+    if (s_warmUp) {
+        s_warmUp = false;
+        return;
+    }
+    if (!s_cap_state.capStarted || s_cap_state.capCompleted) {
+        return;
+    }
+
+    const uint32_t n = std::min(produced, s_monoBuffer->n_elements - s_filled);
+    std::memcpy(static_cast<int16_t*>(s_monoBuffer->data) + s_filled,
+                s_pcmBlock,
+                n * sizeof(int16_t));
+    s_filled += n;
+
+    if (s_filled == s_monoBuffer->n_elements) {
+        s_captureTick            = blockTick;
+        s_cap_state.capCompleted = true;
+    }
+}
+
+/**
+ * @brief   Decimates the blocks received since the last call, in thread
+ *          context. After an overrun the queued blocks no longer follow on from
+ *          each other: they are dropped, the filters restart and a pending
+ *          capture starts over.
+ */
+static void DrainBlocks(void)
+{
+    if (s_overrun) {
+        NVIC_DisableIRQ((IRQn_Type)I2S_IRQ(I2S_ADC));
+        s_ringTail = s_ringHead;
+        s_overrun  = false;
+        NVIC_EnableIRQ((IRQn_Type)I2S_IRQ(I2S_ADC));
+
+        printf("PDM blocks lost: capture restarted\n");
+        s_decimator.Reset();
+        s_warmUp = true;
+        if (!s_cap_state.capCompleted) {
+            s_filled = 0;
+        }
+    }
+
+    while (s_ringTail != s_ringHead) {
+        const uint32_t slot = s_ringTail % AUDIO_PDM_RING_BLOCKS;
+        DecimateBlock(s_pdmBlocks[slot], s_blockTicks[slot]);
+        s_ringTail = s_ringTail + 1;
+    }
+}
+
+/**
+ * @brief Callback routine from the i2s driver.
+ *
+ * @param[in]  event  Event for which the callback has been called.
+ */
+static void I2SCallback(uint32_t event)
+{
+    if (event & ARM_SAI_EVENT_RECEIVE_COMPLETE) {
+        const uint32_t tick = tflite::GetCurrentTimeTicks();
+
+        /* Queue the block unless that would hand out one not yet decimated:
+         * then the block just received is overwritten. */
+        if (s_ringHead + 1 - s_ringTail < AUDIO_PDM_RING_BLOCKS) {
+            s_blockTicks[s_ringHead % AUDIO_PDM_RING_BLOCKS] = tick;
+            s_ringHead = s_ringHead + 1;
+        } else {
+            s_overrun = true;
+        }
+        s_i2s_drv->Receive(s_pdmBlocks[s_ringHead % AUDIO_PDM_RING_BLOCKS], PDM_BLOCK_WORDS);
+    }
+}
+
+#if defined(__cplusplus)
+}
+#endif /* C */
+
+static bool InitializeI2SDriver(void)
+{
+    int32_t status = 0;
+    constexpr uint32_t wlen = 16;
+
+    /* Two 16-bit slots per frame carry 32 PDM bits. */
+    constexpr uint32_t frameRate =
+        AUDIO_CAPTURE_SAMPLING_RATE * AUDIO_PDM_OVERSAMPLING / (wlen * 2);
+
+    set_capture_state(false, false);
+
+    /* Use the I2S as Receiver */
+    s_i2s_drv = &ARM_Driver_SAI_(I2S_ADC);
+
+    /* Verify the I2S API version for compatibility */
+    ARM_DRIVER_VERSION version = s_i2s_drv->GetVersion();
+    printf("I2S API version = %d\n", version.api);
+
+    /* Verify if I2S protocol is supported */
+    ARM_SAI_CAPABILITIES cap = s_i2s_drv->GetCapabilities();
+    if (!cap.protocol_i2s) {
+        printf("I2S is not supported\n");
+        return false;
+    }
+
+    /* Initializes I2S interface */
+    status = s_i2s_drv->Initialize(I2SCallback);
+    if (status) {
+        printf("I2S Initialize failed status = %d\n", status);
+        goto i2sInitializeError;
+    }
+
+    /* Enable the power for I2S */
+    status = s_i2s_drv->PowerControl(ARM_POWER_FULL);
+    if (status) {
+        printf("I2S Power failed status = %d\n", status);
+        goto i2sPowerError;
+    }
+
+    /* Configure I2S Receiver to Asynchronous Master; SCLK is the PDM clock. */
+    status = s_i2s_drv->Control(ARM_SAI_CONFIGURE_RX | ARM_SAI_MODE_MASTER | ARM_SAI_ASYNCHRONOUS |
+                                ARM_SAI_PROTOCOL_I2S | ARM_SAI_DATA_SIZE(wlen),
+                                wlen * 2,
+                                frameRate);
+
+    if (status) {
+        printf("I2S Control status = %d\n", status);
+        goto i2sControlError;
+    }
+    status = s_i2s_drv->Control(ARM_SAI_CONTROL_RX, 1, 0);
+    return true;
+
+i2sControlError:
+    s_i2s_drv->PowerControl(ARM_POWER_OFF);
+i2sPowerError:
+    s_i2s_drv->Uninitialize();
+i2sInitializeError:
+    return false;
+}
+
+static void UninitializeI2SDriver(void)
+{
+    /* Uninitialize turns the power off beforehand */
+    s_i2s_drv->Uninitialize();
+}
+
+void AudioUtils::StartAudioRecording()
+{
+    if (!s_monoBuffer) {
+        return;
+    }
+
+    /* Blocks received before this start belong to no capture. */
+    DrainBlocks();
+    set_capture_state(true, false);
+
+    if (s_streaming) {
+        return;
+    }
+
+    /* The bitstream runs continuously from the first start onwards. */
+    s_decimator.Reset();
+    s_warmUp       = true;
+    s_ringHead     = 0;
+    s_ringTail     = 0;
+    int32_t status = s_i2s_drv->Receive(s_pdmBlocks[0], PDM_BLOCK_WORDS);
+    if (status) {
+        printf("I2S Receive status = %d\n", status);
+        return;
+    }
+    s_streaming = true;
+}
+
+void AudioUtils::StopAudioRecording()
+{
+    this->SetAudioEmpty();
+}
+
+AudioUtils::AudioUtils()
+{}
+
+AudioUtils::~AudioUtils()
+{
+    UninitializeI2SDriver();
+}
+
+bool AudioUtils::AudioInit(audio_buf* audioBufferInMono)
+{
+    if (!s_decimator.Init(AUDIO_CAPTURE_SAMPLING_RATE, AUDIO_PDM_OVERSAMPLING)) {
+        printf("Failed to initialise PDM decimator\n");
+        return false;
+    }
+
+    if (!InitializeI2SDriver()) {
+        printf("Failed to initialise audio\n");
+        return false;
+    }
+
+    s_monoBuffer = audioBufferInMono;
+
+    /* Start and stop recording as a test */
+    this->StartAudioRecording();
+    this->StopAudioRecording();
+
+    printf("PDM audio recording configured (%u Hz clock).\n",
+           static_cast<unsigned>(s_decimator.GetPdmClock()));
+    return true;
+}
+
+bool AudioUtils::IsStereo() const
+{
+    return false;
+}
+
+uint32_t AudioUtils::GetSamplingRate() const
+{
+    return AUDIO_CAPTURE_SAMPLING_RATE;
+}
+
+uint32_t AudioUtils::GetCaptureTimestamp() const
+{
+    return s_captureTick;
+}
+
+void AudioUtils::SetVolumeIn(uint8_t vol)
+{}
+
+void AudioUtils::SetVolumeOut(uint8_t vol)
+{}
+
+bool AudioUtils::IsAudioAvailable()
+{
+    DrainBlocks();
+
+    if (s_cap_state.capStarted) {
+        return s_cap_state.capCompleted;
+    }
+
+    printf("No audio available\n");
+    return false;
+}
+
+void AudioUtils::SetAudioEmpty()
+{
+    set_capture_state(false, false);
+}
+
+#endif /* defined(AUDIO_CAPTURE_PDM_RAW) */
@@ -31,14 +31,24 @@ extern "C" {
 #include "board.h"
 #include "power.h"
 #include "ospi_flash.h"
+#include "time_base.h"
 #include <stdio.h>
 
 static struct ethosu_driver npuDriver;
+
+/** MACs per cycle of the NPU, 0 until NpuInit succeeds. */
+static uint32_t npuMacsPerCc;
 static void npu_irq_handler(void)
 {
     ethosu_irq_handler(&npuDriver);
 }
 
+/** @brief  SysTick ISR: keeps the 64-bit time base current. */
+void SysTick_Handler(void)
+{
+    time_base_update();
+}
+
 #if defined(__cplusplus)
 }
 #endif // defined(__cplusplus)
@@ -62,6 +72,22 @@ bool NpuInit()
     NVIC_SetVector(LOCAL_NPU_IRQ_IRQn, (uint32_t) &npu_irq_handler);
     NVIC_EnableIRQ(LOCAL_NPU_IRQ_IRQn);
 
+    /* Vela compiles a model for one MAC configuration: keep it to pick the model. */
+    struct ethosu_hw_info hwInfo;
+    ethosu_get_hw_info(&npuDriver, &hwInfo);
+    npuMacsPerCc = 1U << hwInfo.cfg.macs_per_cc;
+
+    return true;
+}
+
+bool BoardGetNpuInfo(uint32_t* arch, uint32_t* macsPerCc)
+{
+    if (!npuMacsPerCc) {
+        return false;
+    }
+    /* Ensemble devices have Ethos-U55 NPUs only. */
+    *arch      = 55;
+    *macsPerCc = npuMacsPerCc;
     return true;
 }
 
@@ -100,6 +126,7 @@ void BoardInit(void)
 #ifdef COPY_VECTORS
     copy_vtor_table_to_ram();
 #endif
+    time_base_start_systick();
     BOARD_Pinmux_Init();
 
     /* Enable peripheral clocks */
@@ -116,14 +143,13 @@ void BoardInit(void)
     UartStdOutInit();
 #endif /* defined(SEMIHOSTING) */
 
-#if defined(MODEL_IN_EXT_FLASH)
+#if defined(MODEL_IN_EXT_FLASH) || defined(AUDIO_CORPUS_ADDRESS)
     ospi_flash_init();
 #endif
 
 #if defined(ETHOSU_ARCH) && (ETHOSU_ARCH==u55)
-    if (!NpuInit()) {
-        return;
-    }
+    /* Without the NPU, carry on: a CPU model can still run. */
+    NpuInit();
 #endif
 
     /* Enable the CPU Cache */
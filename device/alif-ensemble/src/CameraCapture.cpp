@@ -137,7 +137,7 @@ int arm::app::CameraCaptureStart(uint8_t* rawImage)
 
 void arm::app::CameraCaptureWaitForFrame()
 {
-    while (camera_status.frame_complete != true) {
+    while (!CameraCaptureIsFrameReady()) {
         __WFI();
     }
 
@@ -146,6 +146,11 @@ void arm::app::CameraCaptureWaitForFrame()
     }
 }
 
+bool arm::app::CameraCaptureIsFrameReady()
+{
+    return camera_status.frame_complete;
+}
+
 /**
  * @brief   Populates the destination RGB pixel values from source expecting
  *          a BGGR tile pattern.
@@ -415,3 +420,98 @@ bool arm::app::CropAndDebayer(
 
     return true;
 }
+
+bool arm::app::CropAndDebayerToGray(
+    const uint8_t* rawImgData,
+    uint32_t rawImgWidth,
+    uint32_t rawImgHeight,
+    uint32_t rawImgCropOffsetX,
+    uint32_t rawImgCropOffsetY,
+    uint8_t* grayImgData,
+    uint32_t grayImgWidth,
+    uint32_t grayImgHeight,
+    ColourFilter bayerFormat)
+{
+    const uint32_t rawImgStep = rawImgWidth;
+
+    /* Debayering reads one pixel right of and below each source pixel. */
+    if (rawImgCropOffsetX + grayImgWidth >= rawImgWidth ||
+        rawImgCropOffsetY + grayImgHeight >= rawImgHeight) {
+        printf_err("Crop outside of the raw image\n");
+        return false;
+    }
+
+    arm::app::ColourFilter startingPattern =
+        GetStartingTilePattern(bayerFormat,
+                               rawImgCropOffsetX,
+                               rawImgCropOffsetY);
+
+    std::array<DebayerRowPopulateFunction, 4> functionArray;
+    if (!GetDebayeringFunctionOrder(startingPattern, functionArray)) {
+        printf_err("Failed to get debayering function sequence\n");
+        return false;
+    }
+
+    /* Same colour correction as CropAndDebayer, then ITU-R BT.601 luma in
+     * 8-bit fixed point. */
+    uint8_t rgb[3];
+    for (uint32_t j = 0; j < grayImgHeight; ++j) {
+
+        const uint8_t* pSrc = rawImgData + rawImgCropOffsetX +
+                              (rawImgStep * (rawImgCropOffsetY + j));
+        uint8_t* pDst = grayImgData + (grayImgWidth * j);
+        const auto& populateEven = functionArray[(j & 1) << 1];
+        const auto& populateOdd  = functionArray[((j & 1) << 1) + 1];
+
+        for (uint32_t i = 0; i < grayImgWidth; ++i) {
+            (i & 1 ? populateOdd : populateEven)(pSrc++, rgb, rawImgStep);
+            *pDst++ = static_cast<uint8_t>((77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) >> 8);
+        }
+    }
+
+    return true;
+}
+
+bool arm::app::DownscaleAndDebayer(
+    const uint8_t* rawImgData,
+    uint32_t rawImgWidth,
+    uint32_t rawImgHeight,
+    uint32_t scale,
+    uint8_t* rgbImgData,
+    uint32_t rgbImgRowOffset,
+    uint32_t rgbImgRows,
+    ColourFilter bayerFormat)
+{
+    if (!scale || (scale & 1)) {
+        printf_err("Downscaling factor must be even\n");
+        return false;
+    }
+
+    const uint32_t rawImgStep  = rawImgWidth;
+    const uint32_t rgbImgWidth = rawImgWidth / scale;
+    if ((rgbImgRowOffset + rgbImgRows) * scale > rawImgHeight) {
+        printf_err("Rows outside of the raw image\n");
+        return false;
+    }
+
+    /* Every sampled tile starts on even offsets: one pattern for all. */
+    std::array<DebayerRowPopulateFunction, 4> functionArray;
+    if (!GetDebayeringFunctionOrder(bayerFormat, functionArray)) {
+        printf_err("Failed to get debayering function sequence\n");
+        return false;
+    }
+
+    for (uint32_t j = rgbImgRowOffset; j < rgbImgRowOffset + rgbImgRows; ++j) {
+
+        const uint8_t* pSrc = rawImgData + (rawImgStep * j * scale);
+        uint8_t* pDst = rgbImgData + (rgbImgWidth * 3 * j);
+
+        for (uint32_t i = 0; i < rgbImgWidth; ++i) {
+            functionArray[0](pSrc, pDst, rawImgStep);
+            pSrc += scale;
+            pDst += 3;
+        }
+    }
+
+    return true;
+}
@@ -120,6 +120,29 @@ namespace app {
         }
     }
 
+    /**
+     * @brief Rotate an image 90 degrees clockwise into another buffer. Unlike the
+     *        in-place version, the image need not be square.
+     *
+     * @param[in] src           Pointer to the source image data.
+     * @param[out] dst          Pointer to the rotated image, height pixels wide and
+     *                          width pixels high. Must not overlap src.
+     * @param[in] width         Source width in pixels.
+     * @param[in] height        Source height in pixels.
+     */
+    void RotateClockwise90(const uint8_t* src, uint8_t* dst, uint32_t width, uint32_t height)
+    {
+        for (uint32_t j = 0; j < width; ++j) {
+            /* Row j of the rotated image is column j of the source, read bottom-up. */
+            const uint8_t* in = AtIndex(src, width, height, (height - 1), j);
+            for (uint32_t i = 0; i < height; ++i) {
+                memcpy(dst, in, 3);
+                dst += 3;
+                in -= width * 3;
+            }
+        }
+    }
+
     /* Function to test the rotation function */
     void RotationTest()
     {
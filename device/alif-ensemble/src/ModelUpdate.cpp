@@ -0,0 +1,453 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ModelUpdate.hpp"
+
+#include "ModelStaging.hpp" /* Crc32 */
+#include "log_macros.h"
+#include "time_base.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* C */
+
+#include "RTE_Components.h"
+#include CMSIS_device_header
+#include "Driver_Flash.h"
+#include "Driver_USART.h"
+#include "global_map.h"
+#include "ospi_flash.h"
+
+#if defined(__cplusplus)
+}
+#endif /* C */
+
+#include <cinttypes>
+#include <cstring>
+
+#if !defined(USART_DRV_NUM)
+#define USART_DRV_NUM           2
+#endif /* USART_DRV_NUM */
+
+/* Rate of the console (uart_stdout.c), restored after a transfer. */
+#if !defined(MODEL_UPDATE_CONSOLE_BAUDRATE)
+#define MODEL_UPDATE_CONSOLE_BAUDRATE   (115200)
+#endif /* !defined(MODEL_UPDATE_CONSOLE_BAUDRATE) */
+
+#define _USART_Driver_(n)  Driver_USART##n
+#define  USART_Driver_(n) _USART_Driver_(n)
+
+extern ARM_DRIVER_USART USART_Driver_(USART_DRV_NUM);
+static ARM_DRIVER_USART* const s_usart = &USART_Driver_(USART_DRV_NUM);
+
+extern ARM_DRIVER_FLASH ARM_Driver_Flash_(1);
+static ARM_DRIVER_FLASH* const s_flash = &ARM_Driver_Flash_(1);
+
+namespace arm {
+namespace app {
+
+    /* Frame: sync (2), type (1), reserved (1), sequence (2), payload length
+     * (2), payload (ms_chunkSize, padded), CRC-32 of all but the sync (4). */
+    static constexpr uint8_t kSync0 = 0xA5;
+    static constexpr uint8_t kSync1 = 0x5A;
+
+    /* Responses: code (1), sequence (2). */
+    static constexpr uint8_t kAck   = 0x06; /* Frames up to the sequence taken. */
+    static constexpr uint8_t kNak   = 0x15; /* Resend from the given sequence. */
+    static constexpr uint8_t kAbort = 0x18; /* Transfer abandoned. */
+
+    /* Time a sender gets for a frame beyond its time on the line. */
+    static constexpr uint32_t kFrameSlackUs = 500000;
+
+    /* Silence that ends a drain. */
+    static constexpr uint32_t kDrainIdleUs = 20000;
+
+    static uint8_t s_response[3];
+    static uint32_t s_baudrate = MODEL_UPDATE_CONSOLE_BAUDRATE;
+
+    static uint16_t ReadU16(const uint8_t* p)
+    {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    static uint32_t ReadU32(const uint8_t* p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    /** Time a frame takes on the line, plus slack. */
+    static uint32_t FrameTimeoutUs(uint32_t frameSize)
+    {
+        /* 10 bits per byte with start and stop bits. */
+        return static_cast<uint32_t>(10ull * frameSize * 1000000 / s_baudrate) + kFrameSlackUs;
+    }
+
+    /** Writing the flash takes it out of XIP mode: put it back. */
+    static void RestoreXip()
+    {
+        const ospi_xip_profile* profile = ospi_flash_get_xip_profile();
+        if (profile) {
+            ospi_flash_set_xip_profile(profile);
+        }
+    }
+
+    static bool WaitFlashReady()
+    {
+        while (s_flash->GetStatus().busy) {
+        }
+        return !s_flash->GetStatus().error;
+    }
+
+    uint32_t ModelSlots::Offset(uint32_t slot)
+    {
+        return MODEL_SLOT_OFFSET + slot * MODEL_SLOT_SIZE;
+    }
+
+    const uint8_t* ModelSlots::Address(uint32_t slot)
+    {
+        return reinterpret_cast<const uint8_t*>(OSPI1_XIP_BASE) + Offset(slot);
+    }
+
+    bool ModelSlots::IsValid(uint32_t slot, Header* header)
+    {
+        Header h;
+        std::memcpy(&h, Address(slot), sizeof(h));
+
+        if (h.magic != ms_magic ||
+            h.headerCrc != Crc32(reinterpret_cast<const uint8_t*>(&h), offsetof(Header, headerCrc)) ||
+            !h.length || h.length > MODEL_SLOT_SIZE - ms_dataOffset) {
+            return false;
+        }
+        if (Crc32(Address(slot) + ms_dataOffset, h.length) != h.crc32) {
+            printf_err("Model slot %" PRIu32 " is corrupted\n", slot);
+            return false;
+        }
+        *header = h;
+        return true;
+    }
+
+    const uint8_t* ModelSlots::Select(const uint8_t* fallback,
+                                      size_t fallbackLen,
+                                      size_t* modelLen)
+    {
+        int32_t chosen = -1;
+        Header best{};
+        for (uint32_t slot = 0; slot < ms_numSlots; ++slot) {
+            Header h;
+            if (IsValid(slot, &h) && (chosen < 0 || h.sequence > best.sequence)) {
+                chosen = static_cast<int32_t>(slot);
+                best   = h;
+            }
+        }
+
+        if (chosen < 0) {
+            info("Model slots empty, using the model linked into the image\n");
+            *modelLen = fallbackLen;
+            return fallback;
+        }
+
+        info("Model from slot %" PRId32 ": %" PRIu32 " bytes, sequence %" PRIu32
+             ", CRC-32 0x%08" PRIx32 "\n",
+             chosen,
+             best.length,
+             best.sequence,
+             best.crc32);
+        *modelLen = best.length;
+        return Address(static_cast<uint32_t>(chosen)) + ms_dataOffset;
+    }
+
+    ModelUpdater::Result ModelUpdater::Run(uint32_t waitMs)
+    {
+        uint8_t* frame = this->m_frames[0];
+        const uint64_t deadline = time_base_us() + waitMs * 1000ull;
+
+        /* The sender sends its start frame once, when it sees the window open.
+         * Anything else on the line, or a damaged start frame, is dropped and
+         * the hunt goes on until the window closes. */
+        for (uint64_t now = time_base_us(); now < deadline; now = time_base_us()) {
+            if (!this->ReceiveFrame(frame, static_cast<uint32_t>(deadline - now))) {
+                break;
+            }
+            if (this->CheckFrame(frame) && frame[2] == Start && ReadU16(frame + 4) == 0) {
+                return this->Transfer(frame);
+            }
+            this->Drain();
+        }
+        return Result::NoUpdate;
+    }
+
+    ModelUpdater::Result ModelUpdater::Transfer(const uint8_t* start)
+    {
+        const uint8_t* payload   = start + ms_headerSize;
+        const uint32_t modelLen  = ReadU32(payload);
+        const uint32_t modelCrc  = ReadU32(payload + 4);
+        const uint32_t baudrate  = ReadU32(payload + 8);
+
+        if (!modelLen || modelLen > MODEL_SLOT_SIZE - ModelSlots::ms_dataOffset) {
+            this->Respond(kAbort, 0);
+            return Result::Failed;
+        }
+
+        /* The slot not in use, with the next sequence number. */
+        ModelSlots::Header active{};
+        uint32_t slot = 0;
+        for (uint32_t s = 0; s < ModelSlots::ms_numSlots; ++s) {
+            ModelSlots::Header h;
+            if (ModelSlots::IsValid(s, &h) && h.sequence >= active.sequence) {
+                active = h;
+                slot   = (s + 1) % ModelSlots::ms_numSlots;
+            }
+        }
+
+        /* Erasing takes a while: the sender waits for the acknowledgement. */
+        const uint32_t base = ModelSlots::Offset(slot);
+        if (!this->Erase(base, ModelSlots::ms_dataOffset + modelLen)) {
+            RestoreXip();
+            this->Respond(kAbort, 0);
+            return Result::Failed;
+        }
+
+        this->Respond(kAck, 0);
+        if (!this->SetBaudrate(baudrate ? baudrate : MODEL_UPDATE_BAUDRATE)) {
+            RestoreXip();
+            return Result::Failed;
+        }
+
+        Result result    = Result::Failed;
+        uint32_t written = 0;
+        uint16_t seq     = 1;
+        uint32_t cur     = 0;
+        this->PostReceive(this->m_frames[cur]);
+
+        for (;;) {
+            if (!this->WaitReceive(FrameTimeoutUs(ms_frameSize))) {
+                s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+                break;
+            }
+
+            /* The sender keeps ms_window frames in flight: take the next one
+             * in before this one is checked, so the line never waits on us. */
+            const uint8_t* frame = this->m_frames[cur];
+            const uint32_t next  = (cur + 1) % ms_window;
+            this->PostReceive(this->m_frames[next]);
+
+            if (!this->CheckFrame(frame) || ReadU16(frame + 4) != seq) {
+                /* Go back: drop what follows and have it resent from seq. */
+                this->Drain();
+                this->PostReceive(this->m_frames[cur]);
+                this->Respond(kNak, seq);
+                continue;
+            }
+
+            if (frame[2] == End) {
+                s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+                if (written != modelLen) {
+                    this->Respond(kAbort, seq);
+                    break;
+                }
+
+                /* Read back through XIP, then make the slot valid. */
+                RestoreXip();
+                const uint8_t* data = ModelSlots::Address(slot) + ModelSlots::ms_dataOffset;
+                const ModelSlots::Header header{
+                    ModelSlots::ms_magic, modelLen, modelCrc, active.sequence + 1, 0};
+                if (Crc32(data, modelLen) != modelCrc || !this->Commit(slot, header)) {
+                    this->Respond(kAbort, seq);
+                    break;
+                }
+                this->Respond(kAck, seq);
+                result = Result::Updated;
+                break;
+            }
+
+            const uint32_t len = ReadU16(frame + 6);
+            if (frame[2] != Data || len > ms_chunkSize || written + len > modelLen) {
+                s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+                this->Respond(kAbort, seq);
+                break;
+            }
+
+            /* Acknowledged before programming: the frame after the one in
+             * flight is on its way while the flash is written. */
+            this->Respond(kAck, seq);
+
+            if (!this->Program(base + ModelSlots::ms_dataOffset + written,
+                               frame + ms_headerSize,
+                               len)) {
+                s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+                this->Respond(kAbort, seq);
+                break;
+            }
+            written += len;
+            ++seq;
+            cur = next;
+        }
+
+        RestoreXip();
+        this->SetBaudrate(MODEL_UPDATE_CONSOLE_BAUDRATE);
+
+        if (result == Result::Updated) {
+            info("Model update: %" PRIu32 " bytes written to slot %" PRIu32
+                 ", used from the next boot\n",
+                 modelLen,
+                 slot);
+        } else {
+            printf_err("Model update failed after %" PRIu32 " of %" PRIu32 " bytes\n",
+                       written,
+                       modelLen);
+        }
+        return result;
+    }
+
+    bool ModelUpdater::ReceiveFrame(uint8_t* frame, uint32_t timeoutUs)
+    {
+        const uint64_t deadline = time_base_us() + timeoutUs;
+        uint8_t last = 0;
+
+        /* Hunt for the sync bytes one at a time, then take the rest. */
+        while (time_base_us() < deadline) {
+            uint8_t byte;
+            if (s_usart->Receive(&byte, 1) != ARM_DRIVER_OK) {
+                return false;
+            }
+            while (s_usart->GetRxCount() != 1) {
+                if (time_base_us() >= deadline) {
+                    s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+                    return false;
+                }
+            }
+            if (last == kSync0 && byte == kSync1) {
+                frame[0] = kSync0;
+                frame[1] = kSync1;
+                if (s_usart->Receive(frame + 2, ms_frameSize - 2) != ARM_DRIVER_OK) {
+                    return false;
+                }
+                this->m_pending = ms_frameSize - 2;
+                return this->WaitReceive(FrameTimeoutUs(ms_frameSize));
+            }
+            last = byte;
+        }
+        return false;
+    }
+
+    bool ModelUpdater::PostReceive(uint8_t* frame)
+    {
+        this->m_pending = ms_frameSize;
+        return s_usart->Receive(frame, ms_frameSize) == ARM_DRIVER_OK;
+    }
+
+    bool ModelUpdater::WaitReceive(uint32_t timeoutUs)
+    {
+        const uint64_t deadline = time_base_us() + timeoutUs;
+        while (s_usart->GetRxCount() < this->m_pending) {
+            if (time_base_us() >= deadline) {
+                s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ModelUpdater::CheckFrame(const uint8_t* frame) const
+    {
+        return frame[0] == kSync0 && frame[1] == kSync1 &&
+               Crc32(frame + 2, ms_frameSize - 6) == ReadU32(frame + ms_frameSize - 4);
+    }
+
+    void ModelUpdater::Respond(uint8_t code, uint16_t seq)
+    {
+        s_response[0] = code;
+        s_response[1] = static_cast<uint8_t>(seq);
+        s_response[2] = static_cast<uint8_t>(seq >> 8);
+        if (s_usart->Send(s_response, sizeof(s_response)) == ARM_DRIVER_OK) {
+            while (s_usart->GetTxCount() != sizeof(s_response)) {
+            }
+        }
+    }
+
+    void ModelUpdater::Drain()
+    {
+        /* Discard the rest of a broken frame and the one after it: the sender
+         * stops at ms_window unacknowledged frames, so the line soon goes
+         * quiet. */
+        s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+
+        uint8_t byte;
+        uint64_t idleSince = time_base_us();
+        s_usart->Receive(&byte, 1);
+        while (time_base_us() - idleSince < kDrainIdleUs) {
+            if (s_usart->GetRxCount() == 1) {
+                s_usart->Receive(&byte, 1);
+                idleSince = time_base_us();
+            }
+        }
+        s_usart->Control(ARM_USART_ABORT_RECEIVE, 0);
+    }
+
+    bool ModelUpdater::SetBaudrate(uint32_t baudrate)
+    {
+        while (s_usart->GetStatus().tx_busy) {
+        }
+        if (s_usart->Control(ARM_USART_MODE_ASYNCHRONOUS | ARM_USART_DATA_BITS_8 |
+                                 ARM_USART_PARITY_NONE | ARM_USART_STOP_BITS_1 |
+                                 ARM_USART_FLOW_CONTROL_NONE,
+                             baudrate) != ARM_DRIVER_OK) {
+            return false;
+        }
+        s_baudrate = baudrate;
+        return true;
+    }
+
+    bool ModelUpdater::Erase(uint32_t offset, uint32_t length)
+    {
+        const uint32_t sector = s_flash->GetInfo()->sector_size;
+        for (uint32_t addr = offset - offset % sector; addr < offset + length; addr += sector) {
+            if (s_flash->EraseSector(addr) != ARM_DRIVER_OK || !WaitFlashReady()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ModelUpdater::Program(uint32_t offset, const uint8_t* data, uint32_t length)
+    {
+        /* Lengths are rounded up to whole program units: frames are padded. */
+        const uint32_t unit  = 1U << s_flash->GetCapabilities().data_width;
+        const uint32_t count = (length + unit - 1) / unit;
+        return s_flash->ProgramData(offset, data, count) == static_cast<int32_t>(count) &&
+               WaitFlashReady();
+    }
+
+    bool ModelUpdater::Commit(uint32_t slot, const ModelSlots::Header& header)
+    {
+        uint8_t buf[32];
+        std::memset(buf, 0xFF, sizeof(buf));
+
+        ModelSlots::Header h = header;
+        h.headerCrc = Crc32(reinterpret_cast<const uint8_t*>(&h),
+                            offsetof(ModelSlots::Header, headerCrc));
+        std::memcpy(buf, &h, sizeof(h));
+
+        const bool ok = this->Program(ModelSlots::Offset(slot), buf, sizeof(buf));
+        RestoreXip();
+
+        ModelSlots::Header check;
+        return ok && ModelSlots::IsValid(slot, &check);
+    }
+
+} /* namespace app */
+} /* namespace arm */
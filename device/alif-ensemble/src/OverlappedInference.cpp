@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "OverlappedInference.hpp"
+
+#include "log_macros.h"
+#include "tensorflow/lite/micro/micro_time.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* C */
+
+#include "RTE_Components.h"
+#include CMSIS_device_header
+#include "ethosu_driver.h"
+
+#if defined(__cplusplus)
+}
+#endif /* C */
+
+/* Semaphores the driver creates: one per driver instance plus the driver pool. */
+#define NPU_MAX_SEMAPHORES  (4)
+
+namespace arm {
+namespace app {
+
+    /* Inference being run, if any. */
+    static OverlappedInference* s_active = nullptr;
+
+    /* Whether the interpreter of the active inference is still running. */
+    static bool s_inInference = false;
+
+    void OverlappedInference::Overlap(WorkFn work, void* arg)
+    {
+        this->m_work    = work;
+        this->m_workArg = arg;
+    }
+
+    bool OverlappedInference::Run(Model& model, CompletionFn onComplete, void* arg)
+    {
+        if (s_active) {
+            printf_err("Inference already running\n");
+            return false;
+        }
+
+        this->m_overlappedCycles = 0;
+        this->m_idleCycles       = 0;
+        s_active                 = this;
+
+        s_inInference      = true;
+        const bool success = model.RunInference();
+        s_inInference      = false;
+
+        if (onComplete) {
+            onComplete(success, arg);
+        }
+
+        /* Whatever the NPU did not leave time for runs now, e.g. all of it
+         * for a model that fell back to the CPU entirely. */
+        while (RunWorkSlice()) {
+        }
+        s_active = nullptr;
+
+        return success;
+    }
+
+    uint32_t OverlappedInference::GetOverlappedCycles() const
+    {
+        return this->m_overlappedCycles;
+    }
+
+    uint32_t OverlappedInference::GetIdleCycles() const
+    {
+        return this->m_idleCycles;
+    }
+
+    bool OverlappedInference::RunWorkSlice()
+    {
+        OverlappedInference* const active = s_active;
+        if (!active || !active->m_work) {
+            return false;
+        }
+
+        const uint32_t start = tflite::GetCurrentTimeTicks();
+        if (!active->m_work(active->m_workArg)) {
+            active->m_work = nullptr;
+        }
+        if (s_inInference) {
+            active->m_overlappedCycles += tflite::GetCurrentTimeTicks() - start;
+        }
+        return true;
+    }
+
+    void OverlappedInference::AddIdleCycles(uint32_t cycles)
+    {
+        if (s_active) {
+            s_active->m_idleCycles += cycles;
+        }
+    }
+
+} /* namespace app */
+} /* namespace arm */
+
+/*
+ * Overrides of the Ethos-U driver's weak semaphore hooks. The driver takes
+ * the semaphore to wait for the NPU and ethosu_irq_handler gives it; instead
+ * of sleeping straight away the wait runs overlap work.
+ */
+extern "C" {
+
+struct npu_semaphore {
+    volatile uint32_t count;
+};
+
+static npu_semaphore s_semaphores[NPU_MAX_SEMAPHORES];
+static uint32_t s_numSemaphores = 0;
+
+void* ethosu_semaphore_create(void)
+{
+    if (s_numSemaphores == NPU_MAX_SEMAPHORES) {
+        printf_err("Out of NPU semaphores\n");
+        return nullptr;
+    }
+    npu_semaphore* sem = &s_semaphores[s_numSemaphores++];
+    sem->count         = 0;
+    return sem;
+}
+
+void ethosu_semaphore_destroy(void* sem)
+{
+    /* Statically allocated; drivers live as long as the application. */
+    (void)sem;
+}
+
+int ethosu_semaphore_take(void* sem)
+{
+    npu_semaphore* const s = static_cast<npu_semaphore*>(sem);
+
+    while (true) {
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        if (s->count) {
+            --s->count;
+            __set_PRIMASK(primask);
+            return 0;
+        }
+        __set_PRIMASK(primask);
+
+        if (!arm::app::OverlappedInference::RunWorkSlice()) {
+            /* An interrupt between the check and here sets the event
+             * register, so this cannot miss the NPU completing. */
+            const uint32_t start = tflite::GetCurrentTimeTicks();
+            __WFE();
+            arm::app::OverlappedInference::AddIdleCycles(tflite::GetCurrentTimeTicks() - start);
+        }
+    }
+}
+
+int ethosu_semaphore_give(void* sem)
+{
+    npu_semaphore* const s = static_cast<npu_semaphore*>(sem);
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ++s->count;
+    __set_PRIMASK(primask);
+    __SEV();
+    return 0;
+}
+
+} /* extern "C" */
@@ -28,21 +28,66 @@
  */
 
 #include "ethosu_cpu_cache.h"
+#include "ethosu_mem_policy.h"      /* Memory region policy */
+#include "ethosu_npu_pmu.h"         /* NPU performance counters */
 
 #include "RTE_Components.h"         /* For CPU related defintiions */
 #include CMSIS_device_header
 #include "ethosu_driver.h"          /* Arm Ethos-U driver header */
 #include "log_macros.h"             /* Logging macros */
 
+#include <inttypes.h>
+#include <string.h>
+
+#if !defined(__SCB_DCACHE_LINE_SIZE)
+#define __SCB_DCACHE_LINE_SIZE  32U
+#endif /* !defined(__SCB_DCACHE_LINE_SIZE) */
+
+/** Number of distinct ranges remembered per operation and NPU invocation.
+ *  Once exhausted, the whole cache is maintained instead. */
+#if !defined(ETHOSU_CACHE_MAX_RANGES)
+#define ETHOSU_CACHE_MAX_RANGES     16
+#endif /* !defined(ETHOSU_CACHE_MAX_RANGES) */
+
+/** Bytes above which maintaining by address is assumed to cost more than
+ *  maintaining the whole cache. 0 selects the size of the data cache: both
+ *  loops issue one maintenance operation per line, by address for the range
+ *  and by set/way for the whole cache. */
+#if !defined(ETHOSU_CACHE_BY_ADDR_LIMIT)
+#define ETHOSU_CACHE_BY_ADDR_LIMIT  0
+#endif /* !defined(ETHOSU_CACHE_BY_ADDR_LIMIT) */
+
+/** Line aligned address range [base, limit). */
+typedef struct _cache_range {
+    uintptr_t base;
+    uintptr_t limit;
+} cache_range;
+
+/** Ranges already maintained by one kind of operation during the current
+ *  NPU invocation, sorted by address and non-overlapping. */
+typedef struct _cache_range_set {
+    cache_range ranges[ETHOSU_CACHE_MAX_RANGES];
+    uint32_t count;
+    uint32_t bytes;         /* Bytes maintained by address so far. */
+    uint32_t whole : 1;     /* Whole cache maintained; every range is covered. */
+    uint32_t requested : 1; /* A request needed maintenance (for the estimate). */
+} cache_range_set;
+
 /** Structure to maintain data cache states. */
 typedef struct _cpu_cache_state {
-    uint32_t dcache_invalidated : 1;
-    uint32_t dcache_cleaned : 1;
+    cache_range_set cleaned;
+    cache_range_set invalidated;
+    uint32_t by_addr_limit;
+    uint32_t full_clean_cycles;
+    uint32_t full_clean_invalidate_cycles;
+    uint32_t calibrated : 1;
 } cpu_cache_state;
 
 /** Static CPU cache state object.
- * @note This logic around flipping these states is based on the driver
- *       calling the functions in this sequence:
+ * @note The driver cleans every region it is about to use before starting the
+ *       NPU and invalidates them once the NPU is done. A range is therefore
+ *       only cleaned (or invalidated) once per NPU invocation, and cleaning
+ *       forgets about earlier invalidations and vice versa:
  *
  *       Cache flush (ethosu_flush_dcache)
  *                  ↓
@@ -54,7 +99,8 @@ typedef struct _cpu_cache_state {
  *                  ↓
  *       Cache invalidate (ethosu_dcache_invalidate)
  **/
-static cpu_cache_state s_cache_state = {.dcache_cleaned = 0, .dcache_invalidated = 0};
+static cpu_cache_state s_cache_state;
+static ethosu_cache_stats s_cache_stats;
 
 /**
  * @brief   Gets the current CPU cache state.
@@ -65,25 +111,222 @@ static cpu_cache_state* ethosu_get_cpu_cache_state(void)
     return &s_cache_state;
 }
 
+/**
+ * @brief   Reads the cycle counter used by the TensorFlow Lite Micro profiler.
+ */
+static uint32_t ethosu_cache_cycles(void)
+{
+#if defined(ARM_MODEL_USE_PMU_COUNTERS)
+    return ARM_PMU_Get_CCNTR();
+#else
+    return DWT->CYCCNT;
+#endif /* defined(ARM_MODEL_USE_PMU_COUNTERS) */
+}
+
+/**
+ * @brief   Works out the by-address limit and times the whole-cache operations
+ *          the previous implementation issued once per NPU invocation, so the
+ *          savings can be reported against them.
+ */
+static void ethosu_cache_calibrate(cpu_cache_state* state)
+{
+#if !defined(ARM_MODEL_USE_PMU_COUNTERS)
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+#endif /* !defined(ARM_MODEL_USE_PMU_COUNTERS) */
+
+    state->by_addr_limit = ETHOSU_CACHE_BY_ADDR_LIMIT;
+#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    if (!state->by_addr_limit) {
+        SCB->CSSELR = 0U; /* Level 1 data cache. */
+        __DSB();
+        const uint32_t ccsidr = SCB->CCSIDR;
+        state->by_addr_limit =
+            (CCSIDR_SETS(ccsidr) + 1U) * (CCSIDR_WAYS(ccsidr) + 1U) * __SCB_DCACHE_LINE_SIZE;
+    }
+
+    uint32_t start = ethosu_cache_cycles();
+    SCB_CleanDCache();
+    state->full_clean_cycles = ethosu_cache_cycles() - start;
+
+    start = ethosu_cache_cycles();
+    SCB_CleanInvalidateDCache();
+    state->full_clean_invalidate_cycles = ethosu_cache_cycles() - start;
+#endif /* defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U) */
+
+    info("NPU cache maintenance: by address up to %" PRIu32 " bytes, "
+         "whole cache clean %" PRIu32 " / clean+invalidate %" PRIu32 " cycles\n",
+         state->by_addr_limit,
+         state->full_clean_cycles,
+         state->full_clean_invalidate_cycles);
+    state->calibrated = 1;
+}
+
+/**
+ * @brief   Adds [base, limit) to a set, merging it with the ranges it
+ *          overlaps or touches.
+ * @return  false if the set is full.
+ */
+static bool ethosu_range_set_add(cache_range_set* set, uintptr_t base, uintptr_t limit)
+{
+    uint32_t first = 0;
+    while (first < set->count && set->ranges[first].limit < base) {
+        ++first;
+    }
+
+    uint32_t last = first;
+    while (last < set->count && set->ranges[last].base <= limit) {
+        base  = set->ranges[last].base < base ? set->ranges[last].base : base;
+        limit = set->ranges[last].limit > limit ? set->ranges[last].limit : limit;
+        ++last;
+    }
+
+    if (first == last && set->count == ETHOSU_CACHE_MAX_RANGES) {
+        return false;
+    }
+
+    /* Ranges [first, last) collapse into a single entry at first. */
+    const uint32_t tail = set->count - last;
+    memmove(&set->ranges[first + 1], &set->ranges[last], tail * sizeof(cache_range));
+    set->ranges[first].base  = base;
+    set->ranges[first].limit = limit;
+    set->count               = first + 1 + tail;
+    return true;
+}
+
+/**
+ * @brief   Empties a set, keeping track of whether the previous policy
+ *          would already have paid for its whole-cache operation.
+ */
+static void ethosu_range_set_forget(cache_range_set* set)
+{
+    set->count = 0;
+    set->bytes = 0;
+    set->whole = 0;
+}
+
+/**
+ * @brief   Maintains the parts of a request not already covered by a set,
+ *          falling back to the whole cache when that is cheaper.
+ * @param[in]   set         Ranges already maintained by this operation.
+ * @param[in]   other       Set of the opposite operation, cleared on success.
+ * @param[in]   p           Start address, NULL for the whole cache.
+ * @param[in]   bytes       Number of bytes.
+ * @param[in]   fullCycles  Measured cost of the whole-cache operation.
+ * @param[in]   byAddr      By-address operation.
+ * @param[in]   full        Whole-cache operation.
+ */
+static void ethosu_maintain(cache_range_set* set,
+                            cache_range_set* other,
+                            const uint32_t* p,
+                            size_t bytes,
+                            uint32_t fullCycles,
+                            void (*byAddr)(volatile void*, int32_t),
+                            void (*full)(void))
+{
+    cpu_cache_state* const state = ethosu_get_cpu_cache_state();
+    const uint32_t start = ethosu_cache_cycles();
+
+    ++s_cache_stats.requests;
+    if (!set->requested) {
+        set->requested = 1;
+        s_cache_stats.cycles_whole_cache += fullCycles;
+    }
+
+    if (set->whole) {
+        ++s_cache_stats.skipped;
+        return;
+    }
+
+    bool useFull = (p == NULL);
+    uintptr_t base  = 0;
+    uintptr_t limit = 0;
+
+    if (!useFull) {
+        const uintptr_t mask = __SCB_DCACHE_LINE_SIZE - 1U;
+        base  = (uintptr_t)p & ~mask;
+        limit = ((uintptr_t)p + bytes + mask) & ~mask;
+
+        /* Only the gaps between ranges maintained earlier are new. */
+        uint32_t gapBytes = 0;
+        uintptr_t cursor  = base;
+        for (uint32_t i = 0; i < set->count && cursor < limit; ++i) {
+            const cache_range* r = &set->ranges[i];
+            if (r->limit <= cursor) {
+                continue;
+            }
+            if (r->base > cursor) {
+                gapBytes += (r->base < limit ? r->base : limit) - cursor;
+            }
+            cursor = r->limit;
+        }
+        if (cursor < limit) {
+            gapBytes += limit - cursor;
+        }
+
+        if (!gapBytes) {
+            ++s_cache_stats.skipped;
+            return;
+        }
+        useFull = (set->bytes + gapBytes > state->by_addr_limit);
+
+        if (!useFull) {
+            cursor = base;
+            for (uint32_t i = 0; i < set->count && cursor < limit; ++i) {
+                const cache_range* r = &set->ranges[i];
+                if (r->limit <= cursor) {
+                    continue;
+                }
+                if (r->base > cursor) {
+                    const uintptr_t end = r->base < limit ? r->base : limit;
+                    byAddr((volatile void*)cursor, (int32_t)(end - cursor));
+                }
+                cursor = r->limit;
+            }
+            if (cursor < limit) {
+                byAddr((volatile void*)cursor, (int32_t)(limit - cursor));
+            }
+
+            set->bytes += gapBytes;
+            ++s_cache_stats.by_addr_ops;
+            s_cache_stats.bytes_by_addr += gapBytes;
+
+            /* A full set only means later requests may repeat some work. */
+            ethosu_range_set_add(set, base, limit);
+        }
+    }
+
+    if (useFull) {
+        full();
+        set->whole = 1;
+        ++s_cache_stats.whole_cache_ops;
+    }
+
+    ethosu_range_set_forget(other);
+    s_cache_stats.cycles_spent += ethosu_cache_cycles() - start;
+}
+
 bool __attribute__((weak)) ethosu_area_needs_flush_dcache(const uint32_t *p, size_t bytes)
 {
-    UNUSED(p);
-    UNUSED(bytes);
 #if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-    return SCB->CCR & SCB_CCR_DC_Msk;
+    return (SCB->CCR & SCB_CCR_DC_Msk) && ethosu_mem_needs_clean(p, bytes);
 #else
+    UNUSED(p);
+    UNUSED(bytes);
     return false;
 #endif
-
 }
 
 bool __attribute__((weak)) ethosu_area_needs_invalidate_dcache(const uint32_t *p, size_t bytes)
 {
-    UNUSED(p);
-    UNUSED(bytes);
 #if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-    return SCB->CCR & SCB_CCR_DC_Msk;
+    return (SCB->CCR & SCB_CCR_DC_Msk) && ethosu_mem_needs_invalidate(p, bytes);
 #else
+    UNUSED(p);
+    UNUSED(bytes);
     return false;
 #endif
 }
@@ -92,8 +335,10 @@ void ethosu_clear_cache_states(void)
 {
     cpu_cache_state* const state = ethosu_get_cpu_cache_state();
     trace("Clearing cache state members\n");
-    state->dcache_invalidated = 0;
-    state->dcache_cleaned     = 0;
+    ethosu_range_set_forget(&state->cleaned);
+    ethosu_range_set_forget(&state->invalidated);
+    state->cleaned.requested     = 0;
+    state->invalidated.requested = 0;
 }
 
 void ethosu_flush_dcache(uint32_t *p, size_t bytes)
@@ -102,33 +347,34 @@ void ethosu_flush_dcache(uint32_t *p, size_t bytes)
     if (ethosu_area_needs_flush_dcache(p, bytes)) {
 
         /**
-         * @note We could choose to call the `SCB_CleanDCache_by_Addr` function
-         *       here, but the sizes which this function is called for, can
-         *       cause unnecessary delays. It's worth noting that this function
-         *       is called from the Arm Ethos-U NPU drive repeatedly for each
-         *       region it accesses. This could even be RO memory which does
-         *       not need cache maintenance, along with parts of the input and
-         *       output tensors which rightly need to be cleaned. Therefore, to
-         *       reduce overhead of repeated calls for large memory sizes, we
-         *       call the clean and invalidation functions for whole cache.
+         * @note The driver calls this function for each region it accesses:
+         *       weights, scratch, and the input and output tensors, which
+         *       usually lie inside the scratch region. Read-only and
+         *       non-cacheable memory is filtered out by the hook above, the
+         *       rest is cleaned by address unless the regions add up to more
+         *       than the cache itself, in which case the whole cache is
+         *       cleaned once for this invocation.
          *
          *       If the neural network to be executed is completely falling
          *       onto the NPU, consider disabling the data cache altogether
          *       for the duration of the inference to further reduce the cache
          *       maintenance burden in these functions.
          */
-
-        /** Clean the cache if it hasn't been cleaned already  */
-        if (!state->dcache_cleaned) {
-            trace("Cleaning data cache\n");
-            SCB_CleanDCache();
-
-            /** Assert the cache cleaned state and clear the invalidation
-             *  state. */
-            state->dcache_cleaned     = 1;
-            state->dcache_invalidated = 0;
+        if (!state->calibrated) {
+            ethosu_cache_calibrate(state);
         }
+
+        trace("Cleaning data cache: %p, %zu bytes\n", (void*)p, bytes);
+        ethosu_maintain(&state->cleaned,
+                        &state->invalidated,
+                        p,
+                        bytes,
+                        state->full_clean_cycles,
+                        SCB_CleanDCache_by_Addr,
+                        SCB_CleanDCache);
     } else {
+        ++s_cache_stats.requests;
+        ++s_cache_stats.skipped;
         __DSB();
     }
 }
@@ -137,21 +383,23 @@ void ethosu_invalidate_dcache(uint32_t *p, size_t bytes)
 {
     cpu_cache_state* const state = ethosu_get_cpu_cache_state();
     if (ethosu_area_needs_invalidate_dcache(p, bytes)) {
-        /**
-         * See note in ethosu_flush_dcache function for why we clean the whole
-         * cache instead of calling it for specific addresses.
-         **/
-        if (!state->dcache_invalidated) {
-            trace("Invalidating data cache\n");
-            /* Not safe to simply invalidate without cleaning unless we know there are no write-back areas in the system */
-            SCB_CleanInvalidateDCache();
-
-            /** Assert the cache invalidation state and clear the clean
-             *  state. */
-            state->dcache_invalidated = 1;
-            state->dcache_cleaned     = 0;
+        if (!state->calibrated) {
+            ethosu_cache_calibrate(state);
         }
+
+        /* Not safe to simply invalidate without cleaning: lines at the edges
+         * of a range may hold dirty data of neighbouring buffers. */
+        trace("Invalidating data cache: %p, %zu bytes\n", (void*)p, bytes);
+        ethosu_maintain(&state->invalidated,
+                        &state->cleaned,
+                        p,
+                        bytes,
+                        state->full_clean_invalidate_cycles,
+                        SCB_CleanInvalidateDCache_by_Addr,
+                        SCB_CleanInvalidateDCache);
     } else {
+        ++s_cache_stats.requests;
+        ++s_cache_stats.skipped;
         __DSB();
     }
 }
@@ -159,5 +407,23 @@ void ethosu_invalidate_dcache(uint32_t *p, size_t bytes)
 void ethosu_inference_begin(struct ethosu_driver* drv, void* userArg)
 {
     UNUSED(userArg);
+    ++s_cache_stats.invocations;
     ethosu_clear_cache_states();
+    ethosu_npu_pmu_begin(drv);
+}
+
+void ethosu_inference_end(struct ethosu_driver* drv, void* userArg)
+{
+    UNUSED(userArg);
+    ethosu_npu_pmu_end(drv);
+}
+
+void ethosu_get_cache_stats(ethosu_cache_stats* stats)
+{
+    *stats = s_cache_stats;
+}
+
+void ethosu_reset_cache_stats(void)
+{
+    memset(&s_cache_stats, 0, sizeof(s_cache_stats));
 }
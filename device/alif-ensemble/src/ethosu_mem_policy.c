@@ -0,0 +1,348 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ethosu_mem_policy.h"
+
+#include "RTE_Components.h"         /* For CPU related defintiions */
+#include CMSIS_device_header
+#include "log_macros.h"             /* Logging macros */
+
+#include <inttypes.h>
+#include <string.h>
+
+#if !defined(ETHOSU_MEM_POLICY_MAX_REGIONS)
+#define ETHOSU_MEM_POLICY_MAX_REGIONS   48
+#endif /* !defined(ETHOSU_MEM_POLICY_MAX_REGIONS) */
+
+/* Symbols exported by the GCC linker scripts. They are weak so images linked
+ * without them (e.g. with a scatter file) fall back to what the MPU says. */
+extern const uint8_t __ITCM_BASE[] __attribute__((weak));
+extern const uint8_t __ITCM_SIZE[] __attribute__((weak));
+extern const uint8_t __DTCM_BASE[] __attribute__((weak));
+extern const uint8_t __DTCM_SIZE[] __attribute__((weak));
+extern const uint8_t __ROM_BASE[] __attribute__((weak));
+extern const uint8_t __ROM_SIZE[] __attribute__((weak));
+extern const uint8_t __OSPI_FLASH_BASE[] __attribute__((weak));
+extern const uint8_t __OSPI_FLASH_SIZE[] __attribute__((weak));
+extern const uint8_t __activation_buf_start[] __attribute__((weak));
+extern const uint8_t __activation_buf_end[] __attribute__((weak));
+extern const uint8_t __camera_buf_start[] __attribute__((weak));
+extern const uint8_t __camera_buf_end[] __attribute__((weak));
+extern const uint8_t __npu_private_start[] __attribute__((weak));
+extern const uint8_t __npu_private_end[] __attribute__((weak));
+
+/** Address range [base, limit] with its policy. */
+typedef struct _mem_region {
+    uintptr_t base;
+    uintptr_t limit;
+    uint32_t flags;
+    const char *name;
+} mem_region;
+
+/** Sorted, non-overlapping regions covering the whole address space. */
+typedef struct _mem_policy {
+    mem_region regions[ETHOSU_MEM_POLICY_MAX_REGIONS];
+    uint32_t count;
+    bool ready;
+} mem_policy;
+
+static mem_policy s_policy;
+static mem_region s_scratch[ETHOSU_MEM_POLICY_MAX_REGIONS];
+
+/**
+ * @brief   Decodes an MPU memory attribute (MAIR byte). The L1 cache follows
+ *          the inner attributes.
+ */
+static uint32_t ethosu_mem_flags_from_attr(uint8_t attr)
+{
+    const uint8_t outer = attr >> 4;
+    const uint8_t inner = attr & 0xF;
+
+    if (outer == 0 || inner == 0x4) {
+        /* Device or normal non-cacheable memory. */
+        return 0;
+    }
+    /* 0b00RW/0b10RW are write-through, 0b01RW/0b11RW write-back. */
+    return (inner & 0x4) ? ETHOSU_MEM_CACHEABLE | ETHOSU_MEM_WRITE_BACK : ETHOSU_MEM_CACHEABLE;
+}
+
+/**
+ * @brief   Overrides [base, limit] in the table. Pieces of existing regions
+ *          outside the range are kept; with ETHOSU_MEM_INHERIT the pieces
+ *          inside keep their flags, plus the ones given.
+ * @return  false if the table would overflow; the table is left unchanged.
+ */
+static bool ethosu_mem_paint(uintptr_t base, uintptr_t limit, uint32_t flags, const char *name)
+{
+    const bool inherit = (flags & ETHOSU_MEM_INHERIT) != 0;
+    flags &= ~ETHOSU_MEM_INHERIT;
+
+    uint32_t n = 0;
+    uint64_t cursor = base; /* First address of the range not emitted yet. */
+
+#define EMIT(b, l, f, nm)                                                 \
+    do {                                                                  \
+        if (n == ETHOSU_MEM_POLICY_MAX_REGIONS) {                         \
+            return false;                                                 \
+        }                                                                 \
+        s_scratch[n++] = (mem_region){(b), (l), (f), (nm)};               \
+    } while (0)
+
+    for (uint32_t i = 0; i < s_policy.count; ++i) {
+        const mem_region *r = &s_policy.regions[i];
+
+        if (r->limit < base) {
+            EMIT(r->base, r->limit, r->flags, r->name);
+            continue;
+        }
+        if (r->base > limit) {
+            if (cursor <= limit) {
+                EMIT((uintptr_t)cursor, limit, flags, name);
+                cursor = (uint64_t)limit + 1;
+            }
+            EMIT(r->base, r->limit, r->flags, r->name);
+            continue;
+        }
+
+        if (r->base < base) {
+            EMIT(r->base, base - 1, r->flags, r->name);
+        }
+        if (r->base > cursor) {
+            EMIT((uintptr_t)cursor, r->base - 1, flags, name);
+        }
+        const uintptr_t pieceBase  = r->base > base ? r->base : base;
+        const uintptr_t pieceLimit = r->limit < limit ? r->limit : limit;
+        EMIT(pieceBase, pieceLimit, inherit ? r->flags | flags : flags, name);
+        cursor = (uint64_t)pieceLimit + 1;
+        if (r->limit > limit) {
+            EMIT(limit + 1, r->limit, r->flags, r->name);
+        }
+    }
+    if (cursor <= limit) {
+        EMIT((uintptr_t)cursor, limit, flags, name);
+    }
+#undef EMIT
+
+    memcpy(s_policy.regions, s_scratch, n * sizeof(mem_region));
+    s_policy.count = n;
+    return true;
+}
+
+/**
+ * @brief   Paints [start, end) given by linker symbols; absent weak symbols
+ *          resolve to 0 and leave the table alone.
+ */
+static void ethosu_mem_paint_symbols(uintptr_t start,
+                                     uintptr_t end,
+                                     uint32_t flags,
+                                     const char *name)
+{
+    if (end > start) {
+        ethosu_mem_paint(start, end - 1, flags, name);
+    }
+}
+
+/**
+ * @brief   Paints the default memory map the MPU falls back to.
+ */
+static void ethosu_mem_paint_default_map(void)
+{
+    const uint32_t wbwa = ETHOSU_MEM_CACHEABLE | ETHOSU_MEM_WRITE_BACK;
+
+    ethosu_mem_paint(0x00000000, 0x1FFFFFFF, ETHOSU_MEM_CACHEABLE, "Code");
+    ethosu_mem_paint(0x20000000, 0x3FFFFFFF, wbwa, "SRAM");
+    ethosu_mem_paint(0x40000000, 0x5FFFFFFF, 0, "Peripheral");
+    ethosu_mem_paint(0x60000000, 0x7FFFFFFF, wbwa, "RAM");
+    ethosu_mem_paint(0x80000000, 0x9FFFFFFF, ETHOSU_MEM_CACHEABLE, "RAM");
+    ethosu_mem_paint(0xA0000000, 0xFFFFFFFF, 0, "Device");
+}
+
+/**
+ * @brief   Paints the enabled MPU regions, as programmed by MPU_Load_Regions().
+ */
+static void ethosu_mem_paint_mpu(void)
+{
+#if defined(__MPU_PRESENT) && (__MPU_PRESENT == 1U)
+    if (!(MPU->CTRL & MPU_CTRL_ENABLE_Msk)) {
+        return;
+    }
+
+    const uint32_t numRegions = (MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos;
+    for (uint32_t i = 0; i < numRegions; ++i) {
+        MPU->RNR = i;
+        const uint32_t rbar = MPU->RBAR;
+        const uint32_t rlar = MPU->RLAR;
+        if (!(rlar & MPU_RLAR_EN_Msk)) {
+            continue;
+        }
+
+        const uint32_t idx  = (rlar & MPU_RLAR_AttrIndx_Msk) >> MPU_RLAR_AttrIndx_Pos;
+        const uint32_t mair = idx < 4 ? MPU->MAIR0 : MPU->MAIR1;
+        uint32_t flags = ethosu_mem_flags_from_attr((uint8_t)(mair >> (8 * (idx % 4))));
+
+        /* AP[2:1] = 1x: read-only. */
+        if (rbar & (2U << MPU_RBAR_AP_Pos)) {
+            flags |= ETHOSU_MEM_READ_ONLY;
+        }
+
+        ethosu_mem_paint(rbar & MPU_RBAR_BASE_Msk,
+                         (rlar & MPU_RLAR_LIMIT_Msk) | ~MPU_RLAR_LIMIT_Msk,
+                         flags,
+                         "MPU region");
+    }
+#endif /* defined(__MPU_PRESENT) && (__MPU_PRESENT == 1U) */
+}
+
+void ethosu_mem_policy_init(void)
+{
+    s_policy.count = 0;
+    s_policy.ready = true;
+
+    ethosu_mem_paint_default_map();
+    ethosu_mem_paint_mpu();
+
+    /* TCM is never cached, whatever the attributes of its address range. */
+    if ((uintptr_t)__ITCM_SIZE) {
+        ethosu_mem_paint_symbols(
+            (uintptr_t)__ITCM_BASE, (uintptr_t)__ITCM_BASE + (uintptr_t)__ITCM_SIZE, 0, "ITCM");
+        ethosu_mem_paint_symbols(
+            (uintptr_t)__DTCM_BASE, (uintptr_t)__DTCM_BASE + (uintptr_t)__DTCM_SIZE, 0, "DTCM");
+    } else {
+        ethosu_mem_paint(0x00000000, 0x01FFFFFF, 0, "ITCM");
+        ethosu_mem_paint(0x20000000, 0x21FFFFFF, 0, "DTCM");
+    }
+
+    /* The image and models should never change while running. */
+    ethosu_mem_paint_symbols((uintptr_t)__ROM_BASE,
+                             (uintptr_t)__ROM_BASE + (uintptr_t)__ROM_SIZE,
+                             ETHOSU_MEM_INHERIT | ETHOSU_MEM_READ_ONLY,
+                             "MRAM image");
+    ethosu_mem_paint_symbols((uintptr_t)__OSPI_FLASH_BASE,
+                             (uintptr_t)__OSPI_FLASH_BASE + (uintptr_t)__OSPI_FLASH_SIZE,
+                             ETHOSU_MEM_INHERIT | ETHOSU_MEM_READ_ONLY,
+                             "OSPI flash");
+
+    /* Named for the printout; maintained according to where they live. */
+    ethosu_mem_paint_symbols((uintptr_t)__activation_buf_start,
+                             (uintptr_t)__activation_buf_end,
+                             ETHOSU_MEM_INHERIT,
+                             "Tensor arena");
+    ethosu_mem_paint_symbols((uintptr_t)__camera_buf_start,
+                             (uintptr_t)__camera_buf_end,
+                             ETHOSU_MEM_INHERIT,
+                             "Camera buffers");
+    ethosu_mem_paint_symbols((uintptr_t)__npu_private_start,
+                             (uintptr_t)__npu_private_end,
+                             ETHOSU_MEM_NPU_PRIVATE,
+                             "NPU private");
+
+    debug("NPU memory policy: %" PRIu32 " regions\n", s_policy.count);
+}
+
+bool ethosu_mem_policy_add(const void *base, size_t bytes, uint32_t flags, const char *name)
+{
+    if (!s_policy.ready) {
+        ethosu_mem_policy_init();
+    }
+    if (!bytes) {
+        return true;
+    }
+    if (!ethosu_mem_paint((uintptr_t)base, (uintptr_t)base + bytes - 1, flags, name)) {
+        printf_err("NPU memory policy table full, %s not added\n", name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief   Whether any region overlapping [p, p + bytes) has all of the
+ *          flags in `need` and none of the flags in `skip`.
+ */
+static bool ethosu_mem_any(const void *p, size_t bytes, uint32_t need, uint32_t skip)
+{
+    if (!p) {
+        /* Whole cache requested. */
+        return true;
+    }
+    if (!bytes) {
+        return false;
+    }
+    if (!s_policy.ready) {
+        ethosu_mem_policy_init();
+    }
+
+    const uintptr_t base  = (uintptr_t)p;
+    const uintptr_t limit = base + bytes - 1;
+
+    /* Last region starting at or below base. */
+    uint32_t lo = 0;
+    uint32_t hi = s_policy.count;
+    while (hi - lo > 1) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (s_policy.regions[mid].base <= base) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (uint32_t i = lo; i < s_policy.count && s_policy.regions[i].base <= limit; ++i) {
+        const uint32_t flags = s_policy.regions[i].flags;
+        if ((flags & need) == need && !(flags & skip)) {
+            return true;
+        }
+        if (s_policy.regions[i].limit >= limit) {
+            break;
+        }
+    }
+    return false;
+}
+
+bool ethosu_mem_needs_clean(const void *p, size_t bytes)
+{
+    return ethosu_mem_any(p,
+                          bytes,
+                          ETHOSU_MEM_CACHEABLE | ETHOSU_MEM_WRITE_BACK,
+                          ETHOSU_MEM_READ_ONLY | ETHOSU_MEM_NPU_PRIVATE);
+}
+
+bool ethosu_mem_needs_invalidate(const void *p, size_t bytes)
+{
+    return ethosu_mem_any(
+        p, bytes, ETHOSU_MEM_CACHEABLE, ETHOSU_MEM_READ_ONLY | ETHOSU_MEM_NPU_PRIVATE);
+}
+
+void ethosu_mem_policy_print(void)
+{
+    if (!s_policy.ready) {
+        ethosu_mem_policy_init();
+    }
+
+    info("NPU memory policy (C: cached, W: write-back, R: read-only, N: NPU private):\n");
+    for (uint32_t i = 0; i < s_policy.count; ++i) {
+        const mem_region *r = &s_policy.regions[i];
+        info("  0x%08" PRIx32 "-0x%08" PRIx32 " %c%c%c%c %s\n",
+             (uint32_t)r->base,
+             (uint32_t)r->limit,
+             (r->flags & ETHOSU_MEM_CACHEABLE) ? 'C' : '-',
+             (r->flags & ETHOSU_MEM_WRITE_BACK) ? 'W' : '-',
+             (r->flags & ETHOSU_MEM_READ_ONLY) ? 'R' : '-',
+             (r->flags & ETHOSU_MEM_NPU_PRIVATE) ? 'N' : '-',
+             r->name);
+    }
+}
@@ -18,61 +18,3 @@ uint64_t ethosu_address_remap(uint64_t address, int index)
     (void)index;
     return LocalToGlobal((void *) (uint32_t) address);
 }
-
-typedef struct address_range
-{
-    uintptr_t base;
-    uintptr_t limit;
-} address_range_t;
-
-const address_range_t no_need_to_invalidate_areas[] = {
-    /* TCM is never cached */
-    {
-        .base = 0x00000000,
-        .limit = 0x01FFFFFF,
-    },
-    {
-        .base = 0x20000000,
-        .limit = 0x21FFFFFF,
-    },
-    /* MRAM should never change while running */
-    {
-        .base = MRAM_BASE,
-        .limit = MRAM_BASE + MRAM_SIZE - 1,
-    }
-};
-
-static bool check_need_to_invalidate(const void *p, size_t bytes)
-{
-    uintptr_t base = (uintptr_t) p;
-    if (bytes == 0) {
-        return false;
-    }
-    uintptr_t limit = base + bytes - 1;
-    for (unsigned int i = 0; i < sizeof no_need_to_invalidate_areas / sizeof no_need_to_invalidate_areas[0]; i++) {
-        if (base >= no_need_to_invalidate_areas[i].base && limit <= no_need_to_invalidate_areas[i].limit) {
-            return false;
-        }
-    }
-    return true;
-}
-
-bool ethosu_area_needs_invalidate_dcache(const void *p, size_t bytes)
-{
-    /* API says null pointer can be passed */
-    if (!p) {
-        return true;
-    }
-    /* We know we have a cache and assume the cache is on */
-    return check_need_to_invalidate(p, bytes);
-}
-
-bool ethosu_area_needs_flush_dcache(const void *p, size_t bytes)
-{
-    /* API says null pointer can be passed */
-    if (!p) {
-        return true;
-    }
-    /* We know we have a cache and assume the cache is on */
-    return check_need_to_invalidate(p, bytes);
-}
@@ -16,6 +16,12 @@
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#include "mpu_M55_region_config.h"
+
+/* MPU region number of the OSPI1 XIP window, set by MPU_Load_Regions. */
+static uint32_t ospi1_xip_region;
 
 /**
  * @brief  Load (override) the MPU regions
@@ -111,6 +117,25 @@ void MPU_Load_Regions(void)
 
     /* Load the regions from the table */
     ARM_MPU_Load(0, mpu_table, sizeof(mpu_table)/sizeof(ARM_MPU_Region_t));
+
+    /* OSPI1 XIP is the last region of the table */
+    ospi1_xip_region = sizeof(mpu_table)/sizeof(ARM_MPU_Region_t) - 1;
+}
+
+void MPU_Set_OSPI1_XIP_Cacheable(bool cacheable)
+{
+    const uint32_t attr = cacheable ? MEMATTRIDX_NORMAL_WT_RA : MEMATTRIDX_NORMAL_NON_CACHEABLE;
+
+    /* Lines cached under the old attribute must not be hit afterwards */
+    SCB_CleanInvalidateDCache();
+
+    const uint32_t ctrl = MPU->CTRL;
+    ARM_MPU_Disable();
+    MPU->RNR = ospi1_xip_region;
+    MPU->RLAR = (MPU->RLAR & ~MPU_RLAR_AttrIndx_Msk) | (attr << MPU_RLAR_AttrIndx_Pos);
+    if (ctrl & MPU_CTRL_ENABLE_Msk) {
+        ARM_MPU_Enable(ctrl & ~MPU_CTRL_ENABLE_Msk);
+    }
 }
 
 /************************ (C) COPYRIGHT ALIF SEMICONDUCTOR *****END OF FILE****/
@@ -22,6 +22,8 @@
 #include "Driver_OSPI.h"
 #include "IS25WX256.h"
 #include "ospi.h"
+#include "ospi_flash.h"
+#include "mpu_M55_region_config.h"
 
 #include "log_macros.h"
 
@@ -34,13 +36,39 @@
          See RTE_Device.h */
 #define FLASH_DEVICE_FAST_READ_WAIT_CYCLES (RTE_ISSI_FLASH_WAIT_CYCLES)
 
+/* Octal DDR fast read, for incrementing bursts */
+#define OSPI_XIP_INCR_INST  0xFD
+
+/* Read for wrapping bursts (cache line fills). Define it, with the flash set up
+   to wrap, to add a profile using it; otherwise wrapping bursts use the
+   incrementing read. */
+
+#if !defined(OSPI_XIP_PROFILE)
+#define OSPI_XIP_PROFILE    0
+#endif
+
+const ospi_xip_profile ospi_xip_profiles[] = {
+    /* name                             prefetch continuous wrap   cacheable */
+    { "baseline",                       false,   false,     false, false },
+    { "prefetch",                       true,    false,     false, false },
+    { "prefetch+continuous",            true,    true,      false, false },
+    { "cacheable",                      false,   false,     false, true  },
+    { "cacheable+prefetch+cont",        true,    true,      false, true  },
+#if defined(OSPI_XIP_WRAP_INST)
+    { "cacheable+prefetch+cont+wrap",   true,    true,      true,  true  },
+#endif
+};
+const uint32_t ospi_xip_num_profiles = sizeof(ospi_xip_profiles) / sizeof(ospi_xip_profiles[0]);
+
+static const ospi_xip_profile *xip_profile;
+
 extern ARM_DRIVER_FLASH ARM_Driver_Flash_(1);
 static ARM_DRIVER_FLASH* const ptrDrvFlash = &ARM_Driver_Flash_(1);
 
 extern ARM_DRIVER_GPIO ARM_Driver_GPIO_(OSPI_RESET_PORT);
 static ARM_DRIVER_GPIO* const GPIODrv = &ARM_Driver_GPIO_(OSPI_RESET_PORT);
 
-static void ospi_flash_enable_xip()
+static void ospi_flash_enable_xip(const ospi_xip_profile *profile)
 {
     // so far this is for the OSPI1 only.
     OSPI_Type *ospi = (OSPI_Type *) OSPI1_BASE;
@@ -68,11 +96,11 @@ static void ospi_flash_enable_xip()
             | (0x0 << XIP_CTRL_INST_DDR_EN_OFFSET)
             | (0x1 << XIP_CTRL_RXDS_EN_OFFSET)
             | (0x1 << XIP_CTRL_INST_EN_OFFSET)
-            | (0x0 << XIP_CTRL_CONT_XFER_EN_OFFSET)
+            | (profile->continuous << XIP_CTRL_CONT_XFER_EN_OFFSET)
             | (0x0 << XIP_CTRL_XIP_HYPERBUS_EN_OFFSET)
             | (0x0 << XIP_CTRL_RXDS_SIG_EN_OFFSET)
             | (0x0 << XIP_CTRL_XIP_MBL_OFFSET)
-            | (0x0 << XIP_CTRL_XIP_PREFETCH_EN_OFFSET)
+            | (profile->prefetch << XIP_CTRL_XIP_PREFETCH_EN_OFFSET)
             | (0x0 << XIP_CTRL_RXDS_VL_EN_OFFSET);
 
     ospi->OSPI_XIP_CTRL = val;
@@ -80,8 +108,12 @@ static void ospi_flash_enable_xip()
     ospi->OSPI_RX_SAMPLE_DELAY = 0;
 
     ospi->OSPI_XIP_MODE_BITS = 0x00;
-    ospi->OSPI_XIP_INCR_INST = 0xFD;
-    ospi->OSPI_XIP_WRAP_INST = 0xFD;
+    ospi->OSPI_XIP_INCR_INST = OSPI_XIP_INCR_INST;
+#if defined(OSPI_XIP_WRAP_INST)
+    ospi->OSPI_XIP_WRAP_INST = profile->wrap ? OSPI_XIP_WRAP_INST : OSPI_XIP_INCR_INST;
+#else
+    ospi->OSPI_XIP_WRAP_INST = OSPI_XIP_INCR_INST;
+#endif
     ospi->OSPI_XIP_SER = 1;
 
     ospi->OSPI_XIP_CNT_TIME_OUT = 255;
@@ -89,6 +121,19 @@ static void ospi_flash_enable_xip()
     ospi_enable(ospi);
 
     aes->AES_CONTROL |= AES_CONTROL_XIP_EN;
+
+    MPU_Set_OSPI1_XIP_Cacheable(profile->cacheable);
+    xip_profile = profile;
+}
+
+void ospi_flash_set_xip_profile(const ospi_xip_profile *profile)
+{
+    ospi_flash_enable_xip(profile);
+}
+
+const ospi_xip_profile *ospi_flash_get_xip_profile(void)
+{
+    return xip_profile;
 }
 
 
@@ -134,7 +179,7 @@ int32_t ospi_flash_init()
         return ret;
     }
 
-    ospi_flash_enable_xip();
+    ospi_flash_enable_xip(&ospi_xip_profiles[OSPI_XIP_PROFILE]);
 
     return ret;
 }
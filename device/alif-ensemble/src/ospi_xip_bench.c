@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**************************************************************************//**
+ * @brief Read bandwidth and latency of the OSPI1 XIP window, to compare the
+ *        XIP profiles of ospi_flash.c
+ ******************************************************************************/
+
+#include <RTE_Components.h>
+#include CMSIS_device_header
+
+#include "ospi_xip_bench.h"
+#include "time_base.h"
+
+#include "log_macros.h"
+
+#include <inttypes.h>
+
+/* Cache line, OSPI page, flash sector */
+const uint32_t ospi_xip_bench_strides[OSPI_XIP_BENCH_STRIDES] = { 32, 256, 4096 };
+
+void ospi_xip_bench_reads(const void *base, uint32_t bytes, ospi_xip_read_stats *stats)
+{
+    const volatile uint32_t *words = (const volatile uint32_t *)base;
+    const uint32_t count = bytes / sizeof(uint32_t);
+
+    stats->bytes = count * sizeof(uint32_t);
+
+    /* Rotate before adding each word so that reordered data shows */
+    uint32_t checksum = 0;
+    SCB_CleanInvalidateDCache();
+    uint32_t start = time_base_ticks();
+    for (uint32_t i = 0; i < count; ++i) {
+        checksum = ((checksum << 1) | (checksum >> 31)) ^ words[i];
+    }
+    stats->seq_cycles = time_base_ticks() - start;
+    stats->checksum = checksum;
+
+    for (uint32_t s = 0; s < OSPI_XIP_BENCH_STRIDES; ++s) {
+        const uint32_t step = ospi_xip_bench_strides[s] / sizeof(uint32_t);
+        uint32_t sink = 0;
+        uint32_t reads = 0;
+
+        SCB_CleanInvalidateDCache();
+        start = time_base_ticks();
+        for (uint32_t i = 0; i < count; i += step, ++reads) {
+            sink += words[i];
+        }
+        stats->stride_cycles[s] = time_base_ticks() - start;
+        stats->stride_reads[s] = reads;
+        (void)sink;
+    }
+}
+
+void ospi_xip_bench_print(const ospi_xip_profile *profile, const ospi_xip_read_stats *stats)
+{
+    const uint64_t us = time_base_ticks_to_us(stats->seq_cycles);
+
+    info("XIP %-30s sequential %" PRIu32 " bytes in %" PRIu64 " us (%" PRIu64 " KB/s)\n",
+         profile->name,
+         stats->bytes,
+         us,
+         us ? (uint64_t)stats->bytes * 1000000 / 1024 / us : 0);
+
+    for (uint32_t s = 0; s < OSPI_XIP_BENCH_STRIDES; ++s) {
+        info("XIP %-30s stride %4" PRIu32 ": %" PRIu32 " cycles per read\n",
+             profile->name,
+             ospi_xip_bench_strides[s],
+             stats->stride_reads[s] ? stats->stride_cycles[s] / stats->stride_reads[s] : 0);
+    }
+}
@@ -23,15 +23,23 @@ extern "C" {
 #endif // defined(__cplusplus)
 
 #include "log_macros.h"
+#include "time_base.h"
 #include "uart_stdout.h"
 
 /* Platform dependent files */
 #include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
 #include CMSIS_device_header /* Gives us IRQ num, base addresses. */
 
+/** @brief  SysTick ISR: keeps the 64-bit time base current. */
+void SysTick_Handler(void)
+{
+    time_base_update();
+}
+
 #if defined(ETHOSU_ARCH)
 #include "ethosu_driver.h" /* Arm Ethos-U NPU driver header */
 #include "ethosu_mem_config.h" /* Arm Ethos-U NPU memory config */
+#include "ethosu_npu_pmu.h" /* Arm Ethos-U NPU performance counters */
 
 #if defined(ETHOS_U_CACHE_BUF_SZ) && (ETHOS_U_CACHE_BUF_SZ > 0)
 static uint8_t cache_arena[ETHOS_U_CACHE_BUF_SZ] CACHE_BUF_ATTRIBUTE;
@@ -55,6 +63,9 @@ static size_t get_cache_arena_size()
 
 struct ethosu_driver ethosu_drv; /* Default Ethos-U device driver */
 
+/** MACs per cycle of the NPU, 0 until arm_ethosu_npu_init succeeds. */
+static uint32_t npu_macs_per_cc;
+
 /** @brief   Defines the Ethos-U interrupt handler: just a wrapper around the default
  *           implementation. */
 static void arm_ethosu_npu_irq_handler(void)
@@ -63,6 +74,22 @@ static void arm_ethosu_npu_irq_handler(void)
     ethosu_irq_handler(&ethosu_drv);
 }
 
+/** @brief   Overrides the driver's weak hook: starts the NPU PMU before every
+ *           command stream. */
+void ethosu_inference_begin(struct ethosu_driver* drv, void* user_arg)
+{
+    (void)user_arg;
+    ethosu_npu_pmu_begin(drv);
+}
+
+/** @brief   Overrides the driver's weak hook: collects the NPU PMU counts after
+ *           every command stream. */
+void ethosu_inference_end(struct ethosu_driver* drv, void* user_arg)
+{
+    (void)user_arg;
+    ethosu_npu_pmu_end(drv);
+}
+
 /** @brief  Initialises the NPU IRQ */
 static void arm_ethosu_npu_irq_init(void)
 {
@@ -123,6 +150,7 @@ static int arm_ethosu_npu_init(void)
     info("\tMACs/cc:    %" PRIu32 "\n", (uint32_t)(1 << hw_info.cfg.macs_per_cc));
     info("\tCmd stream: v%" PRIu32 "\n", hw_info.cfg.cmd_stream_version);
 
+    npu_macs_per_cc = 1U << hw_info.cfg.macs_per_cc;
     return 0;
 }
 
@@ -132,8 +160,29 @@ static int arm_ethosu_npu_init(void)
 }
 #endif // defined(__cplusplus)
 
+bool BoardGetNpuInfo(uint32_t* arch, uint32_t* macsPerCc)
+{
+#if defined(ETHOSU_ARCH)
+    if (!npu_macs_per_cc) {
+        return false;
+    }
+#if defined(ETHOSU65)
+    *arch = 65;
+#else
+    *arch = 55;
+#endif /* defined(ETHOSU65) */
+    *macsPerCc = npu_macs_per_cc;
+    return true;
+#else  /* defined(ETHOSU_ARCH) */
+    (void)arch;
+    (void)macsPerCc;
+    return false;
+#endif /* defined(ETHOSU_ARCH) */
+}
+
 void BoardInit(void)
 {
+    time_base_start_systick();
     UartStdOutInit();
 
 #if defined(ETHOSU_ARCH)
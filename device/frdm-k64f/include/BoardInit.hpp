@@ -19,9 +19,20 @@
 #ifndef BOARD_INIT_HPP
 #define BOARD_INIT_HPP
 
+#include <stdint.h>
+
 /**
  * @brief Board initialisation - sets up all peripherals required.
  */
 void BoardInit(void);
 
+/**
+ * @brief       Gets the Ethos-U NPU set up by BoardInit, to pick the model
+ *              compiled for it.
+ * @param[out]  arch        Ethos-U product: 55 or 65.
+ * @param[out]  macsPerCc   MACs per clock cycle of the NPU configuration.
+ * @return      false if there is no NPU, or it failed to initialise.
+ */
+bool BoardGetNpuInfo(uint32_t* arch, uint32_t* macsPerCc);
+
 #endif
@@ -22,12 +22,28 @@
 extern "C" {
 #include "board.h"
 #include "pin_mux.h"
+#include "time_base.h"
 #include "uart_stdout.h"
 }
 #endif // defined(__cplusplus)
 
+/** @brief  SysTick ISR: keeps the 64-bit time base current. */
+extern "C" void SysTick_Handler(void)
+{
+    time_base_update();
+}
+
 void BoardInit(void)
 {
     BOARD_InitBootPins();
+    time_base_start_systick();
     UartStdOutInit();
 }
+
+bool BoardGetNpuInfo(uint32_t* arch, uint32_t* macsPerCc)
+{
+    /* No NPU on this board. */
+    (void)arch;
+    (void)macsPerCc;
+    return false;
+}
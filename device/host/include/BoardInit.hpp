@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BOARD_INIT_HPP
+#define BOARD_INIT_HPP
+
+#include <stdint.h>
+
+/**
+ * @brief Board initialisation - on the host, sets up the console.
+ */
+void BoardInit(void);
+
+/**
+ * @brief       Gets the Ethos-U NPU set up by BoardInit, to pick the model
+ *              compiled for it.
+ * @param[out]  arch        Ethos-U product: 55 or 65.
+ * @param[out]  macsPerCc   MACs per clock cycle of the NPU configuration.
+ * @return      false if there is no NPU, or it failed to initialise.
+ */
+bool BoardGetNpuInfo(uint32_t* arch, uint32_t* macsPerCc);
+
+#endif /* BOARD_INIT_HPP */
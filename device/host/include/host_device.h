@@ -0,0 +1,29 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HOST_DEVICE_H
+#define HOST_DEVICE_H
+
+/*
+ * Stands in for the CMSIS device header on the host. The examples only use
+ * the core peripherals (data cache, PMU, DWT, NVIC) where the device header
+ * declares them present, so none is declared here.
+ */
+#define __DCACHE_PRESENT    0U
+#define __PMU_PRESENT       0U
+
+#endif /* HOST_DEVICE_H */
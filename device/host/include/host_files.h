@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HOST_FILES_H
+#define HOST_FILES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Inputs of the host build. The examples take no arguments on the boards, so
+ * on the host the files they read are named by environment variables.
+ */
+
+/**
+ * @brief       Reads the whole file named by an environment variable.
+ * @param[in]   env_var Environment variable holding the path.
+ * @param[out]  size    Size of the file in bytes. May be NULL.
+ * @return      Contents, 16-byte aligned and never freed, or NULL if the
+ *              variable is not set or the file cannot be read.
+ */
+const uint8_t *host_load_file(const char *env_var, size_t *size);
+
+/**
+ * @brief       Writes a buffer to the file named by an environment variable.
+ * @param[in]   env_var Environment variable holding the path.
+ * @param[in]   data    Data to write.
+ * @param[in]   size    Size of the data in bytes.
+ * @return      0 if written or if the variable is not set, -1 on error.
+ */
+int host_save_file(const char *env_var, const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HOST_FILES_H */
@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BoardInit.hpp"
+
+#include "log_macros.h"
+#include "time_base.h"
+
+#include <cstdio>
+
+void BoardInit(void)
+{
+    /* Keep the log in order with anything written to stderr. */
+    setvbuf(stdout, nullptr, _IONBF, 0);
+
+    time_base_init();
+    info("Host build: TFLM reference kernels, times in nanoseconds\n");
+}
+
+bool BoardGetNpuInfo(uint32_t* arch, uint32_t* macsPerCc)
+{
+    /* Reference kernels only: the CPU model runs. */
+    (void)arch;
+    (void)macsPerCc;
+    return false;
+}
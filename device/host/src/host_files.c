@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_files.h"
+
+#include "log_macros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+const uint8_t *host_load_file(const char *env_var, size_t *size)
+{
+    const char *path = getenv(env_var);
+    if (!path || !path[0]) {
+        return NULL;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        printf_err("Cannot open %s (%s)\n", path, env_var);
+        return NULL;
+    }
+
+    uint8_t *data = NULL;
+    long len      = -1;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        len = ftell(f);
+    }
+    if (len >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+        /* Rounded up: aligned_alloc wants a multiple of the alignment. */
+        data = aligned_alloc(16, ((size_t)len + 15) & ~(size_t)15);
+    }
+    if (data && fread(data, 1, (size_t)len, f) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+
+    if (!data) {
+        printf_err("Cannot read %s (%s)\n", path, env_var);
+        return NULL;
+    }
+    info("Read %ld bytes from %s\n", len, path);
+    if (size) {
+        *size = (size_t)len;
+    }
+    return data;
+}
+
+int host_save_file(const char *env_var, const void *data, size_t size)
+{
+    const char *path = getenv(env_var);
+    if (!path || !path[0]) {
+        return 0;
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f || fwrite(data, 1, size, f) != size) {
+        printf_err("Cannot write %s (%s)\n", path, env_var);
+        if (f) {
+            fclose(f);
+        }
+        return -1;
+    }
+    fclose(f);
+    info("Wrote %zu bytes to %s\n", size, path);
+    return 0;
+}
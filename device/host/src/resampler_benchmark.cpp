@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Host benchmark of the KWS live example's sample-rate converter: time per
+ * output sample for the capture rates the board supports, next to the MACs per
+ * output sample the filter design implies. kws/src/main_live.cpp logs the same
+ * cost per DMA block on the target.
+ */
+#include "AudioResampler.hpp"
+#include "BoardInit.hpp"
+#include "log_macros.h"
+#include "time_base.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+/* Rate the MFCC front-end expects. */
+#define RESAMPLER_BENCHMARK_OUTPUT_RATE     16000
+
+/* Seconds of audio converted per rate pair. */
+#define RESAMPLER_BENCHMARK_SECONDS         20
+
+int main()
+{
+    BoardInit();
+
+    static const uint32_t inputRates[] = {16000, 32000, 44100, 48000};
+    for (const uint32_t inputRate : inputRates) {
+        arm::app::audio::PolyphaseResampler resampler;
+        if (!resampler.Init(inputRate, RESAMPLER_BENCHMARK_OUTPUT_RATE)) {
+            printf_err("Unsupported rate conversion %" PRIu32 " Hz\n", inputRate);
+            return 1;
+        }
+
+        /* Half a second per block, as the live example's DMA buffer; a 1 kHz tone. */
+        std::vector<int16_t> block(inputRate / 2);
+        for (size_t i = 0; i < block.size(); ++i) {
+            block[i] = static_cast<int16_t>(
+                16384 * std::sin(2 * M_PI * 1000 * i / inputRate) + (std::rand() % 64 - 32));
+        }
+        std::vector<int16_t> output(resampler.MaxOutputLen(block.size()));
+
+        uint64_t outputLen    = 0;
+        const uint64_t blocks = 2 * RESAMPLER_BENCHMARK_SECONDS;
+        const uint64_t start  = time_base_ticks64();
+        for (uint64_t b = 0; b < blocks; ++b) {
+            outputLen += resampler.Process(block.data(), block.size(), output.data(), output.size());
+        }
+        const uint64_t ticks = time_base_ticks64() - start;
+
+        const uint64_t audioUs = blocks * 500000;
+        info("%" PRIu32 " -> %d Hz (L=%" PRIu32 ", M=%" PRIu32 "): %" PRIu32
+             " MACs per output sample, %" PRIu64 " samples out, %.1f ns per output sample, "
+             "%.3f%% of real time\n",
+             inputRate,
+             RESAMPLER_BENCHMARK_OUTPUT_RATE,
+             resampler.GetUpFactor(),
+             resampler.GetDownFactor(),
+             resampler.IsBypass() ? 0 : resampler.GetTapsPerPhase(),
+             outputLen,
+             outputLen ? static_cast<double>(ticks) * 1e9 / time_base_ticks_per_second() /
+                             outputLen
+                       : 0.0,
+             100.0 * time_base_ticks_to_us(ticks) / audioUs);
+    }
+    return 0;
+}
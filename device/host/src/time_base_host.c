@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 199309L    /* clock_gettime */
+
+#include "time_base.h"
+
+#include <time.h>
+
+/*
+ * time_base.h on the host: the monotonic clock in nanoseconds stands in for
+ * the cycle counter, so "cycles" in the examples' output are nanoseconds.
+ */
+#define TIME_BASE_HOST_HZ   (1000000000U)
+
+static uint64_t s_start_ns;
+
+static uint64_t time_base_host_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * TIME_BASE_HOST_HZ + (uint64_t)ts.tv_nsec;
+}
+
+void time_base_init(void)
+{
+    if (!s_start_ns) {
+        s_start_ns = time_base_host_now();
+    }
+}
+
+void time_base_start_systick(void)
+{
+    time_base_init();
+}
+
+void time_base_update(void)
+{
+}
+
+uint32_t time_base_ticks_per_second(void)
+{
+    return TIME_BASE_HOST_HZ;
+}
+
+uint32_t time_base_ticks(void)
+{
+    return (uint32_t)time_base_ticks64();
+}
+
+uint64_t time_base_ticks64(void)
+{
+    time_base_init();
+    return time_base_host_now() - s_start_ns;
+}
+
+uint64_t time_base_ticks_to_us(uint64_t ticks)
+{
+    return ticks / (TIME_BASE_HOST_HZ / 1000000);
+}
+
+uint64_t time_base_us(void)
+{
+    return time_base_ticks_to_us(time_base_ticks64());
+}
@@ -28,13 +28,15 @@ extern "C" {
 #include "stm32746g_discovery_audio.h"
 #include "stm32f7xx_hal.h"
 #include "stm32f7xx_hal_cortex.h"
+#include "time_base.h"
 #include "uart_stdout.h"
 #include <stdbool.h>
 
-/** @brief SysTick ISR */
+/** @brief SysTick ISR: HAL tick, which also keeps the 64-bit time base current. */
 __attribute__((used)) void SysTick_Handler(void)
 {
     HAL_IncTick();
+    time_base_update();
 }
 
 extern SAI_HandleTypeDef haudio_out_sai;
@@ -137,6 +139,7 @@ void BoardInit(void)
     }
 
     SystemCoreClockUpdate();
+    time_base_init();
 
     HAL_SetTickFreq(HAL_TICK_FREQ_100HZ);
     UartStdOutInit();
@@ -147,3 +150,11 @@ void BoardInit(void)
 
     return;
 }
+
+bool BoardGetNpuInfo(uint32_t* arch, uint32_t* macsPerCc)
+{
+    /* No NPU on this board. */
+    (void)arch;
+    (void)macsPerCc;
+    return false;
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Every build of the keyword spotting model in one image, for
+ * SelectModelVariant (MODEL_VARIANTS). Each generated source is wrapped in a
+ * namespace of its own so that their symbols do not clash; the headers they
+ * include come first, so that their include guards keep them out of it.
+ */
+#include "BufAttributes.hpp"
+#include "ModelVariants.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kws_model_cpu {
+#include "kws_micronet_m.tflite.cpp"
+} /* namespace kws_model_cpu */
+
+namespace kws_model_h128 {
+#include "kws_micronet_m_vela_H128.tflite.cpp"
+} /* namespace kws_model_h128 */
+
+namespace kws_model_h256 {
+#include "kws_micronet_m_vela_H256.tflite.cpp"
+} /* namespace kws_model_h256 */
+
+namespace kws_model_y256 {
+#include "kws_micronet_m_vela_Y256.tflite.cpp"
+} /* namespace kws_model_y256 */
+
+namespace arm {
+namespace app {
+namespace kws {
+
+    extern const ModelVariant modelVariants[] = {
+        {"H128", 55, 128, kws_model_h128::arm::app::kws::GetModelPointer,
+         kws_model_h128::arm::app::kws::GetModelLen},
+        {"H256", 55, 256, kws_model_h256::arm::app::kws::GetModelPointer,
+         kws_model_h256::arm::app::kws::GetModelLen},
+        {"Y256", 65, 256, kws_model_y256::arm::app::kws::GetModelPointer,
+         kws_model_y256::arm::app::kws::GetModelLen},
+        {"CPU", 0, 0, kws_model_cpu::arm::app::kws::GetModelPointer,
+         kws_model_cpu::arm::app::kws::GetModelLen},
+    };
+
+    extern const size_t numModelVariants = sizeof(modelVariants) / sizeof(modelVariants[0]);
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
@@ -23,18 +23,26 @@
  * the memory requirements for TensorFlow-Lite-Micro framework and
  * some heap for the API runtime.
  */
+#include "AudioResampler.hpp"   /* Capture rate to model rate conversion. */
 #include "AudioUtils.hpp"       /* Generic audio utilities like sliding windows. */
 #include "BufAttributes.hpp"    /* Buffer attributes to be applied. */
 #include "Classifier.hpp"       /* Classifier for the result. */
 #include "KwsProcessing.hpp"    /* Pre and Post Process. */
 #include "KwsResult.hpp"        /* KWS results class. */
 #include "Labels.hpp"           /* Label Data for the model. */
+#include "LatencyHistogram.hpp" /* Capture-to-decision latency. */
 #include "MicroNetKwsModel.hpp" /* Model API. */
+#include "OverlappedInference.hpp" /* Overlaps pre-processing with the NPU. */
+#include "StereoFrontEnd.hpp"   /* Two-microphone down-mix. */
 #include "GpioSignal.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <vector>
 
+#include "tensorflow/lite/micro/micro_time.h" /* Cycle counter for stage timing. */
+
 /* Platform dependent files */
 #include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
 #include CMSIS_device_header /* Gives us IRQ num, base addresses. */
@@ -43,13 +51,21 @@
 
 #include "BoardAudioUtils.hpp" /* Board specific audio utilities - recording audio. */
 #include "BoardPlotUtils.hpp"  /* Board specific display utilities. */
+#include "uart_stdout.h"       /* Console input for the latency report. */
+
+#ifndef AUDIO_STEERING_DELAY
+/* Delay-and-sum steering delay in capture-rate samples; positive delays the
+ * right microphone. Zero averages both channels. */
+#define AUDIO_STEERING_DELAY (0)
+#endif /* AUDIO_STEERING_DELAY */
 
 namespace arm {
 namespace app {
 
     /* Tensor arena buffer */
     static uint8_t tensorArena[ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
-    static int16_t audioBufferDMA[16000]; /* half a second worth of stereo audio or full second worth of mono */
+    static int16_t audioBufferDMA[AUDIO_CAPTURE_SAMPLING_RATE * AUDIO_CAPTURE_CHANNELS /
+                                  2]; /* half a second worth of audio at the capture rate */
     static int16_t audioBufferForNN[16000]; /* one full second worth of mono audio */
 
     static audio_buf dmaBuf = {.data       = audioBufferDMA,
@@ -72,26 +88,61 @@ namespace app {
 __asm("  .global __ARM_use_no_argv\n");
 #endif
 
+/** Next inference window, prepared while the NPU runs the current one. */
+struct WindowJob {
+    arm::app::KwsPreProcess* preProcess;
+    arm::app::audio::SlidingWindow<const int16_t>* slider;
+    const uint32_t* captureTicks; /* Capture tick of each half of the mono buffer. */
+    uint32_t halfLen;
+    uint32_t ticksPerSample;
+
+    arm::app::LatencyHistogram::Timestamps ts;
+    uint32_t index;
+    bool ready;
+    bool failed;
+};
+
+/**
+ * @brief   Computes the features of the next window into the staging tensor.
+ *          Runs as OverlappedInference overlap work, in a single slice: the
+ *          features come from one KwsPreProcess call, which cannot be split.
+ *          Thanks to the pre-processor's cache only the MFCC frames new to the
+ *          window are computed, so the slice holds the operators after the NPU
+ *          up by at most that, instead of running it all after the decision.
+ * @param[in]   arg     WindowJob.
+ * @return      false: no more work.
+ */
+static bool PrepareNextWindow(void* arg);
+
+/**
+ * @brief   Inference completion callback; stamps the end of the inference.
+ * @param[in]   success     Unused.
+ * @param[in]   arg         Timestamps of the window being inferred.
+ */
+static void OnInferenceDone(bool success, void* arg);
+
 static int32_t CalculateOffset(audio_buf* audioBuffer);
 
 static int32_t CalculateScale(audio_buf* audioBuffer);
 
 static void ApplyGainAndOffset(audio_buf* audioBuffer, int32_t audioOffset, int32_t audioScale);
 
-static void ConvertToMono(audio_buf* stereo,
-                          audio_buf* mono,
-                          uint32_t stereoStartIdx,
-                          uint32_t monoStartIndex);
-
 int main()
 {
     BoardInit();
 
+    const uint8_t* modelData = arm::app::kws::GetModelPointer();
+    if (!modelData) {
+        /* A compressed model (ModelCompression.hpp) that failed to expand. */
+        printf_err("No model\n");
+        return 1;
+    }
+
     /* Model object creation and initialisation. */
     arm::app::MicroNetKwsModel model;
     if (!model.Init(arm::app::tensorArena,
                     sizeof(arm::app::tensorArena),
-                    arm::app::kws::GetModelPointer(),
+                    modelData,
                     arm::app::kws::GetModelLen())) {
         printf_err("Failed to initialise model\n");
         return 1;
@@ -141,9 +192,16 @@ int main()
     /* Populate the labels here. */
     GetLabelsVector(labels);
 
+    /* Pre-processing writes into a staging copy of the input tensor, so that
+     * the features of the next window can be computed while the NPU reads the
+     * current ones. */
+    std::vector<uint8_t> stagingData(inputTensor->bytes);
+    TfLiteTensor stagingTensor = *inputTensor;
+    stagingTensor.data.data    = stagingData.data();
+
     /* Set up pre and post-processing. */
     arm::app::KwsPreProcess preProcess = arm::app::KwsPreProcess(
-        inputTensor, numMfccFeatures, numMfccFrames, mfccFrameLength, mfccFrameStride);
+        &stagingTensor, numMfccFeatures, numMfccFrames, mfccFrameLength, mfccFrameStride);
 
     arm::app::KwsPostProcess postProcess =
         arm::app::KwsPostProcess(outputTensor, classifier, labels, singleInfResult);
@@ -164,6 +222,29 @@ int main()
 
     AudioUtils audio{};
     audio.AudioInit(&arm::app::dmaBuf);
+
+    /* Converts from the capture rate to the rate the MFCC front-end expects. */
+    arm::app::audio::PolyphaseResampler resampler;
+    if (!resampler.Init(audio.GetSamplingRate(),
+                        arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq)) {
+        printf_err("Failed to initialise resampler\n");
+        return 1;
+    }
+
+    /* Combines the two microphones when the capture is stereo. */
+    arm::app::audio::StereoFrontEnd stereoFrontEnd;
+#if defined(AUDIO_STEREO_SELECT_BEST)
+    const bool stereoFrontEndOk =
+        stereoFrontEnd.Init(arm::app::audio::StereoFrontEnd::Mode::BestChannel, 0);
+#else  /* defined(AUDIO_STEREO_SELECT_BEST) */
+    const bool stereoFrontEndOk = stereoFrontEnd.Init(
+        arm::app::audio::StereoFrontEnd::Mode::DelayAndSum, AUDIO_STEERING_DELAY);
+#endif /* defined(AUDIO_STEREO_SELECT_BEST) */
+    if (!stereoFrontEndOk) {
+        printf_err("Failed to initialise stereo front-end\n");
+        return 1;
+    }
+
     audio.StartAudioRecording();
 
     PlotUtils plot{};
@@ -175,6 +256,23 @@ int main()
     int32_t audioGain                       = 0;
     int32_t audioOffset                     = 0;
 
+    /* Capture timestamps of the blocks held in each half of the mono buffer. The
+     * newest sample of a half was captured at its block's timestamp; earlier ones
+     * one sample period apart before that. */
+    arm::app::LatencyHistogram latency{tflite::ticks_per_second()};
+    std::vector<uint32_t> latencyUs;
+    constexpr uint32_t latencyUnknown = UINT32_MAX;
+    uint32_t captureTicks[2]      = {0, 0};
+    const uint32_t halfLen        = arm::app::monoBuf.n_elements / 2;
+    const uint32_t ticksPerSample =
+        tflite::ticks_per_second() / arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq;
+    bool resampleShortWarned      = false;
+
+    arm::app::OverlappedInference inference;
+    WindowJob job{&preProcess, &audioDataSlider, captureTicks, halfLen, ticksPerSample};
+
+    info("Press 'l' on the console for the latency histogram\n");
+
     while (true) {
 
         audioDataSlider.Reset();
@@ -183,6 +281,8 @@ int main()
             __WFI();
         }
         audio.StopAudioRecording();
+        captureTicks[0] = captureTicks[1];
+        captureTicks[1] = audio.GetCaptureTimestamp();
 
         if (0 == captureCount++ % scaleOffsetResetFreq) {
             audioOffset = CalculateOffset(&arm::app::dmaBuf);
@@ -196,13 +296,40 @@ int main()
                (void*)((uint8_t*)arm::app::monoBuf.data + arm::app::monoBuf.n_bytes / 2),
                arm::app::monoBuf.n_bytes / 2);
 
+        /* Down-mix in place; the mono samples end up at the start of the DMA buffer. */
+        uint32_t capturedLen = arm::app::dmaBuf.n_elements;
         if (audio.IsStereo()) {
-            /* Populate the second half of the mono buffer from the freshly captured audio */
-            ConvertToMono(&arm::app::dmaBuf, &arm::app::monoBuf, 0, arm::app::monoBuf.n_elements / 2);
-        } else {
-            memcpy((void*)((uint8_t*)arm::app::monoBuf.data + arm::app::monoBuf.n_bytes / 2),
-                  arm::app::dmaBuf.data,
-                  arm::app::monoBuf.n_bytes / 2);
+            capturedLen /= 2;
+            stereoFrontEnd.Process(static_cast<int16_t*>(arm::app::dmaBuf.data),
+                                   capturedLen,
+                                   static_cast<int16_t*>(arm::app::dmaBuf.data));
+        }
+
+        /* Populate the second half of the mono buffer from the freshly captured audio */
+        const uint32_t resampleStart = tflite::GetCurrentTimeTicks();
+        const uint32_t resampledLen =
+            resampler.Process(static_cast<int16_t*>(arm::app::dmaBuf.data),
+                              capturedLen,
+                              static_cast<int16_t*>(arm::app::monoBuf.data) +
+                                  arm::app::monoBuf.n_elements / 2,
+                              arm::app::monoBuf.n_elements / 2);
+        debug("Resampled %" PRIu32 " -> %" PRIu32 " samples in %" PRIu32 " cycles\n",
+              capturedLen,
+              resampledLen,
+              tflite::GetCurrentTimeTicks() - resampleStart);
+
+        /* A rate that does not divide the block leaves the half short by a
+         * sample now and then: hold the last one rather than keep stale audio. */
+        if (resampledLen < halfLen) {
+            if (!resampleShortWarned) {
+                warn("Resampler gave %" PRIu32 " of %" PRIu32 " samples, holding the last\n",
+                     resampledLen,
+                     halfLen);
+                resampleShortWarned = true;
+            }
+            int16_t* half = static_cast<int16_t*>(arm::app::monoBuf.data) + halfLen;
+            const int16_t hold = resampledLen ? half[resampledLen - 1] : 0;
+            std::fill(half + resampledLen, half + halfLen, hold);
         }
 
         plot.PlotWaveform(static_cast<int16_t*>(arm::app::monoBuf.data),
@@ -212,23 +339,26 @@ int main()
         audio.SetAudioEmpty();
         audio.StartAudioRecording();
 
-        while (audioDataSlider.HasNext()) {
-            const int16_t* inferenceWindow = audioDataSlider.Next();
-
-            /* The first window does not have cache ready. */
-            preProcess.m_audioWindowIndex = audioDataSlider.Index();
+        /* The first window is prepared up front, each next one while the
+         * NPU runs the current one. */
+        PrepareNextWindow(&job);
 
-            /* Run the pre-processing, inference and post-processing. */
-            if (!preProcess.DoPreProcess(
-                    inferenceWindow, arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq)) {
+        while (job.ready) {
+            if (job.failed) {
                 printf_err("Pre-processing failed.");
                 return 1;
             }
+            arm::app::LatencyHistogram::Timestamps ts = job.ts;
+            const uint32_t index                      = job.index;
+            job.ready                                 = false;
+            memcpy(inputTensor->data.data, stagingData.data(), inputTensor->bytes);
 
             info("Inference #: %" PRIu32 "\n", ++inferenceCount);
 
             statusLED.Send(true);
-            if (!model.RunInference()) {
+            ts.inferenceStart = tflite::GetCurrentTimeTicks();
+            inference.Overlap(PrepareNextWindow, &job);
+            if (!inference.Run(model, OnInferenceDone, &ts)) {
                 printf_err("Inference failed.");
                 statusLED.Send(false);
                 return 2;
@@ -239,17 +369,22 @@ int main()
                 printf_err("Post-processing failed.");
                 return 3;
             }
+            ts.decided = tflite::GetCurrentTimeTicks();
+
+            /* Until a second capture, the older half of the buffer has no timestamp. */
+            latencyUs.push_back(captureCount > 1 ? latency.Record(ts) : latencyUnknown);
 
             /* Add results from this window to our final results vector. */
-            finalResults.emplace_back(arm::app::kws::KwsResult(
-                singleInfResult,
-                audioDataSlider.Index() * secondsPerSample * preProcess.m_audioDataStride,
-                audioDataSlider.Index(),
-                scoreThreshold));
+            finalResults.emplace_back(
+                arm::app::kws::KwsResult(singleInfResult,
+                                         index * secondsPerSample * preProcess.m_audioDataStride,
+                                         index,
+                                         scoreThreshold));
 
-        } /* while (audioDataSlider.HasNext()) */
+        } /* while (job.ready) */
 
-        for (const auto& result : finalResults) {
+        for (size_t i = 0; i < finalResults.size(); ++i) {
+            const auto& result = finalResults[i];
 
             std::string topKeyword{"<none>"};
             float score = 0.f;
@@ -264,7 +399,14 @@ int main()
                         /* Update last keyword. */
                         lastValidKeywordDetected = topKeyword;
 
-                        info("Detected: %s; Prob: %0.2f\n", topKeyword.c_str(), score);
+                        if (latencyUs[i] == latencyUnknown) {
+                            info("Detected: %s; Prob: %0.2f\n", topKeyword.c_str(), score);
+                        } else {
+                            info("Detected: %s; Prob: %0.2f; Latency: %" PRIu32 " ms\n",
+                                 topKeyword.c_str(),
+                                 score,
+                                 latencyUs[i] / 1000);
+                        }
                         plot.ClearStringLine(9);
                         std::string dispStr = " Last Keyword: " + topKeyword;
                         plot.DisplayStringAtLine(9, dispStr);
@@ -282,24 +424,49 @@ int main()
         }
 
         finalResults.clear();
+        latencyUs.clear();
+
+        if (UartGetcNoBlock() == 'l') {
+            latency.Print();
+        }
     }
 
     return 0;
 }
 
-static void ConvertToMono(audio_buf* stereo,
-                          audio_buf* mono,
-                          uint32_t stereoStartIdx,
-                          uint32_t monoStartIndex)
+static bool PrepareNextWindow(void* arg)
 {
-    int16_t* pIn     = ((int16_t*)stereo->data) + stereoStartIdx;
-    int16_t* pOut    = ((int16_t*)mono->data) + monoStartIndex;
-    uint32_t sizeIn  = stereo->n_elements - stereoStartIdx;
-    uint32_t sizeOut = mono->n_elements - monoStartIndex;
-
-    for (int i = 0, j = 0; j < sizeIn && i < sizeOut; ++i, j += 2, pIn += 2) {
-        *pOut++ = ((pIn[0] >> 1) + (pIn[1] >> 1));
+    WindowJob* const job = static_cast<WindowJob*>(arg);
+    if (!job->slider->HasNext()) {
+        return false;
     }
+
+    const int16_t* inferenceWindow = job->slider->Next();
+    job->index                     = job->slider->Index();
+
+    /* The first window does not have cache ready. */
+    job->preProcess->m_audioWindowIndex = job->index;
+
+    const uint32_t newest = job->index * job->preProcess->m_audioDataStride +
+                            job->preProcess->m_audioDataWindowSize - 1;
+    const uint32_t half   = newest < job->halfLen ? 0 : 1;
+
+    job->ts          = {};
+    job->ts.captured = job->captureTicks[half] -
+                       ((half + 1) * job->halfLen - 1 - newest) * job->ticksPerSample;
+    job->ts.preProcessStart = tflite::GetCurrentTimeTicks();
+
+    job->failed = !job->preProcess->DoPreProcess(
+        inferenceWindow, arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq);
+    job->ready = true;
+    return false;
+}
+
+static void OnInferenceDone(bool success, void* arg)
+{
+    (void)success;
+    static_cast<arm::app::LatencyHistogram::Timestamps*>(arg)->decisionStart =
+        tflite::GetCurrentTimeTicks();
 }
 
 static int32_t CalculateOffset(audio_buf* audioBuffer)
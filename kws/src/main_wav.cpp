@@ -24,31 +24,59 @@
  * the memory requirements for TensorFlow-Lite-Micro framework and
  * some heap for the API runtime.
  */
+#include "ArenaUsage.hpp"    /* Tensor arena usage report. */
+#include "AudioSource.hpp"   /* Clip sources for replay. */
 #include "AudioUtils.hpp"
 #include "BufAttributes.hpp" /* Buffer attributes to be applied */
 #include "Classifier.hpp"    /* Classifier for the result */
+#include "GoldenOutput.hpp"  /* Regression check of the outputs */
 #include "InputFiles.hpp"    /* Baked-in input (not needed for live data) */
 #include "KwsProcessing.hpp" /* Pre and Post Process */
 #include "KwsResult.hpp"
 #include "Labels.hpp" /* Label Data for the model */
 #include "MicroNetKwsMfcc.hpp"
 #include "MicroNetKwsModel.hpp" /* Model API */
+#include "ModelVariants.hpp"    /* Model built for the NPU found at boot */
+#include "OperatorProfiler.hpp"  /* Per-operator profiling (optional) */
+#include "ethosu_npu_pmu.h"       /* NPU performance counters */
+#include "time_base.h"            /* Tick to time conversion */
+
+#include <cstring>
+
+#include "tensorflow/lite/micro/micro_time.h" /* Cycle counter for throughput. */
 
 /* Platform dependent files */
 #include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
 #include CMSIS_device_header /* Gives us IRQ num, base addresses. */
 #include "BoardInit.hpp"      /* Board initialisation */
 #include "log_macros.h"      /* Logging macros (optional) */
+#if defined(HOST_BUILD)
+#include "host_files.h"      /* File inputs of the host build */
+#endif /* defined(HOST_BUILD) */
+
+/* Largest error of an output element accepted by GOLDEN_OUTPUT_CHECK: bit-exact by default. */
+#if !defined(GOLDEN_OUTPUT_TOLERANCE)
+#define GOLDEN_OUTPUT_TOLERANCE (0)
+#endif /* !defined(GOLDEN_OUTPUT_TOLERANCE) */
 
 namespace arm {
 namespace app {
     /* Tensor arena buffer */
     static uint8_t tensorArena[ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
 
+    /* Current inference window, refilled block by block from the audio source. */
+    static int16_t audioWindow[audio::MicroNetKwsMFCC::ms_defaultSamplingFreq];
+
     /* Optional getter function for the model pointer and its size. */
     namespace kws {
+#if defined(MODEL_VARIANTS)
+        /* Every build of the model (KwsModelVariants.cpp). */
+        extern const ModelVariant modelVariants[];
+        extern const size_t numModelVariants;
+#else
         extern uint8_t* GetModelPointer();
         extern size_t GetModelLen();
+#endif /* defined(MODEL_VARIANTS) */
     } /* namespace kws */
 } /* namespace app */
 } /* namespace arm */
@@ -63,11 +91,43 @@ int main()
     BoardInit();
 
     /* Model object creation and initialisation. */
+#if defined(PROFILE_OPERATORS)
+    arm::app::ProfiledModel<arm::app::MicroNetKwsModel> model;
+    model.GetProfiler().SetReportInterval(PROFILE_OPERATORS, PROFILE_OPERATORS_FORMAT);
+#else
     arm::app::MicroNetKwsModel model;
+#endif /* defined(PROFILE_OPERATORS) */
+
+    /* Paint the arena to cross-check how much of it the model writes. */
+    arm::app::ArenaUsage arenaUsage(arm::app::tensorArena, sizeof(arm::app::tensorArena));
+    arenaUsage.Paint();
+
+#if defined(MODEL_VARIANTS)
+    /* The build of the model for the NPU found at boot, or the CPU model. */
+    uint32_t npuArch      = 0;
+    uint32_t npuMacsPerCc = 0;
+    BoardGetNpuInfo(&npuArch, &npuMacsPerCc);
+    const arm::app::ModelVariant* variant = arm::app::SelectModelVariant(
+        arm::app::kws::modelVariants, arm::app::kws::numModelVariants, npuArch, npuMacsPerCc);
+    if (!variant) {
+        return 1;
+    }
+    const uint8_t* modelData = variant->getModelPointer();
+    const size_t modelLen    = variant->getModelLen();
+#else
+    const uint8_t* modelData = arm::app::kws::GetModelPointer();
+    const size_t modelLen    = arm::app::kws::GetModelLen();
+#endif /* defined(MODEL_VARIANTS) */
+    if (!modelData) {
+        /* A compressed model (ModelCompression.hpp) that failed to expand. */
+        printf_err("No model\n");
+        return 1;
+    }
+
     if (!model.Init(arm::app::tensorArena,
                     sizeof(arm::app::tensorArena),
-                    arm::app::kws::GetModelPointer(),
-                    arm::app::kws::GetModelLen())) {
+                    modelData,
+                    modelLen)) {
         printf_err("Failed to initialise model\n");
         return 1;
     }
@@ -123,76 +183,207 @@ int main()
     arm::app::KwsPostProcess postProcess =
         arm::app::KwsPostProcess(outputTensor, classifier, labels, singleInfResult);
 
-    /* Creating a sliding window through the whole audio clip. */
-    auto audioDataSlider =
-        arm::app::audio::SlidingWindow<const int16_t>(get_audio_array(0),
-                                                      get_audio_array_size(0),
-                                                      preProcess.m_audioDataWindowSize,
-                                                      preProcess.m_audioDataStride);
+#if defined(AUDIO_CORPUS_ADDRESS)
+    /* Packed corpus in external flash, read through the XIP window. */
+    arm::app::audio::CorpusAudioSource source;
+    if (!source.Init(reinterpret_cast<const void*>(AUDIO_CORPUS_ADDRESS), true)) {
+        return 1;
+    }
+    if (source.GetSampleRate() != arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq) {
+        printf_err("Corpus sampled at %" PRIu32 " Hz, model expects %" PRIu32 " Hz\n",
+                   source.GetSampleRate(),
+                   arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq);
+        return 1;
+    }
+#elif defined(HOST_BUILD)
+    /* A corpus file from scripts/pack_audio_corpus.py if MLEK_AUDIO_CORPUS
+     * names one, otherwise the clips baked into the program. */
+    arm::app::audio::ArrayAudioSource arraySource{
+        NUMBER_OF_FILES, get_audio_array, get_audio_array_size, get_filename};
+    arm::app::audio::CorpusAudioSource corpusSource;
+    const uint8_t* corpus = host_load_file("MLEK_AUDIO_CORPUS", nullptr);
+    if (corpus) {
+        if (!corpusSource.Init(corpus, true)) {
+            return 1;
+        }
+        if (corpusSource.GetSampleRate() !=
+            arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq) {
+            printf_err("Corpus sampled at %" PRIu32 " Hz, model expects %" PRIu32 " Hz\n",
+                       corpusSource.GetSampleRate(),
+                       arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq);
+            return 1;
+        }
+    }
+    arm::app::audio::AudioSource& source =
+        corpus ? static_cast<arm::app::audio::AudioSource&>(corpusSource) : arraySource;
+#else  /* defined(AUDIO_CORPUS_ADDRESS) */
+    /* Clips baked into the image. */
+    arm::app::audio::ArrayAudioSource source{
+        NUMBER_OF_FILES, get_audio_array, get_audio_array_size, get_filename};
+#endif /* defined(AUDIO_CORPUS_ADDRESS) */
+
+    const uint32_t windowLen = preProcess.m_audioDataWindowSize;
+    const uint32_t strideLen = preProcess.m_audioDataStride;
+    if (windowLen > sizeof(arm::app::audioWindow) / sizeof(arm::app::audioWindow[0])) {
+        printf_err("Audio window of %" PRIu32 " samples does not fit the buffer\n", windowLen);
+        return 1;
+    }
+
+    uint32_t totalInferences = 0;
+    uint32_t labelledClips   = 0;
+    uint32_t correctClips    = 0;
+    uint64_t totalTicks      = 0;
+    uint64_t inferenceTicks  = 0;
+#if defined(ARM_NPU)
+    ethosu_npu_pmu_reset();
+#endif /* defined(ARM_NPU) */
+#if defined(GOLDEN_OUTPUT_CHECK)
+    /* One reference output per inference window, over all clips. */
+    arm::app::GoldenOutput golden(
+        arm::app::golden::tensors, arm::app::golden::numTensors, GOLDEN_OUTPUT_TOLERANCE);
+#endif /* defined(GOLDEN_OUTPUT_CHECK) */
+#if defined(GOLDEN_OUTPUT_DUMP)
+    size_t outputIndex = 0;
+#endif /* defined(GOLDEN_OUTPUT_DUMP) */
+
+    for (uint32_t clip = 0; clip < source.GetNumClips(); ++clip) {
+        source.SelectClip(clip);
+        debug("Using audio data from %s\n", source.GetClipName());
+
+        /* Stream the clip through a window buffer: the same windows a
+         * SlidingWindow over the whole clip would produce, except that short
+         * clips are zero-padded to one window. */
+        uint32_t filled = source.Read(arm::app::audioWindow, windowLen);
+        if (!filled) {
+            continue;
+        }
+        memset(arm::app::audioWindow + filled, 0, (windowLen - filled) * sizeof(int16_t));
 
-    debug("Using audio data from %s\n", get_filename(0));
+        const uint32_t clipStart = tflite::GetCurrentTimeTicks();
+        for (uint32_t index = 0;; ++index) {
 
-    while (audioDataSlider.HasNext()) {
-        const int16_t* inferenceWindow = audioDataSlider.Next();
+            /* The first window does not have cache ready. */
+            preProcess.m_audioWindowIndex = index;
 
-        /* The first window does not have cache ready. */
-        preProcess.m_audioWindowIndex = audioDataSlider.Index();
+            /* Run the pre-processing, inference and post-processing. */
+            if (!preProcess.DoPreProcess(
+                    arm::app::audioWindow,
+                    arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq)) {
+                printf_err("Pre-processing failed.");
+                return 1;
+            }
 
-        info(
-            "Inference %zu/%zu\n", audioDataSlider.Index() + 1, audioDataSlider.TotalStrides() + 1);
+#if defined(ARM_NPU)
+            ethosu_npu_pmu_next_inference();
+#endif /* defined(ARM_NPU) */
+            const uint32_t inferenceStart = tflite::GetCurrentTimeTicks();
+            if (!model.RunInference()) {
+                printf_err("Inference failed.");
+                return 2;
+            }
+            inferenceTicks += tflite::GetCurrentTimeTicks() - inferenceStart;
+
+#if defined(GOLDEN_OUTPUT_DUMP)
+            arm::app::GoldenOutput::Dump(outputTensor, outputIndex++);
+#endif /* defined(GOLDEN_OUTPUT_DUMP) */
+#if defined(GOLDEN_OUTPUT_CHECK)
+            golden.Check(outputTensor);
+#endif /* defined(GOLDEN_OUTPUT_CHECK) */
+
+            if (!postProcess.DoPostProcess()) {
+                printf_err("Post-processing failed.");
+                return 3;
+            }
 
-        /* Run the pre-processing, inference and post-processing. */
-        if (!preProcess.DoPreProcess(inferenceWindow,
-                                     arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq)) {
-            printf_err("Pre-processing failed.");
-            return 1;
+            /* Add results from this window to our final results vector. */
+            finalResults.emplace_back(arm::app::kws::KwsResult(
+                singleInfResult, index * secondsPerSample * strideLen, index, scoreThreshold));
+
+            /* Slide by one stride; stop once a full stride is no longer available. */
+            memmove(arm::app::audioWindow,
+                    arm::app::audioWindow + strideLen,
+                    (windowLen - strideLen) * sizeof(int16_t));
+            if (source.Read(arm::app::audioWindow + windowLen - strideLen, strideLen) <
+                strideLen) {
+                break;
+            }
         }
+        totalTicks += tflite::GetCurrentTimeTicks() - clipStart;
+        totalInferences += finalResults.size();
 
-        if (!model.RunInference()) {
-            printf_err("Inference failed.");
-            return 2;
+        /* The clip is classified by its highest scoring window. */
+        std::string topKeyword{"<none>"};
+        float topScore = 0.f;
+
+        for (const auto& result : finalResults) {
+            if (!result.m_resultVec.empty() &&
+                result.m_resultVec[0].m_normalisedVal > topScore) {
+                topKeyword = result.m_resultVec[0].m_label;
+                topScore   = result.m_resultVec[0].m_normalisedVal;
+            }
+
+            for (uint32_t j = 0; j < result.m_resultVec.size(); ++j) {
+                debug("For timestamp: %f (inference #: %" PRIu32
+                      "); label: %s, score: %f; threshold: %f\n",
+                      result.m_timeStamp,
+                      result.m_inferenceNumber,
+                      result.m_resultVec[j].m_label.c_str(),
+                      result.m_resultVec[j].m_normalisedVal,
+                      result.m_threshold);
+            }
         }
 
-        if (!postProcess.DoPostProcess()) {
-            printf_err("Post-processing failed.");
-            return 3;
+        const char* expected = source.GetClipLabel();
+        if (expected[0] != '\0') {
+            ++labelledClips;
+            correctClips += (topKeyword == expected);
         }
 
-        /* Add results from this window to our final results vector. */
-        finalResults.emplace_back(arm::app::kws::KwsResult(
-            singleInfResult,
-            audioDataSlider.Index() * secondsPerSample * preProcess.m_audioDataStride,
-            audioDataSlider.Index(),
-            scoreThreshold));
-    } /* while (audioDataSlider.HasNext()) */
+        info("Clip %" PRIu32 "/%" PRIu32 " %s: %s (score %f)%s%s\n",
+             clip + 1,
+             source.GetNumClips(),
+             source.GetClipName(),
+             topKeyword.c_str(),
+             topScore,
+             expected[0] != '\0' ? "; expected: " : "",
+             expected);
 
-    for (const auto& result : finalResults) {
+        finalResults.clear();
+    }
 
-        std::string topKeyword{"<none>"};
-        float score = 0.f;
-        if (!result.m_resultVec.empty()) {
-            topKeyword = result.m_resultVec[0].m_label;
-            score      = result.m_resultVec[0].m_normalisedVal;
-        }
+    const uint64_t ticksPerInference = totalInferences ? totalTicks / totalInferences : 0;
+    info("Processed %" PRIu32 " clips, %" PRIu32 " inferences, %" PRIu32
+         " cycles (%" PRIu32 " us) per inference on average\n",
+         source.GetNumClips(),
+         totalInferences,
+         static_cast<uint32_t>(ticksPerInference),
+         static_cast<uint32_t>(time_base_ticks_to_us(ticksPerInference)));
+    if (labelledClips) {
+        info("Accuracy: %" PRIu32 "/%" PRIu32 " (%.2f%%)\n",
+             correctClips,
+             labelledClips,
+             100.f * correctClips / labelledClips);
+    }
 
-        if (result.m_resultVec.empty()) {
-            info("For timestamp: %f (inference #: %" PRIu32 "); label: %s; threshold: %f\n",
-                 result.m_timeStamp,
-                 result.m_inferenceNumber,
-                 topKeyword.c_str(),
-                 result.m_threshold);
-        } else {
-            for (uint32_t j = 0; j < result.m_resultVec.size(); ++j) {
-                info("For timestamp: %f (inference #: %" PRIu32
-                     "); label: %s, score: %f; threshold: %f\n",
-                     result.m_timeStamp,
-                     result.m_inferenceNumber,
-                     result.m_resultVec[j].m_label.c_str(),
-                     result.m_resultVec[j].m_normalisedVal,
-                     result.m_threshold);
-            }
-        }
+    if (arenaUsage.Measure(model.GetAllocator())) {
+        arenaUsage.Print();
+    }
+
+#if defined(ARM_NPU)
+    ethosu_npu_pmu_stats npuStats;
+    ethosu_npu_pmu_get_stats(&npuStats);
+    ethosu_npu_pmu_print(&npuStats, totalInferences, inferenceTicks);
+#endif /* defined(ARM_NPU) */
+
+#if defined(PROFILE_OPERATORS)
+    model.GetProfiler().Print(PROFILE_OPERATORS_FORMAT);
+#endif /* defined(PROFILE_OPERATORS) */
+
+#if defined(GOLDEN_OUTPUT_CHECK)
+    if (!golden.Print()) {
+        return 4;
     }
+#endif /* defined(GOLDEN_OUTPUT_CHECK) */
 
     return 0;
 }
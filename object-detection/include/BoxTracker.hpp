@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BOX_TRACKER_HPP
+#define BOX_TRACKER_HPP
+
+#include "DetectionResult.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Follows detected objects from frame to frame and gives each an ID.
+     *
+     *          Detections are matched to the tracks they overlap most, by IoU.
+     *          Each track runs an alpha-beta filter, in fixed point, on the
+     *          centre and size of its box: a constant velocity model that
+     *          smooths the boxes and predicts them on frames the detector
+     *          skips. Tracks that go unmatched for too many detector runs, or
+     *          leave the image, are dropped.
+     *
+     *          Typical use, once per frame:
+     *
+     *              tracker.Predict();
+     *              if (detectorRan) {
+     *                  tracker.Update(results);
+     *              }
+     *              tracker.GetBoxes(boxes);
+     */
+    class BoxTracker {
+    public:
+        using Result = object_detection::DetectionResult;
+
+        /** Box of a track on the current frame. */
+        struct TrackedBox {
+            uint32_t id;
+            Result box;
+        };
+
+        /**
+         * @brief       Creates a tracker without tracks.
+         * @param[in]   width           Image width: boxes are kept inside the image.
+         * @param[in]   height          Image height.
+         * @param[in]   iouThreshold    Smallest IoU of a detection with the predicted
+         *                              box of the track it continues.
+         * @param[in]   maxMisses       Detector runs a track may go unmatched.
+         * @param[in]   minHits         Detections a track needs before it is shown.
+         */
+        BoxTracker(uint32_t width,
+                   uint32_t height,
+                   float iouThreshold,
+                   uint32_t maxMisses,
+                   uint32_t minHits);
+
+        /**
+         * @brief   Moves every track on by one frame, at its velocity.
+         */
+        void Predict();
+
+        /**
+         * @brief       Corrects the tracks with the detections of the current frame,
+         *              after Predict. Detections that match no track start one.
+         * @param[in]   detections  Boxes from the post-processing.
+         */
+        void Update(const std::vector<Result>& detections);
+
+        /**
+         * @brief       Gets the boxes of the tracks shown, inside the image.
+         * @param[out]  boxes   Boxes and track IDs.
+         */
+        void GetBoxes(std::vector<TrackedBox>& boxes) const;
+
+        /** @brief  Number of tracks, shown or not. */
+        size_t GetNumTracks() const;
+
+    private:
+        /** 1.0 in the fixed point of box coordinates and velocities: 1/256 pixel. */
+        static constexpr int32_t ms_one = 256;
+
+        /** Gain of the position and size corrections, 0.5. */
+        static constexpr int32_t ms_alpha = 128;
+
+        /** Gain of the velocity corrections, alpha^2 / (2 - alpha): critically damped. */
+        static constexpr int32_t ms_beta = 43;
+
+        /** Centre x, centre y, width and height of a box, in fixed point. */
+        struct Box {
+            int32_t v[4];
+        };
+
+        struct Track {
+            uint32_t id;
+            Box box;
+            Box velocity;       /* Change per frame. */
+            double score;       /* Score of the last detection. */
+            uint32_t hits;      /* Detections matched. */
+            uint32_t misses;    /* Detector runs unmatched since the last detection. */
+            uint32_t frames;    /* Frames since the last detection. */
+        };
+
+        struct Match {
+            uint32_t iou;       /* Fraction of 2^16. */
+            uint32_t track;
+            uint32_t detection;
+        };
+
+        /** @brief  Box of a detection in fixed point. */
+        static Box ToBox(const Result& result);
+
+        /** @brief  Intersection over union of two boxes, as a fraction of 2^16. */
+        static uint32_t Iou(const Box& a, const Box& b);
+
+        /** @brief  Applies a matched detection to a track. */
+        static void Correct(Track& track, const Box& measured, double score);
+
+        uint32_t m_width;
+        uint32_t m_height;
+        uint32_t m_iouThreshold;    /* Fraction of 2^16. */
+        uint32_t m_maxMisses;
+        uint32_t m_minHits;
+        uint32_t m_nextId{1};
+        std::vector<Track> m_tracks;
+        std::vector<Box> m_detections;
+        std::vector<Match> m_matches;
+        std::vector<bool> m_trackMatched;
+        std::vector<bool> m_detectionMatched;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* BOX_TRACKER_HPP */
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef QUANTIZED_DETECTOR_POST_PROCESS_HPP
+#define QUANTIZED_DETECTOR_POST_PROCESS_HPP
+
+#include "DetectionResult.hpp"
+#include "DetectorPostProcessing.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Post-processing of the YOLO-fastest outputs, with the results of
+     *          DetectorPostProcess but without dequantizing the whole grid.
+     *
+     *          The objectness threshold is converted once into the quantized
+     *          domain of each output tensor, so that rejecting a cell and anchor
+     *          costs one integer comparison. Only the few that pass get their
+     *          sigmoid and exponentials, from tables of the 256 quantized values,
+     *          the box decoding and the NMS: the cost follows the number of
+     *          detections rather than the size of the grid.
+     */
+    class QuantizedDetectorPostProcess {
+    public:
+        /**
+         * @brief       Sets up the tables of both output tensors.
+         * @param[in]   outputTensor0   Output of the coarse grid (stride 32, anchor1).
+         * @param[in]   outputTensor1   Output of the fine grid (stride 16, anchor2).
+         * @param[out]  results         Detections, appended to by DoPostProcess.
+         * @param[in]   postProcessParams   As for DetectorPostProcess.
+         */
+        QuantizedDetectorPostProcess(TfLiteTensor* outputTensor0,
+                                     TfLiteTensor* outputTensor1,
+                                     std::vector<object_detection::DetectionResult>& results,
+                                     const object_detection::PostProcessParams& postProcessParams);
+
+        /**
+         * @brief   Decodes the boxes above the threshold of the last inference,
+         *          runs the NMS and appends the detections to the results.
+         * @return  false if the output tensors are not int8 or uint8 YOLO grids.
+         */
+        bool DoPostProcess();
+
+    private:
+        /** Boxes per grid cell. */
+        static constexpr uint32_t ms_numBoxes = 3;
+
+        /** One output tensor: a grid of cells of ms_numBoxes boxes of
+         *  x, y, w, h, objectness and the class scores. */
+        struct Branch {
+            const uint8_t* data{nullptr};
+            uint32_t gridCols{0};
+            uint32_t gridRows{0};
+            const float* anchors{nullptr};
+            uint8_t signFlip{0};        /* Turns an int8 byte into its table index. */
+            int minIndex{0};            /* Table index at or below which no box passes. */
+            float sigmoid[256];         /* Sigmoid of each dequantized value. */
+            float exp[256];             /* Exponential of each dequantized value. */
+        };
+
+        /** Box that passed the threshold, centre and size in image pixels. */
+        struct Candidate {
+            float x;
+            float y;
+            float w;
+            float h;
+            float objectness;
+            size_t probs;               /* First class score in m_probs. */
+        };
+
+        /** @brief  Fills the tables of a branch; false if its tensor does not fit. */
+        bool InitBranch(Branch& branch,
+                        const TfLiteTensor* tensor,
+                        uint32_t stride,
+                        const float* anchors);
+
+        /** @brief  Adds the boxes of a branch above the threshold to the candidates. */
+        void Decode(const Branch& branch);
+
+        /** @brief  Zeroes the class scores of the boxes each better box overlaps. */
+        void Suppress();
+
+        std::vector<object_detection::DetectionResult>& m_results;
+        const object_detection::PostProcessParams m_params;
+        Branch m_branches[2];
+        bool m_valid{false};
+        std::vector<Candidate> m_candidates;
+        std::vector<float> m_probs;
+        std::vector<size_t> m_order;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* QUANTIZED_DETECTOR_POST_PROCESS_HPP */
@@ -18,13 +18,34 @@
 #define INF_RUNNER_TESTMODEL_HPP
 
 #include "Model.hpp"
+#if defined(USE_MODEL_OP_RESOLVER)
+#include "ModelOpResolver.hpp" /* Generated by scripts/gen_op_resolver.py */
+#else
 #include "MicroMutableAllOpsResolver.hpp"
+#endif /* defined(USE_MODEL_OP_RESOLVER) */
 
 namespace arm {
 namespace app {
 
+#if defined(USE_MODEL_OP_RESOLVER)
+   /* Only the operators of the model. */
+   using TestModelOpResolver = tflite::MicroMutableOpResolver<kNumberModelOperators>;
+#else
+   /* Every operator, for any model. */
+   using TestModelOpResolver = tflite::MicroMutableOpResolver<kNumberOperators>;
+#endif /* defined(USE_MODEL_OP_RESOLVER) */
+
    class TestModel : public Model {
 
+   public:
+       /**
+        * @brief       Checks that the op resolver has every operator of a model,
+        *              to fail before initialisation rather than part way through.
+        * @param[in]   modelData   Model flatbuffer.
+        * @return      true if the model can run with this resolver.
+        */
+       bool CheckOperators(const uint8_t* modelData);
+
    protected:
        /** @brief   Gets the reference to op resolver interface class. */
        const tflite::MicroOpResolver& GetOpResolver() override;
@@ -33,8 +54,8 @@ namespace app {
        bool EnlistOperations() override;
 
    private:
-       /* A mutable op resolver instance including every operation for Inference runner. */
-       tflite::MicroMutableOpResolver<kNumberOperators> m_opResolver;
+       /* A mutable op resolver instance with the operations for Inference runner. */
+       TestModelOpResolver m_opResolver;
    };
 
 } /* namespace app */
@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TILED_DETECTION_HPP
+#define TILED_DETECTION_HPP
+
+#include "DetectionResult.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Runs a detector over a frame larger than its input, as a grid of
+     *          overlapping tiles of the input's size, and merges the boxes of
+     *          all tiles with one NMS in frame coordinates.
+     *
+     *          With a latency budget per frame, tiles are scheduled round-robin
+     *          across frames: each frame runs the tiles that fit in the budget,
+     *          starting where the previous frame stopped, and the boxes of the
+     *          other tiles are kept from their last run.
+     *
+     *          Typical use, once per frame:
+     *
+     *              tiles.BeginFrame(budget);
+     *              while (tiles.NextTile(index)) {
+     *                  // Crop GetTile(index) into the input tensor, run the
+     *                  // detector, post-process into tileResults.
+     *                  tiles.EndTile(index, ticks, tileResults);
+     *              }
+     *              tiles.Merge(results, iouThreshold);
+     */
+    class TiledDetection {
+    public:
+        using Result = object_detection::DetectionResult;
+
+        /** Top left corner of a tile in the frame. */
+        struct Tile {
+            uint32_t x;
+            uint32_t y;
+        };
+
+        /**
+         * @brief       Lays out the tiles. Tiles stay one pixel inside the right
+         *              and bottom edges of the frame, for debayering, and start
+         *              on even coordinates.
+         * @param[in]   frameWidth  Width of the frame.
+         * @param[in]   frameHeight Height of the frame.
+         * @param[in]   tileWidth   Width of a tile: the detector's input width.
+         * @param[in]   tileHeight  Height of a tile: the detector's input height.
+         * @param[in]   minOverlap  Smallest overlap of neighbouring tiles, e.g.
+         *                          the size of the smallest object to detect.
+         */
+        TiledDetection(uint32_t frameWidth,
+                       uint32_t frameHeight,
+                       uint32_t tileWidth,
+                       uint32_t tileHeight,
+                       uint32_t minOverlap);
+
+        /** @brief  Number of tiles; 0 if the frame is smaller than a tile. */
+        size_t GetNumTiles() const;
+
+        /** @brief  Position of a tile. */
+        const Tile& GetTile(size_t index) const;
+
+        /**
+         * @brief       Starts a frame.
+         * @param[in]   budgetTicks Time base ticks the tiles of a frame may take;
+         *                          0 to run every tile on every frame.
+         */
+        void BeginFrame(uint32_t budgetTicks);
+
+        /**
+         * @brief       Gets the next tile to run in this frame. At least one tile
+         *              runs per frame, and no tile runs twice.
+         * @param[out]  index   Tile to run.
+         * @return      false once the frame's budget or tiles are used up.
+         */
+        bool NextTile(size_t& index);
+
+        /**
+         * @brief       Records the boxes of a tile, replacing those of its last run.
+         * @param[in]   index       Tile that ran.
+         * @param[in]   ticks       Time base ticks the tile took.
+         * @param[in]   tileResults Boxes in tile coordinates.
+         */
+        void EndTile(size_t index, uint32_t ticks, const std::vector<Result>& tileResults);
+
+        /**
+         * @brief       Merges the last boxes of every tile: the best scoring box
+         *              suppresses the boxes that overlap it by more than the
+         *              threshold, or that lie mostly inside it, as the part of an
+         *              object cut by a tile edge does.
+         * @param[out]  results         Boxes in frame coordinates.
+         * @param[in]   iouThreshold    Intersection over union threshold.
+         */
+        void Merge(std::vector<Result>& results, float iouThreshold) const;
+
+        /** @brief  Number of tiles run in this frame so far. */
+        size_t GetTilesRun() const;
+
+    private:
+        /** Fraction of the smaller box covered by the larger one above which
+         *  the smaller one is a cut-off part of the same object. */
+        static constexpr float ms_containedThreshold = 0.8f;
+
+        std::vector<Tile> m_tiles;
+        std::vector<std::vector<Result>> m_results;
+        size_t m_next{0};
+        size_t m_run{0};
+        uint32_t m_budget{0};
+        uint32_t m_spent{0};
+        uint32_t m_tileTicks{0};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* TILED_DETECTION_HPP */
@@ -0,0 +1,202 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BoxTracker.hpp"
+
+#include <algorithm>
+
+namespace arm {
+namespace app {
+
+    BoxTracker::BoxTracker(uint32_t width,
+                           uint32_t height,
+                           float iouThreshold,
+                           uint32_t maxMisses,
+                           uint32_t minHits)
+        : m_width{width},
+          m_height{height},
+          m_iouThreshold{static_cast<uint32_t>(iouThreshold * 65536)},
+          m_maxMisses{maxMisses},
+          m_minHits{minHits}
+    {}
+
+    BoxTracker::Box BoxTracker::ToBox(const Result& result)
+    {
+        return Box{{result.m_x0 * ms_one + result.m_w * ms_one / 2,
+                    result.m_y0 * ms_one + result.m_h * ms_one / 2,
+                    result.m_w * ms_one,
+                    result.m_h * ms_one}};
+    }
+
+    uint32_t BoxTracker::Iou(const Box& a, const Box& b)
+    {
+        const int64_t w = std::min(a.v[0] + a.v[2] / 2, b.v[0] + b.v[2] / 2) -
+                          std::max(a.v[0] - a.v[2] / 2, b.v[0] - b.v[2] / 2);
+        const int64_t h = std::min(a.v[1] + a.v[3] / 2, b.v[1] + b.v[3] / 2) -
+                          std::max(a.v[1] - a.v[3] / 2, b.v[1] - b.v[3] / 2);
+        if (w <= 0 || h <= 0) {
+            return 0;
+        }
+        const int64_t intersection = w * h;
+        const int64_t unionArea    = static_cast<int64_t>(a.v[2]) * a.v[3] +
+                                     static_cast<int64_t>(b.v[2]) * b.v[3] - intersection;
+        return unionArea > 0 ? static_cast<uint32_t>((intersection << 16) / unionArea) : 0;
+    }
+
+    void BoxTracker::Correct(Track& track, const Box& measured, double score)
+    {
+        const int32_t frames = std::max<int32_t>(1, track.frames);
+        for (int i = 0; i < 4; ++i) {
+            const int32_t residual = measured.v[i] - track.box.v[i];
+            if (track.hits == 1) {
+                /* Second detection: its offset from the first gives the velocity. */
+                track.box.v[i]      = measured.v[i];
+                track.velocity.v[i] = residual / frames;
+            } else {
+                track.box.v[i] += ms_alpha * residual / ms_one;
+                track.velocity.v[i] += ms_beta * residual / (ms_one * frames);
+            }
+        }
+        track.score  = score;
+        track.hits   += 1;
+        track.misses = 0;
+        track.frames = 0;
+    }
+
+    void BoxTracker::Predict()
+    {
+        const int32_t width  = this->m_width * ms_one;
+        const int32_t height = this->m_height * ms_one;
+        for (auto& track : this->m_tracks) {
+            for (int i = 0; i < 4; ++i) {
+                track.box.v[i] += track.velocity.v[i];
+            }
+            /* Shrinking boxes stop at one pixel. */
+            for (int i = 2; i < 4; ++i) {
+                if (track.box.v[i] < ms_one) {
+                    track.box.v[i] = ms_one;
+                }
+            }
+            ++track.frames;
+        }
+
+        this->m_tracks.erase(
+            std::remove_if(this->m_tracks.begin(),
+                           this->m_tracks.end(),
+                           [width, height](const Track& track) {
+                               return track.box.v[0] + track.box.v[2] / 2 <= 0 ||
+                                      track.box.v[1] + track.box.v[3] / 2 <= 0 ||
+                                      track.box.v[0] - track.box.v[2] / 2 >= width ||
+                                      track.box.v[1] - track.box.v[3] / 2 >= height;
+                           }),
+            this->m_tracks.end());
+    }
+
+    void BoxTracker::Update(const std::vector<Result>& detections)
+    {
+        this->m_detections.clear();
+        for (const auto& detection : detections) {
+            this->m_detections.push_back(ToBox(detection));
+        }
+
+        /* Greedy matching: the pairs that overlap most first. */
+        this->m_matches.clear();
+        for (uint32_t t = 0; t < this->m_tracks.size(); ++t) {
+            for (uint32_t d = 0; d < this->m_detections.size(); ++d) {
+                const uint32_t iou = Iou(this->m_tracks[t].box, this->m_detections[d]);
+                if (iou > this->m_iouThreshold) {
+                    this->m_matches.push_back(Match{iou, t, d});
+                }
+            }
+        }
+        std::sort(this->m_matches.begin(),
+                  this->m_matches.end(),
+                  [](const Match& a, const Match& b) { return a.iou > b.iou; });
+
+        this->m_trackMatched.assign(this->m_tracks.size(), false);
+        this->m_detectionMatched.assign(this->m_detections.size(), false);
+        for (const auto& match : this->m_matches) {
+            if (this->m_trackMatched[match.track] || this->m_detectionMatched[match.detection]) {
+                continue;
+            }
+            this->m_trackMatched[match.track]         = true;
+            this->m_detectionMatched[match.detection] = true;
+            Correct(this->m_tracks[match.track],
+                    this->m_detections[match.detection],
+                    detections[match.detection].m_normalisedVal);
+        }
+
+        /* Age the tracks left unmatched, dropping those missed too often. */
+        size_t kept = 0;
+        for (size_t t = 0; t < this->m_tracks.size(); ++t) {
+            Track& track = this->m_tracks[t];
+            if (!this->m_trackMatched[t] && ++track.misses > this->m_maxMisses) {
+                continue;
+            }
+            this->m_tracks[kept++] = track;
+        }
+        this->m_tracks.resize(kept);
+
+        for (size_t d = 0; d < this->m_detections.size(); ++d) {
+            if (!this->m_detectionMatched[d]) {
+                this->m_tracks.push_back(Track{this->m_nextId++,
+                                               this->m_detections[d],
+                                               Box{{0, 0, 0, 0}},
+                                               detections[d].m_normalisedVal,
+                                               1,
+                                               0,
+                                               0});
+            }
+        }
+    }
+
+    void BoxTracker::GetBoxes(std::vector<TrackedBox>& boxes) const
+    {
+        boxes.clear();
+        const int32_t maxX = static_cast<int32_t>(this->m_width) - 1;
+        const int32_t maxY = static_cast<int32_t>(this->m_height) - 1;
+        for (const auto& track : this->m_tracks) {
+            if (track.hits < this->m_minHits) {
+                continue;
+            }
+            /* Kept inside the image: a box is drawn up to x0 + w and y0 + h. */
+            const Box& box   = track.box;
+            const int32_t x0 = std::max(0, std::min(maxX, (box.v[0] - box.v[2] / 2) / ms_one));
+            const int32_t y0 = std::max(0, std::min(maxY, (box.v[1] - box.v[3] / 2) / ms_one));
+            const int32_t x1 = std::max(0, std::min(maxX, (box.v[0] + box.v[2] / 2) / ms_one));
+            const int32_t y1 = std::max(0, std::min(maxY, (box.v[1] + box.v[3] / 2) / ms_one));
+            if (x1 <= x0 || y1 <= y0) {
+                continue;
+            }
+
+            Result result          = {};
+            result.m_normalisedVal = track.score;
+            result.m_x0            = x0;
+            result.m_y0            = y0;
+            result.m_w             = x1 - x0;
+            result.m_h             = y1 - y0;
+            boxes.push_back(TrackedBox{track.id, result});
+        }
+    }
+
+    size_t BoxTracker::GetNumTracks() const
+    {
+        return this->m_tracks.size();
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Every build of the object detection model in one image, for
+ * SelectModelVariant (MODEL_VARIANTS). Each generated source is wrapped in a
+ * namespace of its own so that their symbols do not clash; the headers they
+ * include come first, so that their include guards keep them out of it.
+ */
+#include "BufAttributes.hpp"
+#include "ModelVariants.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace od_model_cpu {
+#include "yolo-fastest_192_face_v4.tflite.cpp"
+} /* namespace od_model_cpu */
+
+namespace od_model_h256 {
+#include "yolo-fastest_192_face_v4_vela_H256.tflite.cpp"
+} /* namespace od_model_h256 */
+
+namespace od_model_y256 {
+#include "yolo-fastest_192_face_v4_vela_Y256.tflite.cpp"
+} /* namespace od_model_y256 */
+
+namespace arm {
+namespace app {
+namespace object_detection {
+
+    extern const ModelVariant modelVariants[] = {
+        {"H256", 55, 256, od_model_h256::arm::app::object_detection::GetModelPointer,
+         od_model_h256::arm::app::object_detection::GetModelLen},
+        {"Y256", 65, 256, od_model_y256::arm::app::object_detection::GetModelPointer,
+         od_model_y256::arm::app::object_detection::GetModelLen},
+        {"CPU", 0, 0, od_model_cpu::arm::app::object_detection::GetModelPointer,
+         od_model_cpu::arm::app::object_detection::GetModelLen},
+    };
+
+    extern const size_t numModelVariants = sizeof(modelVariants) / sizeof(modelVariants[0]);
+
+} /* namespace object_detection */
+} /* namespace app */
+} /* namespace arm */
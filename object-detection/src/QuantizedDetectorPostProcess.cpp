@@ -0,0 +1,231 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "QuantizedDetectorPostProcess.hpp"
+
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace arm {
+namespace app {
+
+    QuantizedDetectorPostProcess::QuantizedDetectorPostProcess(
+        TfLiteTensor* outputTensor0,
+        TfLiteTensor* outputTensor1,
+        std::vector<object_detection::DetectionResult>& results,
+        const object_detection::PostProcessParams& postProcessParams)
+        : m_results{results},
+          m_params{postProcessParams}
+    {
+        this->m_valid =
+            this->InitBranch(this->m_branches[0], outputTensor0, 32, postProcessParams.anchor1) &&
+            this->InitBranch(this->m_branches[1], outputTensor1, 16, postProcessParams.anchor2);
+    }
+
+    bool QuantizedDetectorPostProcess::InitBranch(Branch& branch,
+                                                  const TfLiteTensor* tensor,
+                                                  uint32_t stride,
+                                                  const float* anchors)
+    {
+        if (!tensor || (tensor->type != kTfLiteInt8 && tensor->type != kTfLiteUInt8)) {
+            return false;
+        }
+
+        branch.data     = tensor->data.uint8;
+        branch.gridCols = this->m_params.inputImgCols / stride;
+        branch.gridRows = this->m_params.inputImgRows / stride;
+        branch.anchors  = anchors;
+        branch.signFlip = tensor->type == kTfLiteInt8 ? 0x80 : 0;
+
+        const size_t channels = ms_numBoxes * (5 + this->m_params.numClasses);
+        if (tensor->bytes != branch.gridCols * branch.gridRows * channels) {
+            return false;
+        }
+
+        /* Same arithmetic as the dequantization in DetectorPostProcess. */
+        const float scale     = tensor->params.scale;
+        const int zeroPoint   = tensor->params.zero_point;
+        const int indexOffset = tensor->type == kTfLiteInt8 ? -128 : 0;
+        for (int index = 0; index < 256; ++index) {
+            const float value     = (static_cast<float>(index + indexOffset) - zeroPoint) * scale;
+            branch.sigmoid[index] = 1.f / (1.f + std::exp(-value));
+            branch.exp[index]     = std::exp(value);
+        }
+
+        /* sigmoid(v) > threshold where v > log(threshold / (1 - threshold)). One step lower
+         * keeps rounding from losing a box: the table decides on the boxes that pass. */
+        const float threshold = this->m_params.threshold;
+        if (threshold <= 0.f || scale <= 0.f) {
+            branch.minIndex = -1;
+        } else if (threshold >= 1.f) {
+            branch.minIndex = 255;
+        } else {
+            const float logit = std::log(threshold / (1.f - threshold));
+            const float index = zeroPoint - indexOffset + logit / scale;
+            branch.minIndex   = static_cast<int>(
+                std::max(-1.f, std::min(255.f, std::floor(index) - 1.f)));
+        }
+        return true;
+    }
+
+    void QuantizedDetectorPostProcess::Decode(const Branch& branch)
+    {
+        const int numClasses   = this->m_params.numClasses;
+        const uint32_t boxSize = 5 + numClasses;
+        const float threshold  = this->m_params.threshold;
+        const float imageSize  = this->m_params.originalImageSize;
+        const uint32_t cells   = branch.gridCols * branch.gridRows;
+
+        const uint8_t* box = branch.data;
+        for (uint32_t cell = 0; cell < cells; ++cell) {
+            for (uint32_t anchor = 0; anchor < ms_numBoxes; ++anchor, box += boxSize) {
+                const int objectnessIndex = box[4] ^ branch.signFlip;
+                if (objectnessIndex <= branch.minIndex) {
+                    continue;
+                }
+                const float objectness = branch.sigmoid[objectnessIndex];
+                if (objectness <= threshold) {
+                    continue;
+                }
+
+                const uint32_t col = cell % branch.gridCols;
+                const uint32_t row = cell / branch.gridCols;
+                Candidate candidate;
+                candidate.x = (branch.sigmoid[box[0] ^ branch.signFlip] + col) /
+                              branch.gridCols * imageSize;
+                candidate.y = (branch.sigmoid[box[1] ^ branch.signFlip] + row) /
+                              branch.gridRows * imageSize;
+                candidate.w = branch.exp[box[2] ^ branch.signFlip] * branch.anchors[anchor * 2] /
+                              this->m_params.inputImgCols * imageSize;
+                candidate.h = branch.exp[box[3] ^ branch.signFlip] *
+                              branch.anchors[anchor * 2 + 1] / this->m_params.inputImgRows *
+                              imageSize;
+                candidate.objectness = objectness;
+                candidate.probs      = this->m_probs.size();
+
+                for (int c = 0; c < numClasses; ++c) {
+                    const float prob = branch.sigmoid[box[5 + c] ^ branch.signFlip] * objectness;
+                    this->m_probs.push_back(prob > threshold ? prob : 0.f);
+                }
+                this->m_candidates.push_back(candidate);
+            }
+        }
+    }
+
+    /** Intersection over union of two boxes given by their centre and size. */
+    static float BoxIou(float x0, float y0, float w0, float h0,
+                        float x1, float y1, float w1, float h1)
+    {
+        const float w = std::min(x0 + w0 / 2, x1 + w1 / 2) - std::max(x0 - w0 / 2, x1 - w1 / 2);
+        const float h = std::min(y0 + h0 / 2, y1 + h1 / 2) - std::max(y0 - h0 / 2, y1 - h1 / 2);
+        if (w <= 0 || h <= 0) {
+            return 0;
+        }
+        const float intersection = w * h;
+        const float unionArea    = w0 * h0 + w1 * h1 - intersection;
+        return unionArea > 0 ? intersection / unionArea : 0;
+    }
+
+    void QuantizedDetectorPostProcess::Suppress()
+    {
+        /* Latest first, as DetectorPostProcess lists them: equal scores suppress alike. */
+        std::vector<size_t>& order = this->m_order;
+        order.resize(this->m_candidates.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = order.size() - 1 - i;
+        }
+
+        for (int c = 0; c < this->m_params.numClasses; ++c) {
+            auto prob = [this, c](size_t i) -> float& {
+                return this->m_probs[this->m_candidates[i].probs + c];
+            };
+            std::stable_sort(order.begin(), order.end(), [&prob](size_t a, size_t b) {
+                return prob(a) > prob(b);
+            });
+
+            for (size_t i = 0; i < order.size(); ++i) {
+                if (prob(order[i]) == 0) {
+                    continue;
+                }
+                const Candidate& best = this->m_candidates[order[i]];
+                for (size_t j = i + 1; j < order.size(); ++j) {
+                    const Candidate& other = this->m_candidates[order[j]];
+                    if (prob(order[j]) > 0 &&
+                        BoxIou(best.x, best.y, best.w, best.h,
+                               other.x, other.y, other.w, other.h) > this->m_params.nms) {
+                        prob(order[j]) = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    bool QuantizedDetectorPostProcess::DoPostProcess()
+    {
+        if (!this->m_valid) {
+            printf_err("Output tensors are not quantized YOLO grids\n");
+            return false;
+        }
+
+        this->m_candidates.clear();
+        this->m_probs.clear();
+        for (const Branch& branch : this->m_branches) {
+            this->Decode(branch);
+        }
+
+        /* Keep the topN most likely objects, as DetectorPostProcess does. */
+        const size_t topN = this->m_params.topN > 0 ? this->m_params.topN : 0;
+        if (topN && this->m_candidates.size() > topN) {
+            std::partial_sort(this->m_candidates.begin(),
+                              this->m_candidates.begin() + topN,
+                              this->m_candidates.end(),
+                              [](const Candidate& a, const Candidate& b) {
+                                  return a.objectness > b.objectness;
+                              });
+            this->m_candidates.resize(topN);
+        }
+
+        this->Suppress();
+
+        const float imageSize = this->m_params.originalImageSize;
+        for (const size_t i : this->m_order) {
+            const Candidate& candidate = this->m_candidates[i];
+            const float xMin = std::max(0.f, candidate.x - candidate.w / 2);
+            const float yMin = std::max(0.f, candidate.y - candidate.h / 2);
+            const float xMax = std::min(imageSize, candidate.x + candidate.w / 2);
+            const float yMax = std::min(imageSize, candidate.y + candidate.h / 2);
+
+            for (int c = 0; c < this->m_params.numClasses; ++c) {
+                const float prob = this->m_probs[candidate.probs + c];
+                if (prob > 0) {
+                    object_detection::DetectionResult result = {};
+                    result.m_normalisedVal = prob;
+                    result.m_x0            = static_cast<int>(xMin);
+                    result.m_y0            = static_cast<int>(yMin);
+                    result.m_w             = static_cast<int>(xMax - xMin);
+                    result.m_h             = static_cast<int>(yMax - yMin);
+                    this->m_results.push_back(result);
+                }
+            }
+        }
+        return true;
+    }
+
+} /* namespace app */
+} /* namespace arm */
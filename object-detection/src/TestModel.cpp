@@ -16,7 +16,7 @@
  */
 #include "TestModel.hpp"
 #include "log_macros.h"
-#include "MicroMutableAllOpsResolver.hpp"
+#include "OpResolverCheck.hpp"
 
 const tflite::MicroOpResolver& arm::app::TestModel::GetOpResolver()
 {
@@ -25,6 +25,17 @@ const tflite::MicroOpResolver& arm::app::TestModel::GetOpResolver()
 
 bool arm::app::TestModel::EnlistOperations()
 {
+#if defined(USE_MODEL_OP_RESOLVER)
+   this->m_opResolver = CreateModelOpResolver();
+#else
    this->m_opResolver = CreateAllOpsResolver();
+#endif /* defined(USE_MODEL_OP_RESOLVER) */
    return true;
 }
+
+bool arm::app::TestModel::CheckOperators(const uint8_t* modelData)
+{
+   /* Init() enlists the operations again; the resolver is simply replaced. */
+   this->EnlistOperations();
+   return CheckOpResolver(this->m_opResolver, modelData);
+}
@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TiledDetection.hpp"
+
+#include <algorithm>
+
+namespace arm {
+namespace app {
+
+    /** Even start positions of tiles along one axis, evenly spread so that
+     *  neighbours overlap by at least minOverlap. */
+    static std::vector<uint32_t> TilePositions(uint32_t frame, uint32_t tile, uint32_t minOverlap)
+    {
+        std::vector<uint32_t> positions;
+        if (frame <= tile) {
+            return positions;
+        }
+
+        /* Debayering reads one pixel past the last one of the tile. */
+        const uint32_t span   = frame - tile - 1;
+        const uint32_t stride = tile > minOverlap ? tile - minOverlap : 1;
+        const uint32_t count  = (span + stride - 1) / stride + 1;
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t position = count > 1 ? span * i / (count - 1) : 0;
+            positions.push_back(position & ~1U);
+        }
+        return positions;
+    }
+
+    TiledDetection::TiledDetection(uint32_t frameWidth,
+                                   uint32_t frameHeight,
+                                   uint32_t tileWidth,
+                                   uint32_t tileHeight,
+                                   uint32_t minOverlap)
+    {
+        const std::vector<uint32_t> xs = TilePositions(frameWidth, tileWidth, minOverlap);
+        const std::vector<uint32_t> ys = TilePositions(frameHeight, tileHeight, minOverlap);
+        for (const uint32_t y : ys) {
+            for (const uint32_t x : xs) {
+                this->m_tiles.push_back(Tile{x, y});
+            }
+        }
+        this->m_results.resize(this->m_tiles.size());
+    }
+
+    size_t TiledDetection::GetNumTiles() const
+    {
+        return this->m_tiles.size();
+    }
+
+    const TiledDetection::Tile& TiledDetection::GetTile(size_t index) const
+    {
+        return this->m_tiles[index];
+    }
+
+    void TiledDetection::BeginFrame(uint32_t budgetTicks)
+    {
+        this->m_budget = budgetTicks;
+        this->m_spent  = 0;
+        this->m_run    = 0;
+    }
+
+    bool TiledDetection::NextTile(size_t& index)
+    {
+        if (this->m_run >= this->m_tiles.size()) {
+            return false;
+        }
+        /* Stop before a tile, at its usual time, would overrun the budget. */
+        if (this->m_run && this->m_budget && this->m_spent + this->m_tileTicks > this->m_budget) {
+            return false;
+        }
+        index        = this->m_next;
+        this->m_next = (this->m_next + 1) % this->m_tiles.size();
+        return true;
+    }
+
+    void TiledDetection::EndTile(size_t index,
+                                 uint32_t ticks,
+                                 const std::vector<Result>& tileResults)
+    {
+        ++this->m_run;
+        this->m_spent += ticks;
+        this->m_tileTicks = this->m_tileTicks ? (3 * this->m_tileTicks + ticks) / 4 : ticks;
+
+        const Tile& tile              = this->m_tiles[index];
+        std::vector<Result>& results = this->m_results[index];
+        results = tileResults;
+        for (auto& result : results) {
+            result.m_x0 += tile.x;
+            result.m_y0 += tile.y;
+        }
+    }
+
+    /** Area of the intersection of two boxes. */
+    static int64_t Intersection(const TiledDetection::Result& a, const TiledDetection::Result& b)
+    {
+        const int64_t w = std::min(a.m_x0 + a.m_w, b.m_x0 + b.m_w) - std::max(a.m_x0, b.m_x0);
+        const int64_t h = std::min(a.m_y0 + a.m_h, b.m_y0 + b.m_h) - std::max(a.m_y0, b.m_y0);
+        return w > 0 && h > 0 ? w * h : 0;
+    }
+
+    void TiledDetection::Merge(std::vector<Result>& results, float iouThreshold) const
+    {
+        std::vector<Result> candidates;
+        for (const auto& tileResults : this->m_results) {
+            candidates.insert(candidates.end(), tileResults.begin(), tileResults.end());
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Result& a, const Result& b) {
+            return a.m_normalisedVal > b.m_normalisedVal;
+        });
+
+        results.clear();
+        for (const auto& candidate : candidates) {
+            const int64_t area = static_cast<int64_t>(candidate.m_w) * candidate.m_h;
+            bool keep          = true;
+            for (const auto& kept : results) {
+                const int64_t keptArea     = static_cast<int64_t>(kept.m_w) * kept.m_h;
+                const int64_t intersection = Intersection(candidate, kept);
+                const int64_t smaller      = std::min(area, keptArea);
+                if (intersection > iouThreshold * (area + keptArea - intersection) ||
+                    (smaller && intersection > ms_containedThreshold * smaller)) {
+                    keep = false;
+                    break;
+                }
+            }
+            if (keep) {
+                results.push_back(candidate);
+            }
+        }
+    }
+
+    size_t TiledDetection::GetTilesRun() const
+    {
+        return this->m_run;
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -28,11 +28,16 @@
 #include "Classifier.hpp"    /* Classifier for the result */
 #include "DetectionResult.hpp"
 #include "DetectorPostProcessing.hpp" /* Post Process */
+#include "QuantizedDetectorPostProcess.hpp" /* Post Process in the quantized domain */
 #include "DetectorPreProcessing.hpp"  /* Pre Process */
 #include "YoloFastestModel.hpp"       /* Model API */
 #include "CameraCapture.hpp"          /* Live camera capture API */
 #include "LcdDisplay.hpp"             /* LCD display */
 #include "GpioSignal.hpp"             /* GPIO signals to drive LEDs */
+#include "OverlappedInference.hpp"    /* Overlaps debayering with the NPU */
+#include "TiledDetection.hpp"         /* Detection over the whole frame */
+#include "BoxTracker.hpp"             /* Boxes between detector runs */
+#include "time_base.h"                /* Time spent on the tiles */
 
 /* Platform dependent files */
 #include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
@@ -40,18 +45,71 @@
 #include "BoardInit.hpp"      /* Board initialisation */
 #include "log_macros.h"      /* Logging macros (optional) */
 
+#include <algorithm>
+
 
 #define CROPPED_IMAGE_WIDTH     192
 #define CROPPED_IMAGE_HEIGHT    192
 #define CROPPED_IMAGE_SIZE      (CROPPED_IMAGE_WIDTH * CROPPED_IMAGE_HEIGHT * 3)
 
+/* Rows debayered per slice of work done while the NPU runs; must be even. */
+#define DEBAYER_SLICE_ROWS      8
+
+#if defined(OBJECT_TRACKING)
+/* The detector runs on one frame in this many; the tracker predicts the boxes of the others. */
+#if !defined(OBJECT_TRACKING_DETECT_INTERVAL)
+#define OBJECT_TRACKING_DETECT_INTERVAL     3
+#endif /* !defined(OBJECT_TRACKING_DETECT_INTERVAL) */
+
+/* Smallest IoU of a detection with the predicted box of the track it continues. */
+#if !defined(OBJECT_TRACKING_IOU)
+#define OBJECT_TRACKING_IOU                 0.3f
+#endif /* !defined(OBJECT_TRACKING_IOU) */
+
+/* Detector runs a track may go unmatched before it is dropped. */
+#if !defined(OBJECT_TRACKING_MAX_MISSES)
+#define OBJECT_TRACKING_MAX_MISSES          2
+#endif /* !defined(OBJECT_TRACKING_MAX_MISSES) */
+
+/* Detections a track needs before its box is drawn. */
+#if !defined(OBJECT_TRACKING_MIN_HITS)
+#define OBJECT_TRACKING_MIN_HITS            2
+#endif /* !defined(OBJECT_TRACKING_MIN_HITS) */
+#endif /* defined(OBJECT_TRACKING) */
+
+#if defined(TILED_DETECTION)
+/* Smallest overlap of neighbouring tiles, in camera pixels. */
+#if !defined(TILED_DETECTION_OVERLAP)
+#define TILED_DETECTION_OVERLAP     32
+#endif /* !defined(TILED_DETECTION_OVERLAP) */
+
+/* Time the tiles of a frame may take; 0 to run every tile on every frame. */
+#if !defined(TILED_DETECTION_BUDGET_MS)
+#define TILED_DETECTION_BUDGET_MS   0
+#endif /* !defined(TILED_DETECTION_BUDGET_MS) */
+
+/* IoU above which the NMS over the whole frame merges two boxes. */
+#if !defined(TILED_DETECTION_NMS_IOU)
+#define TILED_DETECTION_NMS_IOU     0.45f
+#endif /* !defined(TILED_DETECTION_NMS_IOU) */
+
+/* The LCD shows the whole frame downscaled by this even factor. */
+#if !defined(TILED_PREVIEW_SCALE)
+#define TILED_PREVIEW_SCALE         4
+#endif /* !defined(TILED_PREVIEW_SCALE) */
+
+#define TILED_PREVIEW_WIDTH     (CAMERA_FRAME_WIDTH / TILED_PREVIEW_SCALE)
+#define TILED_PREVIEW_HEIGHT    (CAMERA_FRAME_HEIGHT / TILED_PREVIEW_SCALE)
+#endif /* defined(TILED_DETECTION) */
+
 namespace arm {
 namespace app {
     /* Tensor arena buffer */
     static uint8_t tensorArena[ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
 
-    /* RGB image buffer - cropped/scaled version of the original + debayered. */
-    static uint8_t rgbImage[CROPPED_IMAGE_SIZE] __attribute__((section("rgb_buf"), aligned(16)));
+    /* RGB image buffers - cropped/scaled version of the original + debayered.
+     * One is being inferred and displayed while the next frame fills the other. */
+    static uint8_t rgbImage[2][CROPPED_IMAGE_SIZE] __attribute__((section("rgb_buf"), aligned(16)));
 
     /* RAW image buffer. */
     static uint8_t rawImage[CAMERA_IMAGE_RAW_SIZE] __attribute__((section("raw_buf"), aligned(16)));
@@ -59,6 +117,14 @@ namespace app {
     /* LCD image buffer */
     static uint8_t lcdImage[DIMAGE_Y][DIMAGE_X][RGB_BYTES] __attribute__((section("lcd_buf"), aligned(16)));
 
+#if defined(TILED_DETECTION)
+    /* Downscaled whole frame the boxes are drawn on, and the same rotated for the LCD. */
+    static uint8_t previewImage[TILED_PREVIEW_WIDTH * TILED_PREVIEW_HEIGHT * RGB_BYTES]
+        __attribute__((section("rgb_buf"), aligned(16)));
+    static uint8_t previewRotated[TILED_PREVIEW_HEIGHT * TILED_PREVIEW_WIDTH * RGB_BYTES]
+        __attribute__((section("rgb_buf"), aligned(16)));
+#endif /* defined(TILED_DETECTION) */
+
     /* Optional getter function for the model pointer and its size. */
     namespace object_detection {
         extern uint8_t* GetModelPointer();
@@ -69,6 +135,20 @@ namespace app {
 
 typedef arm::app::object_detection::DetectionResult OdResults;
 
+#if defined(OBJECT_TRACKING)
+/**
+ * @brief Draws the boxes of the tracks in the image.
+ *
+ * @param[out] rgbImage     Pointer to the start of the image.
+ * @param[in]  width        Image width.
+ * @param[in]  height       Image height.
+ * @param[in]  tracks       Boxes and IDs of the tracks.
+ */
+static void DrawTrackedBoxes(uint8_t* rgbImage,
+                             const uint32_t imageWidth,
+                             const uint32_t imageHeight,
+                             const std::vector<arm::app::BoxTracker::TrackedBox>& tracks);
+#else
 /**
  * @brief Draws a boxes in the image using the object detection results vector.
  *
@@ -81,6 +161,54 @@ static void DrawDetectionBoxes(uint8_t* rgbImage,
                                const uint32_t imageWidth,
                                const uint32_t imageHeight,
                                const std::vector<OdResults>& results);
+#endif /* defined(OBJECT_TRACKING) */
+
+/** Next camera frame, prepared while the NPU runs the current one. */
+struct FrameJob {
+    uint8_t* rgbImage;  /* Destination RGB buffer. */
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t nextRow;   /* Next row to debayer. */
+    bool captured;      /* Raw frame received and visible to the CPU. */
+    bool failed;
+};
+
+/**
+ * @brief   Polls for the raw frame, debayers it a few rows at a time into the
+ *          job's RGB buffer, then starts capturing the following frame. Runs
+ *          as OverlappedInference overlap work.
+ * @param[in]   arg     FrameJob.
+ * @return      true while more work remains.
+ */
+static bool PrepareNextFrame(void* arg);
+
+#if defined(TILED_DETECTION)
+/** Preview of the whole frame, debayered while the NPU runs the tiles. */
+struct PreviewJob {
+    uint8_t* rgbImage;  /* TILED_PREVIEW_WIDTH x TILED_PREVIEW_HEIGHT RGB buffer. */
+    uint32_t nextRow;   /* Next row to debayer. */
+    bool failed;
+};
+
+/**
+ * @brief   Debayers a few rows of the preview. Runs as OverlappedInference overlap
+ *          work.
+ * @param[in]   arg     PreviewJob.
+ * @return      true while more work remains.
+ */
+static bool PreparePreview(void* arg);
+
+/**
+ * @brief   Runs the detector over the whole camera frame, tile by tile, and
+ *          shows the merged detections on a downscaled preview. Does not
+ *          return unless something fails.
+ * @return  Error code for main.
+ */
+static int RunTiledDetection(arm::app::YoloFastestModel& model,
+                             arm::app::QuantizedDetectorPostProcess& postProcess,
+                             std::vector<OdResults>& results,
+                             arm::app::GpioSignal& statusLED);
+#endif /* defined(TILED_DETECTION) */
 
 #if defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
 __asm("  .global __ARM_use_no_argv\n");
@@ -91,11 +219,18 @@ int main()
     /* Initialise the UART module to allow printf related functions (if using retarget) */
     BoardInit();
 
+    const uint8_t* modelData = arm::app::object_detection::GetModelPointer();
+    if (!modelData) {
+        /* A compressed model (ModelCompression.hpp) that failed to expand. */
+        printf_err("No model\n");
+        return 1;
+    }
+
     /* Model object creation and initialisation. */
     arm::app::YoloFastestModel model;
     if (!model.Init(arm::app::tensorArena,
                     sizeof(arm::app::tensorArena),
-                    arm::app::object_detection::GetModelPointer(),
+                    modelData,
                     arm::app::object_detection::GetModelLen())) {
         printf_err("Failed to initialise model\n");
         return 1;
@@ -131,8 +266,10 @@ int main()
         arm::app::object_detection::originalImageSize,
         arm::app::object_detection::anchor1,
         arm::app::object_detection::anchor2};
-    arm::app::DetectorPostProcess postProcess =
-        arm::app::DetectorPostProcess(outputTensor0, outputTensor1, results, postProcessParams);
+    /* Same detections as DetectorPostProcess, but only the cells above the threshold are
+     * dequantized and decoded. */
+    arm::app::QuantizedDetectorPostProcess postProcess(
+        outputTensor0, outputTensor1, results, postProcessParams);
 
     const size_t imgSz = inputTensor->bytes < CROPPED_IMAGE_SIZE ?
                          inputTensor->bytes : CROPPED_IMAGE_SIZE;
@@ -142,7 +279,7 @@ int main()
         return 2;
     }
 
-    if (sizeof(arm::app::rgbImage) < imgSz) {
+    if (sizeof(arm::app::rgbImage[0]) < imgSz) {
         printf_err("RGB buffer is insufficient\n");
         return 3;
     }
@@ -155,65 +292,97 @@ int main()
                                     arm::app::SignalPin::LED1_Green,
                                     arm::app::SignalDirection::DirectionOutput};
 
-    /* Start the camera */
+#if defined(TILED_DETECTION)
+    return RunTiledDetection(model, postProcess, results, statusLED);
+#endif /* defined(TILED_DETECTION) */
+
+    /* Start the camera and prepare the first frame. */
     arm::app::CameraCaptureStart(arm::app::rawImage);
-    arm::app::CameraCaptureWaitForFrame();
 
-    auto dstPtr = static_cast<uint8_t*>(inputTensor->data.uint8);
+    FrameJob job{arm::app::rgbImage[0],
+                 static_cast<uint32_t>(inputImgCols),
+                 static_cast<uint32_t>(inputImgRows)};
+    while (PrepareNextFrame(&job)) {
+    }
 
+    arm::app::OverlappedInference inference;
     uint32_t imgCount = 0;
 
+#if defined(OBJECT_TRACKING)
+    arm::app::BoxTracker tracker(inputImgCols,
+                                 inputImgRows,
+                                 OBJECT_TRACKING_IOU,
+                                 OBJECT_TRACKING_MAX_MISSES,
+                                 OBJECT_TRACKING_MIN_HITS);
+    std::vector<arm::app::BoxTracker::TrackedBox> tracks;
+#endif /* defined(OBJECT_TRACKING) */
+
     while (true) {
         results.clear();
 
-        arm::app::CameraCaptureWaitForFrame();
-        RTSS_InvalidateDCache_by_Addr(arm::app::rawImage, sizeof(arm::app::rawImage));
-
-        auto debayerState = arm::app::CropAndDebayer(
-                                arm::app::rawImage,
-                                CAMERA_FRAME_WIDTH,
-                                CAMERA_FRAME_HEIGHT,
-                                (CAMERA_FRAME_WIDTH - inputImgCols)/2,
-                                (CAMERA_FRAME_HEIGHT - inputImgRows)/2,
-                                arm::app::rgbImage,
-                                inputImgCols,
-                                inputImgRows,
-                                arm::app::ColourFilter::GRBG);
-
-        if (!debayerState) {
+        if (job.failed) {
             printf_err("Debayering failed\n");
             return 1;
         }
+        uint8_t* const rgbImage = job.rgbImage;
 
-        arm::app::CameraCaptureStart(arm::app::rawImage);
+#if defined(OBJECT_TRACKING)
+        const bool detect = imgCount % OBJECT_TRACKING_DETECT_INTERVAL == 0;
+#else
+        const bool detect = true;
+#endif /* defined(OBJECT_TRACKING) */
 
         /* Run the pre-processing, inference and post-processing. */
-        if (!preProcess.DoPreProcess(arm::app::rgbImage, imgSz)) {
+        if (detect && !preProcess.DoPreProcess(rgbImage, imgSz)) {
             printf_err("Pre-processing failed.\n");
             return 1;
         }
 
-        /* Run inference over this image. */
         printf("\rImage %" PRIu32 "; ", ++imgCount);
 
-        statusLED.Send(true);
-        if (!model.RunInference()) {
-            printf_err("Inference failed.\n");
+        job = FrameJob{rgbImage == arm::app::rgbImage[0] ? arm::app::rgbImage[1]
+                                                         : arm::app::rgbImage[0],
+                       job.cols,
+                       job.rows};
+
+        if (detect) {
+            /* Run inference over this image while the next one is debayered. */
+            statusLED.Send(true);
+            inference.Overlap(PrepareNextFrame, &job);
+            if (!inference.Run(model)) {
+                printf_err("Inference failed.\n");
+                statusLED.Send(false);
+                return 2;
+            }
             statusLED.Send(false);
-            return 2;
+            debug("Overlapped %" PRIu32 " cycles of debayering, %" PRIu32 " cycles idle\n",
+                  inference.GetOverlappedCycles(),
+                  inference.GetIdleCycles());
+
+            if (!postProcess.DoPostProcess()) {
+                printf_err("Post-processing failed.\n");
+                return 3;
+            }
+        } else {
+            /* No inference to overlap with: prepare the next frame straight away. */
+            while (PrepareNextFrame(&job)) {
+            }
         }
-        statusLED.Send(false);
 
-        if (!postProcess.DoPostProcess()) {
-            printf_err("Post-processing failed.\n");
-            return 3;
+#if defined(OBJECT_TRACKING)
+        tracker.Predict();
+        if (detect) {
+            tracker.Update(results);
         }
+        tracker.GetBoxes(tracks);
+        DrawTrackedBoxes(rgbImage, inputImgCols, inputImgRows, tracks);
+#else
+        DrawDetectionBoxes(rgbImage, inputImgCols, inputImgRows, results);
+#endif /* defined(OBJECT_TRACKING) */
 
-        DrawDetectionBoxes(arm::app::rgbImage, inputImgCols, inputImgRows, results);
+        arm::app::RotateClockwise90(rgbImage, inputImgCols, inputImgRows);
 
-        arm::app::RotateClockwise90(arm::app::rgbImage, inputImgCols, inputImgRows);
-
-        arm::app::LcdDisplayImage(arm::app::rgbImage,
+        arm::app::LcdDisplayImage(rgbImage,
                          inputImgCols,
                          inputImgRows,
                          arm::app::ColourFormat::BGR,
@@ -224,6 +393,42 @@ int main()
     return 0;
 }
 
+static bool PrepareNextFrame(void* arg)
+{
+    FrameJob* const job = static_cast<FrameJob*>(arg);
+
+    if (!job->captured) {
+        /* Slices must not block: poll until the frame has arrived. */
+        if (!arm::app::CameraCaptureIsFrameReady()) {
+            return true;
+        }
+        arm::app::CameraCaptureWaitForFrame(); /* Reports camera errors. */
+        RTSS_InvalidateDCache_by_Addr(arm::app::rawImage, sizeof(arm::app::rawImage));
+        job->captured = true;
+        return true;
+    }
+
+    if (job->nextRow < job->rows && !job->failed) {
+        const uint32_t rows = std::min<uint32_t>(DEBAYER_SLICE_ROWS, job->rows - job->nextRow);
+        job->failed = !arm::app::CropAndDebayer(
+                          arm::app::rawImage,
+                          CAMERA_FRAME_WIDTH,
+                          CAMERA_FRAME_HEIGHT,
+                          (CAMERA_FRAME_WIDTH - job->cols)/2,
+                          (CAMERA_FRAME_HEIGHT - job->rows)/2 + job->nextRow,
+                          job->rgbImage + job->nextRow * job->cols * 3,
+                          job->cols,
+                          rows,
+                          arm::app::ColourFilter::GRBG);
+        job->nextRow += rows;
+        return true;
+    }
+
+    /* The raw buffer is free again. */
+    arm::app::CameraCaptureStart(arm::app::rawImage);
+    return false;
+}
+
 /**
  * @brief Draws a box in the image using the object detection result object.
  *
@@ -268,6 +473,23 @@ static void DrawBox(uint8_t* imageData,
     }
 }
 
+#if defined(OBJECT_TRACKING)
+static void DrawTrackedBoxes(uint8_t* rgbImage,
+                             const uint32_t imageWidth,
+                             const uint32_t imageHeight,
+                             const std::vector<arm::app::BoxTracker::TrackedBox>& tracks)
+{
+    for (const auto& track : tracks) {
+        DrawBox(rgbImage, imageWidth, imageHeight, track.box);
+        printf("Track %" PRIu32 " :: [%d, %d, %d, %d]\n",
+               track.id,
+               track.box.m_x0,
+               track.box.m_y0,
+               track.box.m_w,
+               track.box.m_h);
+    }
+}
+#else
 static void DrawDetectionBoxes(uint8_t* rgbImage,
                                const uint32_t imageWidth,
                                const uint32_t imageHeight,
@@ -283,3 +505,170 @@ static void DrawDetectionBoxes(uint8_t* rgbImage,
                 result.m_h);
     }
 }
+#endif /* defined(OBJECT_TRACKING) */
+
+#if defined(TILED_DETECTION)
+static bool PreparePreview(void* arg)
+{
+    PreviewJob* const job = static_cast<PreviewJob*>(arg);
+
+    if (job->nextRow < TILED_PREVIEW_HEIGHT && !job->failed) {
+        const uint32_t rows =
+            std::min<uint32_t>(DEBAYER_SLICE_ROWS, TILED_PREVIEW_HEIGHT - job->nextRow);
+        job->failed = !arm::app::DownscaleAndDebayer(arm::app::rawImage,
+                                                     CAMERA_FRAME_WIDTH,
+                                                     CAMERA_FRAME_HEIGHT,
+                                                     TILED_PREVIEW_SCALE,
+                                                     job->rgbImage,
+                                                     job->nextRow,
+                                                     rows,
+                                                     arm::app::ColourFilter::GRBG);
+        job->nextRow += rows;
+        return true;
+    }
+    return false;
+}
+
+static int RunTiledDetection(arm::app::YoloFastestModel& model,
+                             arm::app::QuantizedDetectorPostProcess& postProcess,
+                             std::vector<OdResults>& results,
+                             arm::app::GpioSignal& statusLED)
+{
+    uint8_t* const preview = arm::app::previewImage;
+
+    TfLiteTensor* inputTensor  = model.GetInputTensor(0);
+    TfLiteIntArray* inputShape = model.GetInputShape(0);
+    const uint32_t tileCols = inputShape->data[arm::app::YoloFastestModel::ms_inputColsIdx];
+    const uint32_t tileRows = inputShape->data[arm::app::YoloFastestModel::ms_inputRowsIdx];
+    const uint32_t channels = inputTensor->bytes / (tileCols * tileRows);
+    if (channels != 1 && channels != 3) {
+        printf_err("Unsupported input of %" PRIu32 " channels\n", channels);
+        return 1;
+    }
+
+    arm::app::TiledDetection tiles(
+        CAMERA_FRAME_WIDTH, CAMERA_FRAME_HEIGHT, tileCols, tileRows, TILED_DETECTION_OVERLAP);
+    if (!tiles.GetNumTiles()) {
+        printf_err("Camera frame is smaller than the model input\n");
+        return 3;
+    }
+    const uint32_t budgetTicks = static_cast<uint32_t>(
+        static_cast<uint64_t>(TILED_DETECTION_BUDGET_MS) * time_base_ticks_per_second() / 1000);
+    info("Tiled detection: %zu tiles of %" PRIu32 "x%" PRIu32 " over %dx%d, %d ms per frame\n",
+         tiles.GetNumTiles(),
+         tileCols,
+         tileRows,
+         CAMERA_FRAME_WIDTH,
+         CAMERA_FRAME_HEIGHT,
+         TILED_DETECTION_BUDGET_MS);
+
+    arm::app::OverlappedInference inference;
+    std::vector<OdResults> frameResults;
+    uint32_t imgCount = 0;
+
+    while (true) {
+        /* The raw frame is read until the last tile: no capture meanwhile. */
+        arm::app::CameraCaptureStart(arm::app::rawImage);
+        arm::app::CameraCaptureWaitForFrame();
+        RTSS_InvalidateDCache_by_Addr(arm::app::rawImage, sizeof(arm::app::rawImage));
+        printf("\rImage %" PRIu32 "; ", ++imgCount);
+
+        PreviewJob previewJob{preview};
+        tiles.BeginFrame(budgetTicks);
+        size_t index;
+        while (tiles.NextTile(index)) {
+            const uint32_t tileStart = time_base_ticks();
+            const arm::app::TiledDetection::Tile& tile = tiles.GetTile(index);
+
+            /* The input tensor is free between inferences: debayer straight into it. */
+            const bool debayered =
+                channels == 3 ? arm::app::CropAndDebayer(arm::app::rawImage,
+                                                         CAMERA_FRAME_WIDTH,
+                                                         CAMERA_FRAME_HEIGHT,
+                                                         tile.x,
+                                                         tile.y,
+                                                         inputTensor->data.uint8,
+                                                         tileCols,
+                                                         tileRows,
+                                                         arm::app::ColourFilter::GRBG)
+                              : arm::app::CropAndDebayerToGray(arm::app::rawImage,
+                                                               CAMERA_FRAME_WIDTH,
+                                                               CAMERA_FRAME_HEIGHT,
+                                                               tile.x,
+                                                               tile.y,
+                                                               inputTensor->data.uint8,
+                                                               tileCols,
+                                                               tileRows,
+                                                               arm::app::ColourFilter::GRBG);
+            if (!debayered) {
+                printf_err("Debayering failed\n");
+                return 1;
+            }
+            if (model.IsDataSigned()) {
+                for (size_t i = 0; i < inputTensor->bytes; ++i) {
+                    inputTensor->data.uint8[i] ^= 0x80;
+                }
+            }
+
+            statusLED.Send(true);
+            inference.Overlap(PreparePreview, &previewJob);
+            if (!inference.Run(model)) {
+                printf_err("Inference failed.\n");
+                statusLED.Send(false);
+                return 2;
+            }
+            statusLED.Send(false);
+
+            /* Boxes in tile coordinates: the post-processing scales to the input size. */
+            results.clear();
+            if (!postProcess.DoPostProcess()) {
+                printf_err("Post-processing failed.\n");
+                return 3;
+            }
+            tiles.EndTile(index, time_base_ticks() - tileStart, results);
+        }
+
+        /* Finish the preview if the tiles did not leave time for all of it. */
+        while (PreparePreview(&previewJob)) {
+        }
+        if (previewJob.failed) {
+            printf_err("Debayering failed\n");
+            return 1;
+        }
+
+        tiles.Merge(frameResults, TILED_DETECTION_NMS_IOU);
+        debug("%zu of %zu tiles run\n", tiles.GetTilesRun(), tiles.GetNumTiles());
+
+        for (const auto& result : frameResults) {
+            printf("Detection :: [%d, %d, %d, %d]\n",
+                   result.m_x0,
+                   result.m_y0,
+                   result.m_w,
+                   result.m_h);
+
+            /* The box on the preview, kept inside it. */
+            OdResults box = result;
+            box.m_x0 = std::min(result.m_x0 / TILED_PREVIEW_SCALE, TILED_PREVIEW_WIDTH - 1);
+            box.m_y0 = std::min(result.m_y0 / TILED_PREVIEW_SCALE, TILED_PREVIEW_HEIGHT - 1);
+            box.m_w  = std::min(result.m_w / TILED_PREVIEW_SCALE,
+                                TILED_PREVIEW_WIDTH - 1 - box.m_x0);
+            box.m_h  = std::min(result.m_h / TILED_PREVIEW_SCALE,
+                                TILED_PREVIEW_HEIGHT - 1 - box.m_y0);
+            DrawBox(preview, TILED_PREVIEW_WIDTH, TILED_PREVIEW_HEIGHT, box);
+        }
+
+        /* Not square, so rotated out of place: as wide as the frame was high. */
+        arm::app::RotateClockwise90(
+            preview, arm::app::previewRotated, TILED_PREVIEW_WIDTH, TILED_PREVIEW_HEIGHT);
+
+        arm::app::LcdDisplayImage(arm::app::previewRotated,
+                                  TILED_PREVIEW_HEIGHT,
+                                  TILED_PREVIEW_WIDTH,
+                                  arm::app::ColourFormat::BGR,
+                                  (DIMAGE_X - TILED_PREVIEW_HEIGHT) / 2,
+                                  (DIMAGE_Y - TILED_PREVIEW_WIDTH) / 2);
+    }
+
+    return 0;
+}
+#endif /* defined(TILED_DETECTION) */
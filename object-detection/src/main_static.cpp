@@ -25,29 +25,95 @@
  * some heap for the API runtime.
  */
 #include "BufAttributes.hpp" /* Buffer attributes to be applied */
+#include <cinttypes>
 #include <random>
+#include <vector>
 #include "TestModel.hpp"
+#include "OperatorProfiler.hpp"
+#include "ArenaUsage.hpp"
+#include "BenchmarkStats.hpp"
+#include "GoldenOutput.hpp"
+#include "InputFiles.hpp"
+#include "ModelStaging.hpp"
+#include "ModelVariants.hpp"
+#if defined(MULTI_MODEL_CHECK) || defined(MODEL_VARIANTS_CHECK)
+#include "MultiModelRuntime.hpp"
+#endif /* defined(MULTI_MODEL_CHECK) || defined(MODEL_VARIANTS_CHECK) */
 
 /* Platform dependent files */
 #include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
 #include CMSIS_device_header /* Gives us IRQ num, base addresses. */
 #include "BoardInit.hpp"      /* Board initialisation */
 #include "log_macros.h"      /* Logging macros (optional) */
+#if defined(HOST_BUILD)
+#include "host_files.h"      /* File inputs and outputs of the host build */
+#else  /* defined(HOST_BUILD) */
 #include "board.h"
 #include "app_map.h"
 #include "global_map.h"
 #include "Driver_GPIO.h"
 #include "pinconf.h"
+#endif /* defined(HOST_BUILD) */
+#include "tensorflow/lite/micro/micro_time.h"
+#include "time_base.h"
+#if defined(OSPI_XIP_BENCHMARK)
+#include "ospi_xip_bench.h"
+#endif /* defined(OSPI_XIP_BENCHMARK) */
+#if defined(MODEL_SLOTS)
+#include "ModelUpdate.hpp"
+#endif /* defined(MODEL_SLOTS) */
+#if defined(ARM_NPU)
+#include "ethosu_cpu_cache.h"
+#include "ethosu_npu_pmu.h"
+#include "ethosu_mem_policy.h"
+#endif /* defined(ARM_NPU) */
+
+/* Seed of the noise input: the same seed gives the same input on every build. */
+#if !defined(BENCHMARK_SEED)
+#define BENCHMARK_SEED      (1)
+#endif /* !defined(BENCHMARK_SEED) */
+
+/* Untimed inferences before the BENCHMARK_ITERATIONS timed ones. */
+#if !defined(BENCHMARK_WARMUP)
+#define BENCHMARK_WARMUP    (2)
+#endif /* !defined(BENCHMARK_WARMUP) */
+
+/* Side of the sample image im0 (InputFiles.cpp), square and interleaved RGB. */
+#define SAMPLE_IMAGE_SIDE   (192)
+static_assert(SAMPLE_IMAGE_SIDE * SAMPLE_IMAGE_SIDE * 3 == IMAGE_DATA_SIZE,
+              "im0 is not a square RGB image of SAMPLE_IMAGE_SIDE");
+
+/* Largest error of an output element accepted by GOLDEN_OUTPUT_CHECK: bit-exact by default. */
+#if !defined(GOLDEN_OUTPUT_TOLERANCE)
+#define GOLDEN_OUTPUT_TOLERANCE (0)
+#endif /* !defined(GOLDEN_OUTPUT_TOLERANCE) */
+
+/* Largest error between the selected build and the CPU build accepted by
+ * MODEL_VARIANTS_CHECK: the NPU and the reference kernels round differently. */
+#if !defined(MODEL_VARIANTS_TOLERANCE)
+#define MODEL_VARIANTS_TOLERANCE (2)
+#endif /* !defined(MODEL_VARIANTS_TOLERANCE) */
 
 namespace arm {
 namespace app {
     /* Tensor arena buffer */
     static uint8_t tensorArena[ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
 
+#if defined(MODEL_STAGE_SECTION)
+    /* SRAM copy of the model, made at boot. */
+    static uint8_t modelStage[MODEL_STAGE_BUF_SZ] MODEL_STAGE_ATTRIBUTE;
+#endif /* defined(MODEL_STAGE_SECTION) */
+
     /* Optional getter function for the model pointer and its size. */
     namespace object_detection {
+#if defined(MODEL_VARIANTS)
+        /* Every build of the model (DetectionModelVariants.cpp). */
+        extern const ModelVariant modelVariants[];
+        extern const size_t numModelVariants;
+#else
         extern uint8_t* GetModelPointer();
         extern size_t GetModelLen();
+#endif /* defined(MODEL_VARIANTS) */
     } /* namespace object_detection */
 } /* namespace app */
 } /* namespace arm */
@@ -56,6 +122,7 @@ namespace app {
 __asm("  .global __ARM_use_no_argv\n");
 #endif
 
+#if !defined(HOST_BUILD)
 #define _GET_DRIVER_REF(ref, peri, chan) \
     extern ARM_DRIVER_##peri Driver_##peri##chan; \
     static ARM_DRIVER_##peri * ref = &Driver_##peri##chan;
@@ -92,25 +159,419 @@ void initialize_gpio_pins() {
     pinconf_set(PORT_5, PIN_4, PINMUX_ALTERNATE_FUNCTION_0, config_gpio);
 }
 
+/**
+ * @brief Drives GPIO5 pin 4, high while the unit under test runs.
+ *
+ * @param high Pin state.
+ */
+static inline void set_uut_pin(bool high) {
+    BOARD_GPIO_5_DRV->SetValue(PIN_4, high ? GPIO_PIN_OUTPUT_STATE_HIGH
+                                           : GPIO_PIN_OUTPUT_STATE_LOW);
+}
+#else  /* !defined(HOST_BUILD) */
+/* No pins to drive on the host. */
+void initialize_gpio_pins() {}
+static inline void set_uut_pin(bool) {}
+#endif /* !defined(HOST_BUILD) */
+
 /**
  * @brief Generates a random tensor.
  *
- * This function populates the input tensor with random values.
+ * This function populates the input tensor with pseudo-random values. The
+ * same seed gives the same values on every build, so runs can be compared.
  *
  * @param tensor Pointer to the input tensor.
+ * @param seed   Seed of the generator.
  */
-void initialize_random_tensor(TfLiteTensor* tensor) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint8_t> dis(0, 255);
+void initialize_random_tensor(TfLiteTensor* tensor, uint32_t seed) {
+    std::mt19937 gen(seed);
 
     auto dataPtr = tensor->data.uint8;
     const size_t tensorSize = tensor->bytes;
 
     for (size_t i = 0; i < tensorSize; ++i) {
-        dataPtr[i] = dis(gen);
+        dataPtr[i] = static_cast<uint8_t>(gen() >> 24);
+    }
+}
+
+/**
+ * @brief Copies an 8-bit image, e.g. the sample image im0 (InputFiles.cpp),
+ *        into the input tensor.
+ *
+ * An RGB image is converted to grayscale if the model takes one channel. The
+ * values are shifted to signed ones if the model takes int8.
+ *
+ * @param tensor Pointer to the input tensor.
+ * @param image  Image, in the layout of the tensor or interleaved RGB.
+ * @param size   Size of the image in bytes.
+ * @return true if the image has the size the tensor expects.
+ */
+bool initialize_image_tensor(TfLiteTensor* tensor, const uint8_t* image, size_t size) {
+    uint8_t* dataPtr = tensor->data.uint8;
+    const size_t tensorSize = tensor->bytes;
+    const uint8_t offset = tensor->type == kTfLiteInt8 ? 0x80 : 0;
+
+    if (tensorSize == size) {
+        for (size_t i = 0; i < tensorSize; ++i) {
+            dataPtr[i] = image[i] ^ offset;
+        }
+    } else if (tensorSize * 3 == size) {
+        for (size_t i = 0; i < tensorSize; ++i) {
+            const uint8_t* rgb = &image[i * 3];
+            const uint32_t gray = (77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) >> 8;
+            dataPtr[i] = static_cast<uint8_t>(gray) ^ offset;
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Scales an interleaved RGB image, e.g. the sample image im0, to the
+ *        input tensor.
+ *
+ * The largest centred crop with the aspect ratio of the tensor is resized
+ * bilinearly to its rows and columns, then converted as by
+ * initialize_image_tensor.
+ *
+ * @param tensor Pointer to the input tensor, NHWC with one or three channels.
+ * @param image  Interleaved RGB image.
+ * @param width  Width of the image in pixels.
+ * @param height Height of the image in pixels.
+ * @return true if the tensor has a shape an image can be scaled to.
+ */
+bool resize_image_tensor(TfLiteTensor* tensor, const uint8_t* image, uint32_t width,
+                         uint32_t height) {
+    if (!tensor->dims || tensor->dims->size != 4) {
+        return false;
+    }
+    const uint32_t rows     = tensor->dims->data[1];
+    const uint32_t cols     = tensor->dims->data[2];
+    const uint32_t channels = tensor->dims->data[3];
+    if ((channels != 1 && channels != 3) || !rows || !cols ||
+        tensor->bytes != rows * cols * channels) {
+        return false;
+    }
+
+    uint32_t cropWidth  = width;
+    uint32_t cropHeight = height;
+    if (uint64_t(width) * rows > uint64_t(height) * cols) {
+        cropWidth = static_cast<uint32_t>(uint64_t(height) * cols / rows);
+    } else {
+        cropHeight = static_cast<uint32_t>(uint64_t(width) * rows / cols);
+    }
+    const uint8_t* crop =
+        image + ((height - cropHeight) / 2 * width + (width - cropWidth) / 2) * 3;
+
+    /* Source position of the centre of a destination pixel, in Q8. */
+    auto source = [](uint32_t i, uint32_t dst, uint32_t src, uint32_t* i0, uint32_t* frac) {
+        const int64_t pos = (int64_t(2 * i + 1) * src * 128) / dst - 128;
+        const uint32_t q8 = pos > 0 ? static_cast<uint32_t>(pos) : 0;
+        *i0   = q8 >> 8 < src - 1 ? q8 >> 8 : src - 1;
+        *frac = *i0 < src - 1 ? q8 & 0xFF : 0;
+    };
+
+    uint8_t* dataPtr     = tensor->data.uint8;
+    const uint8_t offset = tensor->type == kTfLiteInt8 ? 0x80 : 0;
+    for (uint32_t y = 0; y < rows; ++y) {
+        uint32_t sy, fy;
+        source(y, rows, cropHeight, &sy, &fy);
+        const uint8_t* row0 = crop + sy * width * 3;
+        const uint8_t* row1 = fy ? row0 + width * 3 : row0;
+        for (uint32_t x = 0; x < cols; ++x) {
+            uint32_t sx, fx;
+            source(x, cols, cropWidth, &sx, &fx);
+            const uint32_t dx = fx ? 3 : 0;
+            uint32_t rgb[3];
+            for (uint32_t c = 0; c < 3; ++c) {
+                const uint32_t p0 = row0[sx * 3 + c] * (256 - fx) + row0[sx * 3 + dx + c] * fx;
+                const uint32_t p1 = row1[sx * 3 + c] * (256 - fx) + row1[sx * 3 + dx + c] * fx;
+                rgb[c]            = (p0 * (256 - fy) + p1 * fy + (1u << 15)) >> 16;
+            }
+            if (channels == 1) {
+                const uint32_t gray = (77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) >> 8;
+                *dataPtr++          = static_cast<uint8_t>(gray) ^ offset;
+            } else {
+                for (uint32_t c = 0; c < 3; ++c) {
+                    *dataPtr++ = static_cast<uint8_t>(rgb[c]) ^ offset;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+#if defined(BENCHMARK_ITERATIONS)
+/**
+ * @brief Times repeated inferences on the current input.
+ *
+ * The first runs warm up the caches and are not counted. Prints the latency
+ * statistics and, with the NPU, how the time splits between the NPU command
+ * streams and the CPU.
+ *
+ * @param model      Initialised model.
+ * @param warmUp     Runs before the timed ones.
+ * @param iterations Timed runs.
+ * @return true if all inferences succeeded.
+ */
+template <typename M>
+bool run_benchmark(M& model, uint32_t warmUp, uint32_t iterations) {
+    static arm::app::BenchmarkStats stats;
+
+    info("Benchmark: %" PRIu32 " warm-up and %" PRIu32 " timed inferences\n",
+         warmUp,
+         iterations);
+    for (uint32_t i = 0; i < warmUp; ++i) {
+        if (!model.RunInference()) {
+            printf_err("Inference failed.\n");
+            return false;
+        }
+    }
+
+#if defined(ARM_NPU)
+    ethosu_npu_pmu_reset();
+#endif /* defined(ARM_NPU) */
+
+    stats.Reset();
+    uint64_t totalCycles = 0;
+    for (uint32_t i = 0; i < iterations; ++i) {
+#if defined(ARM_NPU)
+        ethosu_npu_pmu_next_inference();
+#endif /* defined(ARM_NPU) */
+        const uint32_t start = tflite::GetCurrentTimeTicks();
+        if (!model.RunInference()) {
+            printf_err("Inference failed.\n");
+            return false;
+        }
+        const uint32_t cycles = tflite::GetCurrentTimeTicks() - start;
+        stats.Add(cycles);
+        totalCycles += cycles;
+    }
+    stats.Print("inference");
+
+#if defined(ARM_NPU)
+    ethosu_npu_pmu_stats npuStats;
+    ethosu_npu_pmu_get_stats(&npuStats);
+    ethosu_npu_pmu_print(&npuStats, iterations, totalCycles);
+#endif /* defined(ARM_NPU) */
+    return true;
+}
+#endif /* defined(BENCHMARK_ITERATIONS) */
+
+#if defined(MULTI_MODEL_CHECK)
+/**
+ * @brief Runs two instances of the model out of the one tensor arena.
+ *
+ * Each instance keeps its persistent buffers in the arena shared through
+ * MultiModelRuntime, while their activations overlay. Both run on the same
+ * seeded noise, one after the other, and must give the same outputs: the
+ * outputs of the first are copied out before the second overwrites them. The
+ * wrappers are destroyed on return, leaving the arena to the next model.
+ *
+ * @param modelData Model flatbuffer.
+ * @param modelLen  Its size in bytes.
+ * @return true if both instances ran and their outputs are identical.
+ */
+bool check_shared_arena(const uint8_t* modelData, size_t modelLen) {
+    arm::app::TestModel first;
+    arm::app::TestModel second;
+    arm::app::MultiModelRuntime runtime(arm::app::tensorArena, sizeof(arm::app::tensorArena));
+    if (!runtime.Add(first, modelData, static_cast<uint32_t>(modelLen)) ||
+        !runtime.Add(second, modelData, static_cast<uint32_t>(modelLen))) {
+        return false;
+    }
+
+    initialize_random_tensor(first.GetInputTensor(0), BENCHMARK_SEED);
+    if (!runtime.RunInference(first)) {
+        printf_err("Inference failed.\n");
+        return false;
+    }
+    std::vector<std::vector<uint8_t>> outputs(first.GetNumOutputs());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        const TfLiteTensor* tensor = first.GetOutputTensor(i);
+        outputs[i].assign(tensor->data.uint8, tensor->data.uint8 + tensor->bytes);
+    }
+
+    initialize_random_tensor(second.GetInputTensor(0), BENCHMARK_SEED);
+    if (!runtime.RunInference(second)) {
+        printf_err("Inference failed.\n");
+        return false;
+    }
+    size_t differ = 0;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        const TfLiteTensor* tensor = second.GetOutputTensor(i);
+        for (size_t j = 0; j < outputs[i].size() && j < tensor->bytes; ++j) {
+            differ += outputs[i][j] != tensor->data.uint8[j];
+        }
+    }
+    runtime.PrintUsage();
+    if (differ) {
+        printf_err("Shared arena: %zu output bytes differ between the two instances\n", differ);
+        return false;
+    }
+    info("Shared arena: both instances of the model give the same outputs\n");
+    return true;
+}
+#endif /* defined(MULTI_MODEL_CHECK) */
+
+#if defined(MODEL_VARIANTS_CHECK)
+/**
+ * @brief Compares the build of the model selected at boot with the CPU build.
+ *
+ * Both builds share the tensor arena through MultiModelRuntime and run on the
+ * same seeded noise, one after the other. The outputs of the selected build
+ * are copied out before the CPU build overwrites the shared activations. The
+ * wrappers are destroyed on return, leaving the arena to the next model.
+ *
+ * @param variant   Build selected for the NPU found at boot.
+ * @param tolerance Largest accepted error of an output element, in quantized steps.
+ * @return true if the outputs match within the tolerance.
+ */
+bool check_model_variant(const arm::app::ModelVariant* variant, float tolerance) {
+    const arm::app::ModelVariant* cpu = nullptr;
+    for (size_t i = 0; i < arm::app::object_detection::numModelVariants; ++i) {
+        if (!arm::app::object_detection::modelVariants[i].npuArch) {
+            cpu = &arm::app::object_detection::modelVariants[i];
+            break;
+        }
+    }
+    if (!cpu || cpu == variant) {
+        info("Model variants: no other build to compare %s with\n", variant->name);
+        return true;
+    }
+
+    arm::app::TestModel selected;
+    arm::app::TestModel reference;
+    arm::app::MultiModelRuntime runtime(arm::app::tensorArena, sizeof(arm::app::tensorArena));
+    if (!runtime.Add(selected, variant->getModelPointer(),
+                     static_cast<uint32_t>(variant->getModelLen())) ||
+        !runtime.Add(reference, cpu->getModelPointer(),
+                     static_cast<uint32_t>(cpu->getModelLen()))) {
+        return false;
     }
+
+    initialize_random_tensor(selected.GetInputTensor(0), BENCHMARK_SEED);
+    if (!runtime.RunInference(selected)) {
+        printf_err("Inference failed.\n");
+        return false;
+    }
+    std::vector<std::vector<uint8_t>> outputs(selected.GetNumOutputs());
+    std::vector<arm::app::GoldenTensor> expected(selected.GetNumOutputs());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        const TfLiteTensor* tensor = selected.GetOutputTensor(i);
+        outputs[i].assign(tensor->data.uint8, tensor->data.uint8 + tensor->bytes);
+        expected[i] = {tensor->type, outputs[i].data(), outputs[i].size()};
+    }
+
+    initialize_random_tensor(reference.GetInputTensor(0), BENCHMARK_SEED);
+    if (!runtime.RunInference(reference)) {
+        printf_err("Inference failed.\n");
+        return false;
+    }
+    info("Model variants: %s compared with %s\n", variant->name, cpu->name);
+    arm::app::GoldenOutput comparison(expected.data(), expected.size(), tolerance);
+    for (size_t i = 0; i < reference.GetNumOutputs(); ++i) {
+        comparison.Check(reference.GetOutputTensor(i));
+    }
+    runtime.PrintUsage();
+    return comparison.Print();
+}
+#endif /* defined(MODEL_VARIANTS_CHECK) */
+
+#if (defined(MODEL_STAGE_SECTION) || defined(OSPI_XIP_BENCHMARK)) && defined(MODEL_IN_EXT_FLASH)
+/**
+ * @brief Times inferences of the model executed in place from OSPI flash.
+ *
+ * This is the baseline for the copy of the model staged in SRAM. The model
+ * wrapper is destroyed on return, leaving the tensor arena to the next one.
+ *
+ * @param modelData Model in the XIP window.
+ * @param modelLen  Size of the model in bytes.
+ * @param runs      Number of inferences.
+ * @param cycles    Total cycles of the inferences.
+ * @return true if every inference ran.
+ */
+bool benchmark_xip_model(const uint8_t* modelData, size_t modelLen, uint32_t runs,
+                         uint32_t* cycles) {
+    arm::app::TestModel xipModel;
+    if (!xipModel.Init(arm::app::tensorArena, sizeof(arm::app::tensorArena),
+                       modelData, modelLen)) {
+        printf_err("Failed to initialise model from flash\n");
+        return false;
+    }
+    initialize_random_tensor(xipModel.GetInputTensor(0), BENCHMARK_SEED);
+
+    *cycles = 0;
+    for (uint32_t i = 0; i < runs; ++i) {
+        const uint32_t start = tflite::GetCurrentTimeTicks();
+        if (!xipModel.RunInference()) {
+            printf_err("Inference failed.\n");
+            return false;
+        }
+        *cycles += tflite::GetCurrentTimeTicks() - start;
+    }
+    return true;
+}
+#endif /* (defined(MODEL_STAGE_SECTION) || defined(OSPI_XIP_BENCHMARK)) && ... */
+
+#if defined(OSPI_XIP_BENCHMARK) && defined(MODEL_IN_EXT_FLASH)
+/**
+ * @brief Measures every OSPI XIP profile: reads of the model data and
+ *        inference with the model executed in place.
+ *
+ * A profile whose reads return different data than the first one is reported
+ * as unsafe. The configured profile is restored afterwards.
+ *
+ * @param modelData Model in the XIP window.
+ * @param modelLen  Size of the model in bytes.
+ * @param runs      Number of inferences per profile.
+ * @return true if every inference ran.
+ */
+bool benchmark_xip_profiles(const uint8_t* modelData, size_t modelLen, uint32_t runs) {
+    const ospi_xip_profile* configured = ospi_flash_get_xip_profile();
+    const ospi_xip_profile* fastest    = nullptr;
+    uint32_t fastestCycles             = 0;
+    uint32_t reference                 = 0;
+
+    for (uint32_t p = 0; p < ospi_xip_num_profiles; ++p) {
+        const ospi_xip_profile* profile = &ospi_xip_profiles[p];
+        ospi_flash_set_xip_profile(profile);
+
+        ospi_xip_read_stats stats;
+        ospi_xip_bench_reads(modelData, modelLen, &stats);
+        ospi_xip_bench_print(profile, &stats);
+
+        if (p == 0) {
+            reference = stats.checksum;
+        } else if (stats.checksum != reference) {
+            info("XIP %-30s UNSAFE: data differs from %s\n", profile->name,
+                 ospi_xip_profiles[0].name);
+            continue;
+        }
+
+        uint32_t cycles = 0;
+        if (!benchmark_xip_model(modelData, modelLen, runs, &cycles)) {
+            ospi_flash_set_xip_profile(configured);
+            return false;
+        }
+        info("XIP %-30s inference %" PRIu32 " cycles (%" PRIu64 " us)\n", profile->name,
+             cycles / runs, time_base_ticks_to_us(cycles / runs));
+
+        if (!fastest || cycles < fastestCycles) {
+            fastest       = profile;
+            fastestCycles = cycles;
+        }
+    }
+
+    if (fastest) {
+        info("Fastest safe XIP profile: %s (OSPI_XIP_PROFILE: %" PRIu32 ")\n", fastest->name,
+             static_cast<uint32_t>(fastest - ospi_xip_profiles));
+    }
+    ospi_flash_set_xip_profile(configured);
+    return true;
 }
+#endif /* defined(OSPI_XIP_BENCHMARK) && defined(MODEL_IN_EXT_FLASH) */
 
 int main()
 {
@@ -120,13 +581,107 @@ int main()
     info("Hello World!\n");
 
     /* Model object creation and initialisation. */
+#if defined(PROFILE_OPERATORS)
+    arm::app::ProfiledModel<arm::app::TestModel> model;  /* Model wrapper object. */
+#else
     arm::app::TestModel model;  /* Model wrapper object. */
+#endif /* defined(PROFILE_OPERATORS) */
+
+#if defined(MODEL_VARIANTS)
+    /* The build of the model for the NPU found at boot, or the CPU model. */
+    uint32_t npuArch      = 0;
+    uint32_t npuMacsPerCc = 0;
+    BoardGetNpuInfo(&npuArch, &npuMacsPerCc);
+    const arm::app::ModelVariant* variant =
+        arm::app::SelectModelVariant(arm::app::object_detection::modelVariants,
+                                     arm::app::object_detection::numModelVariants,
+                                     npuArch,
+                                     npuMacsPerCc);
+    if (!variant) {
+        return 1;
+    }
+    const uint8_t* modelData = variant->getModelPointer();
+    size_t modelLen          = variant->getModelLen();
+#if defined(MODEL_VARIANTS_CHECK)
+    /* Reported only: builds may legitimately differ by more than the tolerance. */
+    check_model_variant(variant, MODEL_VARIANTS_TOLERANCE);
+#endif /* defined(MODEL_VARIANTS_CHECK) */
+#else
+    const uint8_t* modelData = arm::app::object_detection::GetModelPointer();
+    size_t modelLen          = arm::app::object_detection::GetModelLen();
+#endif /* defined(MODEL_VARIANTS) */
+    if (!modelData) {
+        /* A compressed model (ModelCompression.hpp) that failed to expand. */
+        printf_err("No model\n");
+        return 1;
+    }
+#if defined(MULTI_MODEL_CHECK)
+    /* Reported only: the arena is the application's again afterwards. */
+    check_shared_arena(modelData, modelLen);
+#endif /* defined(MULTI_MODEL_CHECK) */
+
+#if defined(MODEL_SLOTS) && defined(MODEL_IN_EXT_FLASH)
+#if defined(MODEL_UPDATE_WINDOW_MS)
+    /* Give scripts/send_model_update.py a chance to deliver a new model
+     * before anything runs from the flash. */
+    static arm::app::ModelUpdater updater;
+    info("Waiting %d ms for a model update\n", MODEL_UPDATE_WINDOW_MS);
+    if (updater.Run(MODEL_UPDATE_WINDOW_MS) == arm::app::ModelUpdater::Result::Updated) {
+        NVIC_SystemReset();
+    }
+#endif /* defined(MODEL_UPDATE_WINDOW_MS) */
+    modelData = arm::app::ModelSlots::Select(modelData, modelLen, &modelLen);
+#endif /* defined(MODEL_SLOTS) && defined(MODEL_IN_EXT_FLASH) */
+
+#if defined(ARM_NPU)
+    /* The NPU PMU counts its two AXI ports on alternate inferences: run the
+     * inference once per port so that the traffic of both is measured. */
+    const uint32_t numInferences = ETHOSU_NPU_PMU_AXI_PORTS;
+#else  /* defined(ARM_NPU) */
+    const uint32_t numInferences = 1;
+#endif /* defined(ARM_NPU) */
+
+#if defined(OSPI_XIP_BENCHMARK) && defined(MODEL_IN_EXT_FLASH)
+    if (!benchmark_xip_profiles(modelData, modelLen, numInferences)) {
+        return 2;
+    }
+#endif /* defined(OSPI_XIP_BENCHMARK) && defined(MODEL_IN_EXT_FLASH) */
+
+#if defined(MODEL_STAGE_SECTION)
+#if defined(MODEL_IN_EXT_FLASH)
+    /* Run from flash first, to compare with the staged copy. */
+    uint32_t xipCycles = 0;
+    if (!benchmark_xip_model(modelData, modelLen, numInferences, &xipCycles)) {
+        return 2;
+    }
+#endif /* defined(MODEL_IN_EXT_FLASH) */
+
+    modelData = arm::app::StageModel(modelData, modelLen, arm::app::modelStage,
+                                     sizeof(arm::app::modelStage), MODEL_STAGE_CRC32);
+    if (!modelData) {
+        return 1;
+    }
+#if defined(ARM_NPU)
+    /* Written once above, cleaned to memory: no maintenance per inference. */
+    ethosu_mem_policy_add(modelData, modelLen, ETHOSU_MEM_INHERIT | ETHOSU_MEM_READ_ONLY,
+                          "Staged model");
+#endif /* defined(ARM_NPU) */
+#endif /* defined(MODEL_STAGE_SECTION) */
+
+    /* Fail early if the op resolver does not match the model. */
+    if (!model.CheckOperators(modelData)) {
+        return 1;
+    }
+
+    /* Paint the arena to cross-check how much of it the model writes. */
+    arm::app::ArenaUsage arenaUsage(arm::app::tensorArena, sizeof(arm::app::tensorArena));
+    arenaUsage.Paint();
 
     /* Load the model. */
     if (!model.Init(arm::app::tensorArena,
                     sizeof(arm::app::tensorArena),
-                    arm::app::object_detection::GetModelPointer(),
-                    arm::app::object_detection::GetModelLen())) {
+                    modelData,
+                    modelLen)) {
         printf_err("Failed to initialise model\n");
         return 1;
     }
@@ -143,17 +698,125 @@ int main()
         return 1;
     }
 
-    /* Initialize the input tensor with random values. */
-    initialize_random_tensor(inputTensor);
+    /* Initialize the input tensor with an image or seeded noise. */
+    const uint8_t* image  = nullptr;
+    size_t imageSize      = 0;
+    const char* imageName = nullptr;
+#if defined(HOST_BUILD)
+    image     = host_load_file("MLEK_INPUT_IMAGE", &imageSize);
+    imageName = "MLEK_INPUT_IMAGE";
+#endif /* defined(HOST_BUILD) */
+#if defined(BENCHMARK_INPUT_IMAGE)
+    if (!image) {
+        image     = im0;
+        imageSize = IMAGE_DATA_SIZE;
+        imageName = get_filename(0);
+    }
+#endif /* defined(BENCHMARK_INPUT_IMAGE) */
+    if (image && initialize_image_tensor(inputTensor, image, imageSize)) {
+        info("Input: image %s\n", imageName);
+    } else if (image == im0 &&
+               resize_image_tensor(inputTensor, im0, SAMPLE_IMAGE_SIDE, SAMPLE_IMAGE_SIDE)) {
+        info("Input: image %s, scaled to the model input\n", imageName);
+    } else {
+        if (image) {
+            info("Input: image of %zu bytes does not fit the model, using noise\n", imageSize);
+        }
+        initialize_random_tensor(inputTensor, BENCHMARK_SEED);
+    }
+
+#if defined(ARM_NPU)
+    ethosu_reset_cache_stats();
+    ethosu_npu_pmu_reset();
+#endif /* defined(ARM_NPU) */
 
-    /* Run inference over the random tensor. */
-    info("Running inference on random tensor\n");
-    BOARD_GPIO_5_DRV->SetValue(PIN_4, GPIO_PIN_OUTPUT_STATE_HIGH);
-    if (!model.RunInference()) {
-        printf_err("Inference failed.\n");
+    /* Run inference over the input tensor. */
+    info("Running inference\n");
+    uint32_t inferenceCycles = 0;
+    for (uint32_t i = 0; i < numInferences; ++i) {
+#if defined(ARM_NPU)
+        ethosu_npu_pmu_next_inference();
+#endif /* defined(ARM_NPU) */
+        set_uut_pin(true);
+        const uint32_t inferenceStart = tflite::GetCurrentTimeTicks();
+        if (!model.RunInference()) {
+            printf_err("Inference failed.\n");
+            return 2;
+        }
+        inferenceCycles += tflite::GetCurrentTimeTicks() - inferenceStart;
+        set_uut_pin(false);
+    }
+
+#if defined(ARM_NPU)
+    /* Cache maintenance done around the NPU command streams of these inferences. */
+    ethosu_cache_stats cacheStats;
+    ethosu_get_cache_stats(&cacheStats);
+    info("NPU cache maintenance: %" PRIu32 " requests, %" PRIu32 " skipped, %" PRIu32
+         " by address (%" PRIu64 " bytes), %" PRIu32 " whole cache\n",
+         cacheStats.requests,
+         cacheStats.skipped,
+         cacheStats.by_addr_ops,
+         cacheStats.bytes_by_addr,
+         cacheStats.whole_cache_ops);
+    info("NPU cache maintenance: %" PRIu64 " cycles, %" PRId64 " saved over whole-cache\n",
+         cacheStats.cycles_spent,
+         static_cast<int64_t>(cacheStats.cycles_whole_cache - cacheStats.cycles_spent));
+    ethosu_reset_cache_stats();
+
+    /* NPU activity and bus traffic during the inferences. */
+    ethosu_npu_pmu_stats npuStats;
+    ethosu_npu_pmu_get_stats(&npuStats);
+    ethosu_npu_pmu_print(&npuStats, numInferences, inferenceCycles);
+#endif /* defined(ARM_NPU) */
+    info("Inference took %" PRIu32 " cycles (%" PRIu64 " us)\n",
+         inferenceCycles / numInferences,
+         time_base_ticks_to_us(inferenceCycles / numInferences));
+#if defined(MODEL_STAGE_SECTION) && defined(MODEL_IN_EXT_FLASH)
+    info("Model in flash (XIP): %" PRIu32 " cycles (%" PRIu64 " us), staged in SRAM: %" PRIu32
+         " cycles, %" PRIu32 "%% of XIP\n",
+         xipCycles / numInferences,
+         time_base_ticks_to_us(xipCycles / numInferences),
+         inferenceCycles / numInferences,
+         xipCycles ? static_cast<uint32_t>(100ull * inferenceCycles / xipCycles) : 0);
+#endif /* defined(MODEL_STAGE_SECTION) && defined(MODEL_IN_EXT_FLASH) */
+
+    if (arenaUsage.Measure(model.GetAllocator())) {
+        arenaUsage.Print();
+    }
+
+#if defined(GOLDEN_OUTPUT_DUMP)
+    /* Reference outputs for scripts/golden_output.py. */
+    for (size_t i = 0; i < model.GetNumOutputs(); ++i) {
+        arm::app::GoldenOutput::Dump(model.GetOutputTensor(i), i);
+    }
+#endif /* defined(GOLDEN_OUTPUT_DUMP) */
+#if defined(GOLDEN_OUTPUT_CHECK)
+    arm::app::GoldenOutput golden(
+        arm::app::golden::tensors, arm::app::golden::numTensors, GOLDEN_OUTPUT_TOLERANCE);
+    for (size_t i = 0; i < model.GetNumOutputs(); ++i) {
+        golden.Check(model.GetOutputTensor(i));
+    }
+    if (!golden.Print()) {
+        return 4;
+    }
+#endif /* defined(GOLDEN_OUTPUT_CHECK) */
+
+#if defined(BENCHMARK_ITERATIONS)
+    if (!run_benchmark(model, BENCHMARK_WARMUP, BENCHMARK_ITERATIONS)) {
         return 2;
     }
-    BOARD_GPIO_5_DRV->SetValue(PIN_4, GPIO_PIN_OUTPUT_STATE_LOW);
+#endif /* defined(BENCHMARK_ITERATIONS) */
+
+#if defined(PROFILE_OPERATORS)
+    /* Average the per-operator profile over more runs of the same input. */
+    for (uint32_t i = numInferences; i < PROFILE_OPERATORS; ++i) {
+        if (!model.RunInference()) {
+            printf_err("Inference failed.\n");
+            return 2;
+        }
+    }
+    model.GetProfiler().Print(PROFILE_OPERATORS_FORMAT);
+#endif /* defined(PROFILE_OPERATORS) */
 
     /* Post-process results if applicable. */
     // auto outputCount = model.GetOutputTensorCount();
@@ -162,6 +825,18 @@ int main()
     //     info("Output tensor %d: size=%d\n", i, outputTensor->bytes);
     // }
 
+#if defined(HOST_BUILD)
+    /* The output tensors, one after the other, for comparison across runs. */
+    std::vector<uint8_t> outputs;
+    for (size_t i = 0; i < model.GetNumOutputs(); ++i) {
+        const TfLiteTensor* tensor = model.GetOutputTensor(i);
+        outputs.insert(outputs.end(), tensor->data.uint8, tensor->data.uint8 + tensor->bytes);
+    }
+    if (host_save_file("MLEK_OUTPUT", outputs.data(), outputs.size()) != 0) {
+        return 3;
+    }
+#endif /* defined(HOST_BUILD) */
+
     /* Log the results. */
     info("Inference completed successfully.\n");
 
@@ -0,0 +1,251 @@
+#  SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+#  affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+"""
+Compresses the model array of a generated .tflite.cpp/.tflite.cc source, so
+that it takes less MRAM or flash, and writes a source that expands it into
+SRAM on first use of GetModelPointer() (common/include/ModelCompression.hpp).
+
+The rest of the source (model parameters, anchors, getters) is kept, so the
+output replaces the original in a .cproject.yml as is. The model is expanded
+into the SRAM chosen with MODEL_EXPAND_SRAM0 or MODEL_EXPAND_SRAM1, which must
+be defined; the expansion is checked with the CRC-32 of the original model.
+
+The format is a sequence of LZ4 blocks. With the lz4 package installed
+(pip install lz4) its high compression mode is used, otherwise a slower and
+less thorough compressor built into this script. Vela already compresses the
+weights it packs for the NPU, so Vela models shrink less than TFLM ones: the
+ratio is printed.
+
+Example:
+
+    python scripts/compress_model.py kws/src/kws_micronet_m_vela_H128.tflite.cpp \\
+        -o kws/src/kws_micronet_m_vela_H128.lz4.tflite.cpp
+"""
+import argparse
+import re
+import struct
+import sys
+import zlib
+from datetime import datetime
+from pathlib import Path
+
+try:
+    import lz4.block
+except ImportError:
+    lz4 = None
+
+MAGIC = 0x4D345A4C  # kModelLz4Magic
+STORED = 0x80000000  # kModelLz4Stored
+BLOCK_SIZE = 64 * 1024
+
+MIN_MATCH = 4
+# LZ4 block rules: the last 5 bytes are literals, the last match starts at
+# least 12 bytes before the end.
+LAST_LITERALS = 5
+MF_LIMIT = 12
+
+MODEL_ARRAY = re.compile(
+    r"^([ \t]*)static const uint8_t nn_model\[\]\s*MODEL_TFLITE_ATTRIBUTE\s*=\s*\{(.*?)\}\s*;",
+    re.S | re.M,
+)
+
+
+def write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def write_sequence(out, literals, match_length=None, offset=None):
+    token_lit = min(len(literals), 15)
+    token_match = 0 if match_length is None else min(match_length - MIN_MATCH, 15)
+    out.append(token_lit << 4 | token_match)
+    if len(literals) >= 15:
+        write_length(out, len(literals) - 15)
+    out += literals
+    if match_length is not None:
+        out += struct.pack("<H", offset)
+        if match_length - MIN_MATCH >= 15:
+            write_length(out, match_length - MIN_MATCH - 15)
+
+
+def compress_block(src):
+    """Greedy LZ4 block compressor: matches the last position of each 4-byte key."""
+    if lz4 is not None:
+        return lz4.block.compress(src, mode="high_compression", store_size=False)
+
+    out = bytearray()
+    last = {}
+    anchor = pos = 0
+    match_limit = len(src) - MF_LIMIT
+    end_limit = len(src) - LAST_LITERALS
+    while pos < match_limit:
+        key = src[pos:pos + MIN_MATCH]
+        cand = last.get(key)
+        last[key] = pos
+        if cand is None or pos - cand > 0xFFFF:
+            pos += 1
+            continue
+        length = MIN_MATCH
+        while pos + length < end_limit and src[cand + length] == src[pos + length]:
+            length += 1
+        write_sequence(out, src[anchor:pos], length, pos - cand)
+        pos += length
+        anchor = pos
+    write_sequence(out, src[anchor:])
+    return bytes(out)
+
+
+def decompress_block(src, size):
+    """Reference decoder, to check the compressed model before writing it."""
+    out = bytearray()
+    pos = 0
+
+    def length(value):
+        nonlocal pos
+        if value == 15:
+            while True:
+                byte = src[pos]
+                pos += 1
+                value += byte
+                if byte != 255:
+                    break
+        return value
+
+    while True:
+        token = src[pos]
+        pos += 1
+        literals = length(token >> 4)
+        out += src[pos:pos + literals]
+        pos += literals
+        if pos == len(src):
+            break
+        offset = struct.unpack_from("<H", src, pos)[0]
+        pos += 2
+        match = length(token & 15) + MIN_MATCH
+        for _ in range(match):
+            out.append(out[-offset])
+    if len(out) != size:
+        raise ValueError("block does not decompress to its size")
+    return bytes(out)
+
+
+def compress(model):
+    out = bytearray(struct.pack("<IIII", MAGIC, len(model), zlib.crc32(model), BLOCK_SIZE))
+    for start in range(0, len(model), BLOCK_SIZE):
+        block = model[start:start + BLOCK_SIZE]
+        packed = compress_block(block)
+        if decompress_block(packed, len(block)) != block:
+            raise ValueError(f"block at {start} does not decompress to the model")
+        if len(packed) >= len(block):
+            out += struct.pack("<I", STORED | len(block)) + block
+        else:
+            out += struct.pack("<I", len(packed)) + packed
+    return bytes(out)
+
+
+def hex_lines(data, indent):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + "    " + " ".join(f"0x{b:02x}," for b in data[i:i + 16]))
+    return "\n".join(lines)
+
+
+def rewrite(source, model, packed):
+    match = MODEL_ARRAY.search(source)
+    if not match:
+        raise ValueError("no nn_model array found")
+    indent = match.group(1)
+    arrays = (
+        f"{indent}/* {len(model)} byte model, {len(packed)} bytes compressed. Expanded into\n"
+        f"{indent} * nn_model by the first call to GetModelPointer(). */\n"
+        f"{indent}static uint8_t nn_model[{len(model)}] MODEL_EXPAND_ATTRIBUTE;\n\n"
+        f"{indent}static const uint8_t nn_model_lz4[] MODEL_TFLITE_ATTRIBUTE = {{\n"
+        f"{hex_lines(packed, indent)}\n"
+        f"{indent}}};"
+    )
+    source = source[:match.start()] + arrays + source[match.end():]
+
+    getter, count = re.subn(
+        r"^([ \t]*)return nn_model;",
+        lambda m: (
+            f"{m.group(1)}static const uint8_t* model = nullptr;\n"
+            f"{m.group(1)}if (!model) {{\n"
+            f"{m.group(1)}    model = ExpandModel(nn_model_lz4, sizeof(nn_model_lz4), nn_model,\n"
+            f"{m.group(1)}                        sizeof(nn_model));\n"
+            f"{m.group(1)}}}\n"
+            f"{m.group(1)}return model;"
+        ),
+        source,
+        flags=re.M,
+    )
+    if count != 1:
+        raise ValueError("no GetModelPointer() returning nn_model found")
+    source = getter
+
+    source, count = re.subn(
+        r'^#include "BufAttributes.hpp"\n',
+        '#include "BufAttributes.hpp"\n#include "ModelCompression.hpp"\n\n'
+        "#if !defined(MODEL_EXPAND_SECTION)\n"
+        '#error "Define MODEL_EXPAND_SRAM0 or MODEL_EXPAND_SRAM1 to expand the compressed model"\n'
+        "#endif /* !defined(MODEL_EXPAND_SECTION) */\n",
+        source,
+        count=1,
+        flags=re.M,
+    )
+    if count != 1:
+        raise ValueError('no #include "BufAttributes.hpp" found')
+
+    return re.sub(
+        r"^( \* Generated from .*\n)",
+        lambda m: m.group(1)
+        + f" * Compressed with compress_model.py, {datetime.now():%Y-%m-%d %H:%M:%S}.\n",
+        source,
+        count=1,
+        flags=re.M,
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("source", type=Path, help="Generated .tflite.cpp/.tflite.cc model source")
+    parser.add_argument("-o", "--output", type=Path, required=True, help="Source to write")
+    args = parser.parse_args()
+
+    sys.path.insert(0, str(Path(__file__).resolve().parent))
+    from gen_op_resolver import read_model
+
+    source = args.source.read_text()
+    model = read_model(args.source)
+    packed = compress(model)
+    try:
+        output = rewrite(source, model, packed)
+    except ValueError as err:
+        sys.exit(f"{args.source}: {err}")
+
+    args.output.write_text(output)
+    print(
+        f"{args.source.name}: {len(model)} -> {len(packed)} bytes "
+        f"({len(model) / len(packed):.2f}:1, {'lz4' if lz4 else 'built-in'} compressor), "
+        f"written to {args.output}"
+    )
+
+
+if __name__ == "__main__":
+    main()
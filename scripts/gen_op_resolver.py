@@ -0,0 +1,278 @@
+#  SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+#  affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+"""
+Generates a MicroMutableOpResolver that registers exactly the operators a model
+uses, instead of every TFLM kernel (MicroMutableAllOpsResolver.cpp).
+
+The model can be a .tflite file or a .tflite.cpp/.tflite.cc source produced by
+gen_model_cpp.py. For a Vela-compiled model this is usually ETHOSU plus the few
+operators that fell back to the CPU.
+
+Example, for the object detection TestModel (built with USE_MODEL_OP_RESOLVER):
+
+    python scripts/gen_op_resolver.py \\
+        object-detection/src/yolo-fastest_192_face_v4_vela_H256.tflite.cpp \\
+        -o object-detection/include/ModelOpResolver.hpp
+
+With --tflm pointing at a TensorFlow Lite Micro checkout, every generated
+method is checked against tensorflow/lite/micro/micro_mutable_op_resolver.h, so
+a naming mismatch fails here instead of at compile time.
+
+The model check at start-up (CheckOpResolver, common/include/OpResolverCheck.hpp)
+reports any operator the generated resolver is missing, e.g. after the model
+was changed without regenerating it.
+"""
+import argparse
+import re
+import struct
+import sys
+from datetime import datetime
+from pathlib import Path
+
+# BuiltinOperator values of the TensorFlow Lite schema.
+BUILTIN_OPERATORS = [
+    "ADD", "AVERAGE_POOL_2D", "CONCATENATION", "CONV_2D", "DEPTHWISE_CONV_2D",
+    "DEPTH_TO_SPACE", "DEQUANTIZE", "EMBEDDING_LOOKUP", "FLOOR", "FULLY_CONNECTED",
+    "HASHTABLE_LOOKUP", "L2_NORMALIZATION", "L2_POOL_2D", "LOCAL_RESPONSE_NORMALIZATION",
+    "LOGISTIC", "LSH_PROJECTION", "LSTM", "MAX_POOL_2D", "MUL", "RELU", "RELU_N1_TO_1",
+    "RELU6", "RESHAPE", "RESIZE_BILINEAR", "RNN", "SOFTMAX", "SPACE_TO_DEPTH", "SVDF",
+    "TANH", "CONCAT_EMBEDDINGS", "SKIP_GRAM", "CALL", "CUSTOM", "EMBEDDING_LOOKUP_SPARSE",
+    "PAD", "UNIDIRECTIONAL_SEQUENCE_RNN", "GATHER", "BATCH_TO_SPACE_ND",
+    "SPACE_TO_BATCH_ND", "TRANSPOSE", "MEAN", "SUB", "DIV", "SQUEEZE",
+    "UNIDIRECTIONAL_SEQUENCE_LSTM", "STRIDED_SLICE", "BIDIRECTIONAL_SEQUENCE_RNN", "EXP",
+    "TOPK_V2", "SPLIT", "LOG_SOFTMAX", "DELEGATE", "BIDIRECTIONAL_SEQUENCE_LSTM", "CAST",
+    "PRELU", "MAXIMUM", "ARG_MAX", "MINIMUM", "LESS", "NEG", "PADV2", "GREATER",
+    "GREATER_EQUAL", "LESS_EQUAL", "SELECT", "SLICE", "SIN", "TRANSPOSE_CONV",
+    "SPARSE_TO_DENSE", "TILE", "EXPAND_DIMS", "EQUAL", "NOT_EQUAL", "LOG", "SUM", "SQRT",
+    "RSQRT", "SHAPE", "POW", "ARG_MIN", "FAKE_QUANT", "REDUCE_PROD", "REDUCE_MAX", "PACK",
+    "LOGICAL_OR", "ONE_HOT", "LOGICAL_AND", "LOGICAL_NOT", "UNPACK", "REDUCE_MIN",
+    "FLOOR_DIV", "REDUCE_ANY", "SQUARE", "ZEROS_LIKE", "FILL", "FLOOR_MOD", "RANGE",
+    "RESIZE_NEAREST_NEIGHBOR", "LEAKY_RELU", "SQUARED_DIFFERENCE", "MIRROR_PAD", "ABS",
+    "SPLIT_V", "UNIQUE", "CEIL", "REVERSE_V2", "ADD_N", "GATHER_ND", "COS", "WHERE", "RANK",
+    "ELU", "REVERSE_SEQUENCE", "MATRIX_DIAG", "QUANTIZE", "MATRIX_SET_DIAG", "ROUND",
+    "HARD_SWISH", "IF", "WHILE", "NON_MAX_SUPPRESSION_V4", "NON_MAX_SUPPRESSION_V5",
+    "SCATTER_ND", "SELECT_V2", "DENSIFY", "SEGMENT_SUM", "BATCH_MATMUL",
+    "PLACEHOLDER_FOR_GREATER_OP_CODES", "CUMSUM", "CALL_ONCE", "BROADCAST_TO", "RFFT2D",
+    "CONV_3D", "IMAG", "REAL", "COMPLEX_ABS", "HASHTABLE", "HASHTABLE_FIND",
+    "HASHTABLE_IMPORT", "HASHTABLE_SIZE", "REDUCE_ALL", "CONV_3D_TRANSPOSE", "VAR_HANDLE",
+    "READ_VARIABLE", "ASSIGN_VARIABLE", "BROADCAST_ARGS", "RANDOM_STANDARD_NORMAL",
+    "BUCKETIZE", "RANDOM_UNIFORM", "MULTINOMIAL", "GELU", "DYNAMIC_UPDATE_SLICE",
+    "RELU_0_TO_1", "UNSORTED_SEGMENT_PROD", "UNSORTED_SEGMENT_MAX", "UNSORTED_SEGMENT_SUM",
+    "ATAN2", "UNSORTED_SEGMENT_MIN", "SIGN",
+]
+CUSTOM = BUILTIN_OPERATORS.index("CUSTOM")
+
+# MicroMutableOpResolver methods whose name does not follow from the operator's.
+METHOD_EXCEPTIONS = {
+    "BATCH_MATMUL": "BatchMatMul",
+    "CUMSUM": "CumSum",
+    "PADV2": "PadV2",
+    "UNIDIRECTIONAL_SEQUENCE_LSTM": "UnidirectionalSequenceLSTM",
+}
+CUSTOM_METHODS = {
+    "ethos-u": "EthosU",
+    "TFLite_Detection_PostProcess": "DetectionPostprocess",
+}
+
+LICENSE = """/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+"""
+
+
+def read_model(path):
+    """Returns the flatbuffer of a .tflite file or of the array in a generated source."""
+    if path.suffix == ".tflite":
+        return path.read_bytes()
+
+    # The model is the largest array of the file; others hold e.g. anchors.
+    arrays = re.findall(r"\[\]\s*[A-Z_]*\s*=\s*\{(.*?)\}\s*;", path.read_text(), re.S)
+    if not arrays:
+        raise ValueError("no model array found")
+    model = max(arrays, key=len)
+    return bytes(int(tok, 0) for tok in re.findall(r"0x[0-9a-fA-F]+", model))
+
+
+class Table:
+    """Minimal read-only view of a flatbuffer table."""
+
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        vtable = pos - struct.unpack_from("<i", buf, pos)[0]
+        vt_size = struct.unpack_from("<H", buf, vtable)[0]
+        self.fields = [
+            struct.unpack_from("<H", buf, vtable + 4 + 2 * i)[0] for i in range((vt_size - 4) // 2)
+        ]
+
+    def _field(self, index):
+        if index < len(self.fields) and self.fields[index]:
+            return self.pos + self.fields[index]
+        return None
+
+    def scalar(self, index, fmt, default=0):
+        pos = self._field(index)
+        return default if pos is None else struct.unpack_from(fmt, self.buf, pos)[0]
+
+    def _indirect(self, pos):
+        return pos + struct.unpack_from("<I", self.buf, pos)[0]
+
+    def string(self, index):
+        pos = self._field(index)
+        if pos is None:
+            return None
+        pos = self._indirect(pos)
+        length = struct.unpack_from("<I", self.buf, pos)[0]
+        return self.buf[pos + 4 : pos + 4 + length].decode()
+
+    def tables(self, index):
+        pos = self._field(index)
+        if pos is None:
+            return []
+        pos = self._indirect(pos)
+        length = struct.unpack_from("<I", self.buf, pos)[0]
+        return [Table(self.buf, self._indirect(pos + 4 + 4 * i)) for i in range(length)]
+
+
+def used_operators(buf):
+    """Returns the (builtin name, custom name) of every operator the model runs."""
+    model = Table(buf, struct.unpack_from("<I", buf, 0)[0])
+    codes = []
+    for code in model.tables(1):
+        builtin = max(code.scalar(0, "<b"), code.scalar(3, "<i"))
+        custom = code.string(1) if builtin == CUSTOM else None
+        if builtin >= len(BUILTIN_OPERATORS):
+            raise ValueError(f"unknown builtin operator {builtin}")
+        codes.append((BUILTIN_OPERATORS[builtin], custom))
+
+    used = set()
+    for subgraph in model.tables(2):
+        for op in subgraph.tables(3):
+            used.add(op.scalar(0, "<I"))
+    return sorted({codes[i] for i in used}, key=lambda c: (c[1] or "", c[0]))
+
+
+def method_name(builtin, custom):
+    if custom is not None:
+        if custom not in CUSTOM_METHODS:
+            raise ValueError(f"no TFLM registration known for custom operator '{custom}'")
+        return "Add" + CUSTOM_METHODS[custom]
+    if builtin in METHOD_EXCEPTIONS:
+        return "Add" + METHOD_EXCEPTIONS[builtin]
+    # CONV_2D -> Conv2D, BATCH_TO_SPACE_ND -> BatchToSpaceNd, SPLIT_V -> SplitV.
+    parts = builtin.split("_")
+    return "Add" + "".join(p.upper() if p[0].isdigit() else p.capitalize() for p in parts)
+
+
+def check_methods(tflm_path, ops):
+    """Raises if a generated method is not declared by the TFLM resolver."""
+    header = tflm_path / "tensorflow" / "lite" / "micro" / "micro_mutable_op_resolver.h"
+    try:
+        declared = set(re.findall(r"TfLiteStatus\s+(Add\w+)\s*\(", header.read_text()))
+    except OSError as e:
+        raise ValueError(f"cannot read {header}: {e.strerror}")
+    missing = sorted({method_name(*op) for op in ops} - declared)
+    if missing:
+        raise ValueError(f"not declared by {header.name}: {', '.join(missing)}")
+
+
+def generate(model_path, name, ops):
+    guard = re.sub(r"(?<!^)(?=[A-Z])", "_", name).upper() + "_OP_RESOLVER_HPP"
+    count = f"kNumber{name}Operators"
+    lines = [
+        LICENSE,
+        "/*********************    Autogenerated file. DO NOT EDIT *******************",
+        f" * Generated from gen_op_resolver.py tool and {model_path.name} file.",
+        f" * Date: {datetime.now()}",
+        " ***************************************************************************/",
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        "#include <tensorflow/lite/micro/micro_mutable_op_resolver.h>",
+        "",
+        "namespace arm {",
+        "namespace app {",
+        "",
+        f"    /* Number of operators used by {model_path.name}. */",
+        f"    constexpr int {count} = {len(ops)};",
+        "",
+        "    /**",
+        "     * @brief   Creates a resolver with only the operators the model uses.",
+        "     * @return  MicroMutableOpResolver with the operators registered.",
+        "     */",
+        f"    inline tflite::MicroMutableOpResolver<{count}>",
+        f"    Create{name}OpResolver()",
+        "    {",
+        f"        tflite::MicroMutableOpResolver<{count}> resolver;",
+        "",
+    ]
+    lines += [f"        resolver.{method_name(*op)}();" for op in ops]
+    lines += [
+        "        return resolver;",
+        "    }",
+        "",
+        "} /* namespace app */",
+        "} /* namespace arm */",
+        "",
+        f"#endif /* {guard} */",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("model", type=Path, help=".tflite, .tflite.cpp or .tflite.cc file")
+    parser.add_argument("-o", "--output", type=Path, required=True, help="Header to write")
+    parser.add_argument("--name", default="Model",
+                        help="Prefix of the generated names (default: %(default)s)")
+    parser.add_argument("--tflm", type=Path,
+                        help="TensorFlow Lite Micro checkout to check the method names against")
+    args = parser.parse_args()
+
+    try:
+        ops = used_operators(read_model(args.model))
+        if args.tflm:
+            check_methods(args.tflm, ops)
+        header = generate(args.model, args.name, ops)
+    except (ValueError, struct.error) as e:
+        print(f"error: {args.model}: {e}", file=sys.stderr)
+        return 1
+
+    args.output.write_text(header)
+    for builtin, custom in ops:
+        print(f"{custom or builtin}")
+    print(f"{len(ops)} operators written to {args.output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
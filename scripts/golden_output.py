@@ -0,0 +1,223 @@
+#  SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+#  affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+"""
+Records reference output tensors of an example and compares runs with them.
+
+With GOLDEN_OUTPUT_DUMP defined, main_static and main_wav print every output
+tensor after inference (common/include/GoldenOutput.hpp):
+
+    GOLDEN_DUMP index=0 type=INT8 bytes=648 scale=0.134 zero_point=-26
+    GOLDEN_DATA index=0 offset=0 hex=e6e6e5...
+
+Subcommands:
+
+  generate  Writes the dumped tensors of a UART log as a source file of
+            reference outputs. Add the file to the .cproject.yml and define
+            GOLDEN_OUTPUT_CHECK: the example then compares its outputs on the
+            target and prints a GOLDEN result line.
+
+  compare   Compares the dumped tensors of two logs, e.g. before and after a
+            pre-processing change, or of the host build and the target, and
+            prints the largest error of each tensor.
+
+Examples:
+
+    python scripts/golden_output.py generate --log uart.log \\
+        --output object-detection/src/GoldenOutputs.cpp
+    python scripts/golden_output.py compare --log new.log --reference uart.log --tolerance 1
+
+The input must be the same for every run: the built-in sample audio, or for
+main_static the built-in image (BENCHMARK_INPUT_IMAGE) or seeded noise.
+"""
+import argparse
+import math
+import re
+import struct
+import sys
+from datetime import datetime
+from pathlib import Path
+
+DUMP_RE = re.compile(
+    r"GOLDEN_DUMP index=(\d+) type=(\w+) bytes=(\d+) scale=(\S+) zero_point=(-?\d+)")
+DATA_RE = re.compile(r"GOLDEN_DATA index=(\d+) offset=(\d+) hex=([0-9a-f]*)")
+
+# TfLiteTypeGetName() names of the types GoldenOutput compares.
+TYPES = {
+    "INT8": ("kTfLiteInt8", "b"),
+    "UINT8": ("kTfLiteUInt8", "B"),
+    "INT16": ("kTfLiteInt16", "h"),
+    "INT32": ("kTfLiteInt32", "i"),
+    "FLOAT32": ("kTfLiteFloat32", "f"),
+}
+
+
+class Tensor:
+    def __init__(self, index, type_name, size, scale, zero_point):
+        if type_name not in TYPES:
+            raise ValueError(f"tensor {index}: unsupported type {type_name}")
+        self.index = index
+        self.type_name = type_name
+        self.scale = scale
+        self.zero_point = zero_point
+        self.data = bytearray(size)
+        self.filled = 0
+
+    def values(self):
+        fmt = TYPES[self.type_name][1]
+        return struct.unpack(f"<{len(self.data) // struct.calcsize(fmt)}{fmt}", self.data)
+
+
+def read_log(path):
+    """Returns the tensors dumped in a UART log, in index order. A log with
+    several runs keeps the last dump of each index."""
+    tensors = {}
+    for line in path.read_text(errors="replace").splitlines():
+        match = DUMP_RE.search(line)
+        if match:
+            index = int(match.group(1))
+            tensors[index] = Tensor(index, match.group(2), int(match.group(3)),
+                                    float(match.group(4)), int(match.group(5)))
+            continue
+        match = DATA_RE.search(line)
+        if match:
+            index, offset = int(match.group(1)), int(match.group(2))
+            data = bytes.fromhex(match.group(3))
+            tensor = tensors.get(index)
+            if tensor is None or offset + len(data) > len(tensor.data):
+                raise ValueError(f"{path}: GOLDEN_DATA for tensor {index} out of place")
+            tensor.data[offset:offset + len(data)] = data
+            tensor.filled += len(data)
+
+    if not tensors:
+        raise ValueError(f"{path}: no GOLDEN_DUMP line found")
+    if sorted(tensors) != list(range(len(tensors))):
+        raise ValueError(f"{path}: tensors missing from the dump")
+    for tensor in tensors.values():
+        if tensor.filled != len(tensor.data):
+            raise ValueError(f"{path}: tensor {tensor.index} is incomplete (truncated log?)")
+    return [tensors[i] for i in range(len(tensors))]
+
+
+def hex_lines(data, indent):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + "    " + " ".join(f"0x{b:02x}," for b in data[i:i + 16]))
+    return "\n".join(lines)
+
+
+def generate(tensors, log):
+    arrays = []
+    entries = []
+    for tensor in tensors:
+        arrays.append(
+            f"    /* Output {tensor.index}: {tensor.type_name}, scale {tensor.scale:.9g},"
+            f" zero point {tensor.zero_point}. */\n"
+            f"    static const uint8_t tensor{tensor.index}[] = {{\n"
+            f"{hex_lines(tensor.data, '    ')}\n"
+            f"    }};\n")
+        entries.append(f"        {{{TYPES[tensor.type_name][0]}, tensor{tensor.index},"
+                       f" sizeof(tensor{tensor.index})}},")
+    return (
+        "/*\n"
+        f" * SPDX-FileCopyrightText: Copyright {datetime.now():%Y} Arm Limited and/or its\n"
+        " * affiliates <open-source-office@arm.com>\n"
+        " * SPDX-License-Identifier: Apache-2.0\n"
+        " *\n"
+        " * Licensed under the Apache License, Version 2.0 (the \"License\");\n"
+        " * you may not use this file except in compliance with the License.\n"
+        " * You may obtain a copy of the License at\n"
+        " *\n"
+        " *     http://www.apache.org/licenses/LICENSE-2.0\n"
+        " *\n"
+        " * Unless required by applicable law or agreed to in writing, software\n"
+        " * distributed under the License is distributed on an \"AS IS\" BASIS,\n"
+        " * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.\n"
+        " * See the License for the specific language governing permissions and\n"
+        " * limitations under the License.\n"
+        " */\n\n"
+        "/*\n"
+        f" * Reference outputs generated by golden_output.py from {log.name},\n"
+        f" * {datetime.now():%Y-%m-%d %H:%M:%S}.\n"
+        " */\n"
+        "#include \"GoldenOutput.hpp\"\n\n"
+        "namespace arm {\n"
+        "namespace app {\n"
+        "namespace golden {\n\n"
+        + "\n".join(arrays)
+        + "\n    extern const GoldenTensor tensors[] = {\n"
+        + "\n".join(entries)
+        + "\n    };\n\n"
+        f"    extern const size_t numTensors = {len(tensors)};\n\n"
+        "} /* namespace golden */\n"
+        "} /* namespace app */\n"
+        "} /* namespace arm */\n"
+    )
+
+
+def compare(tensors, references, tolerance):
+    """Prints the largest error of each tensor. Returns True if all match."""
+    if len(tensors) != len(references):
+        print(f"{len(tensors)} tensors, {len(references)} in the reference")
+        return False
+    failed = 0
+    for tensor, reference in zip(tensors, references):
+        if tensor.type_name != reference.type_name or len(tensor.data) != len(reference.data):
+            print(f"Tensor {tensor.index}: {tensor.type_name} of {len(tensor.data)} bytes,"
+                  f" reference {reference.type_name} of {len(reference.data)}: FAIL")
+            failed += 1
+            continue
+        errors = [abs(a - b) for a, b in zip(tensor.values(), reference.values())]
+        max_error = max(errors, default=0)
+        mismatches = sum(1 for e in errors if not e <= tolerance)
+        real = max_error * (reference.scale if reference.type_name != "FLOAT32"
+                            and reference.scale else 1)
+        print(f"Tensor {tensor.index}: {len(errors)} elements, max error {max_error:.6g}"
+              f" ({real:.6g} real), {mismatches} over {tolerance:g}"
+              + (" FAIL" if mismatches or math.isnan(max_error) else ""))
+        failed += bool(mismatches)
+    print(f"{'PASS' if not failed else 'FAIL'}: {failed} of {len(tensors)} tensors failed")
+    return not failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+    gen = commands.add_parser("generate", help="write reference outputs as a source file")
+    gen.add_argument("--log", type=Path, required=True, help="UART log with GOLDEN_DUMP lines")
+    gen.add_argument("-o", "--output", type=Path, required=True, help="Source to write")
+    cmp = commands.add_parser("compare", help="compare the outputs of two logs")
+    cmp.add_argument("--log", type=Path, required=True, help="UART log of the new run")
+    cmp.add_argument("--reference", type=Path, required=True, help="UART log of the reference")
+    cmp.add_argument("--tolerance", type=float, default=0,
+                     help="Largest accepted error of an element, in quantized steps"
+                          " (default: %(default)s, bit-exact)")
+    args = parser.parse_args()
+
+    try:
+        tensors = read_log(args.log)
+        if args.command == "generate":
+            args.output.write_text(generate(tensors, args.log))
+            print(f"{len(tensors)} tensors written to {args.output}")
+            return 0
+        return 0 if compare(tensors, read_log(args.reference), args.tolerance) else 2
+    except (OSError, ValueError, struct.error) as e:
+        print(f"error: {e}", file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,170 @@
+#  SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+#  affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+"""
+Packs WAV clips into the corpus format read by CorpusAudioSource
+(common/include/AudioSource.hpp) for replay from external flash.
+
+Directories are searched recursively. A clip's expected label is the name of
+the directory it is in (Speech Commands layout, e.g. yes/0a7c2a8d_nohash_0.wav)
+unless --label is given. Clips must be 16-bit PCM at --rate; stereo clips are
+down-mixed.
+
+Example, appending the corpus to the external flash image of the model so
+both can be written with `just flash_ext`:
+
+    python scripts/pack_audio_corpus.py speech_commands/yes speech_commands/no \\
+        --clip-samples 16000 --merge-into out/kws/kws.extflash.bin \\
+        --offset 0x800000 -o kws_with_corpus.extflash.bin
+
+and build with AUDIO_CORPUS_ADDRESS set to 0xC0000000 + offset.
+"""
+import argparse
+import struct
+import sys
+import wave
+import zlib
+from array import array
+from pathlib import Path
+
+MAGIC = 0x4353574B  # 'KWSC'
+VERSION = 1
+HEADER_FMT = "<IHHIIII8x"
+ENTRY_FMT = "<II24s32s"
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+ENTRY_SIZE = struct.calcsize(ENTRY_FMT)
+CLIP_ALIGN = 16
+
+
+def collect_wavs(paths):
+    wavs = []
+    for p in map(Path, paths):
+        if p.is_dir():
+            wavs.extend(sorted(p.rglob("*.wav")))
+        elif p.suffix.lower() == ".wav":
+            wavs.append(p)
+        else:
+            raise ValueError(f"{p} is neither a directory nor a .wav file")
+    return wavs
+
+
+def read_wav(path, rate):
+    with wave.open(str(path), "rb") as w:
+        if w.getsampwidth() != 2:
+            raise ValueError(f"{path}: only 16-bit PCM is supported")
+        if w.getframerate() != rate:
+            raise ValueError(f"{path}: sampled at {w.getframerate()} Hz, expected {rate} Hz")
+        channels = w.getnchannels()
+        samples = array("h", w.readframes(w.getnframes()))
+
+    if sys.byteorder != "little":
+        samples.byteswap()
+    if channels > 1:
+        samples = array(
+            "h",
+            (sum(samples[i : i + channels]) // channels for i in range(0, len(samples), channels)),
+        )
+    return samples
+
+
+def fit_length(samples, length):
+    if not length:
+        return samples
+    if len(samples) >= length:
+        return samples[:length]
+    return samples + array("h", bytes(2 * (length - len(samples))))
+
+
+def pack(wavs, rate, clip_samples, label):
+    table_end = HEADER_SIZE + ENTRY_SIZE * len(wavs)
+    offset = (table_end + CLIP_ALIGN - 1) // CLIP_ALIGN * CLIP_ALIGN
+
+    entries = bytearray()
+    data = bytearray(offset - table_end)
+    for path in wavs:
+        samples = fit_length(read_wav(path, rate), clip_samples)
+        clip_label = label if label is not None else path.parent.name
+
+        entries += struct.pack(
+            ENTRY_FMT,
+            offset,
+            len(samples),
+            clip_label.encode()[:23],
+            path.name.encode()[:31],
+        )
+
+        raw = samples.tobytes() if sys.byteorder == "little" else _swapped(samples)
+        raw += bytes(-len(raw) % CLIP_ALIGN)
+        data += raw
+        offset += len(raw)
+
+    body = bytes(entries) + bytes(data)
+    total = HEADER_SIZE + len(body)
+    header = struct.pack(
+        HEADER_FMT, MAGIC, VERSION, ENTRY_SIZE, len(wavs), rate, total, zlib.crc32(body)
+    )
+    return header + body
+
+
+def _swapped(samples):
+    copy = array("h", samples)
+    copy.byteswap()
+    return copy.tobytes()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("inputs", nargs="+", help="WAV files or directories")
+    parser.add_argument("-o", "--output", required=True, help="Output binary")
+    parser.add_argument("--rate", type=int, default=16000, help="Sampling rate of the clips (Hz)")
+    parser.add_argument(
+        "--clip-samples", type=int, default=0, help="Zero-pad or trim every clip to this length"
+    )
+    parser.add_argument("--label", help="Expected label for all clips (default: parent directory)")
+    parser.add_argument("--max-clips", type=int, default=0, help="Only pack the first N clips")
+    parser.add_argument("--merge-into", help="Image to place the corpus after (e.g. *.extflash.bin)")
+    parser.add_argument(
+        "--offset",
+        type=lambda v: int(v, 0),
+        default=0,
+        help="Offset of the corpus in the output when merging (bytes)",
+    )
+    args = parser.parse_args()
+
+    try:
+        wavs = collect_wavs(args.inputs)
+        if args.max_clips:
+            wavs = wavs[: args.max_clips]
+        if not wavs:
+            raise ValueError("no clips found")
+        corpus = pack(wavs, args.rate, args.clip_samples, args.label)
+    except (ValueError, OSError, wave.Error) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    image = b""
+    if args.merge_into:
+        image = Path(args.merge_into).read_bytes()
+        if len(image) > args.offset:
+            print(f"Error: {args.merge_into} ({len(image)} bytes) overlaps offset {args.offset:#x}")
+            sys.exit(1)
+        image += b"\xff" * (args.offset - len(image))
+
+    Path(args.output).write_bytes(image + corpus)
+    print(f"Packed {len(wavs)} clips, {len(corpus)} bytes at offset {len(image):#x} -> {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,194 @@
+#  SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+#  affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+"""
+Sends a model to a board running main_static with MODEL_SLOTS and
+MODEL_UPDATE_WINDOW_MS (device/alif-ensemble/include/ModelUpdate.hpp).
+
+The model goes into the inactive A/B slot of the OSPI flash and is used from
+the next boot; the application image is left alone. Start the script, then
+reset the board: the start frame is sent once the board prints that its update
+window is open. The board erases the slot before it answers, so the start
+frame is never repeated after that.
+
+Frames are fixed size, at the console rate for the start frame and at
+--baudrate for the rest:
+
+    A5 5A | type | 0 | seq (u16) | length (u16) | payload (4096) | CRC-32 (u32)
+
+The CRC covers everything but the two sync bytes. The board answers each frame
+with a code and a sequence number: ACK (every frame up to that sequence
+taken), NAK (resend from that sequence) or CAN (abandoned).
+
+Two frames are kept in flight (ModelUpdater::ms_window), one per receive
+buffer on the board: the ACK for a frame comes back while the next one is on
+the line, so the line stays busy as long as the round trip through the USB
+serial adapter is shorter than a frame (45 ms for 4 KiB at 921600 baud).
+
+Example:
+
+    python scripts/send_model_update.py /dev/ttyUSB0 object-detection/model.tflite
+"""
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+import serial
+
+SYNC = b"\xa5\x5a"
+START, DATA, END = 1, 2, 3
+ACK, NAK, CAN = 0x06, 0x15, 0x18
+
+CHUNK_SIZE = 4096  # ModelUpdater::ms_chunkSize
+WINDOW = 2  # ModelUpdater::ms_window
+FRAME_SIZE = 2 + 6 + CHUNK_SIZE + 4
+CONSOLE_BAUDRATE = 115200
+# End of the line main_static prints when its update window opens.
+WINDOW_BANNER = b"for a model update"
+
+# Erasing the slot happens before the start frame is acknowledged.
+ERASE_TIMEOUT = 120.0
+# Reading the model back and writing the slot header.
+COMMIT_TIMEOUT = 30.0
+RETRIES = 8
+
+
+def frame(kind, seq, payload=b""):
+    body = struct.pack("<BBHH", kind, 0, seq, len(payload)) + payload.ljust(CHUNK_SIZE, b"\xff")
+    return SYNC + body + struct.pack("<I", zlib.crc32(body))
+
+
+def frame_time(baudrate):
+    return 10.0 * FRAME_SIZE / baudrate
+
+
+def read_response(port, timeout):
+    port.timeout = timeout
+    resp = port.read(3)
+    if len(resp) != 3:
+        return None, None
+    code, seq = struct.unpack("<BH", resp)
+    return code, seq
+
+
+def start(port, model, baudrate, wait):
+    payload = struct.pack("<III", len(model), zlib.crc32(model), baudrate)
+    print(f"Waiting for the board (reset it now), up to {wait:.0f} s")
+    deadline = time.monotonic() + wait
+    port.reset_input_buffer()
+    port.timeout = 0.1
+    console = b""
+    while WINDOW_BANNER not in console:
+        if time.monotonic() >= deadline:
+            sys.exit("Board did not open its update window")
+        console = (console + port.read(max(port.in_waiting, 1)))[-256:]
+
+    port.write(frame(START, 0, payload))
+    port.flush()
+
+    # The board erases the slot before answering. The start frame is not sent
+    # again: a second one would arrive after the board switched to the
+    # transfer rate, as a bad first data frame.
+    deadline = time.monotonic() + ERASE_TIMEOUT
+    first = b""
+    while not first or first[0] not in (ACK, CAN):
+        port.timeout = max(deadline - time.monotonic(), 0)
+        first = port.read(1)
+        if not first:
+            sys.exit("No answer from the board")
+    port.timeout = frame_time(CONSOLE_BAUDRATE) + 0.5
+    rest = port.read(2)
+    if first[0] == CAN:
+        sys.exit("Board refused the model: too large for a slot, or erase failed")
+    if len(rest) != 2:
+        sys.exit("Incomplete answer from the board")
+
+
+def send(port, model, baudrate):
+    chunks = [model[i:i + CHUNK_SIZE] for i in range(0, len(model), CHUNK_SIZE)]
+    frames = [frame(DATA, seq + 1, chunk) for seq, chunk in enumerate(chunks)]
+    frames.append(frame(END, len(frames) + 1))
+
+    # Go-back-N over a window of WINDOW frames: frames[index] is the oldest
+    # one not acknowledged, frames[queued - 1] the last one written. Frame i
+    # carries sequence i + 1.
+    timeout = WINDOW * frame_time(baudrate) + 0.2
+    index, queued, retries, sent = 0, 0, 0, time.monotonic()
+    while index < len(frames):
+        while queued < len(frames) and queued - index < WINDOW:
+            port.write(frames[queued])
+            queued += 1
+        is_end = index == len(frames) - 1
+        code, seq = read_response(port, COMMIT_TIMEOUT if is_end else timeout)
+        if code == ACK and index < seq <= queued:
+            index, retries = seq, 0
+            done = min(index * CHUNK_SIZE, len(model))
+            rate = done / max(time.monotonic() - sent, 1e-6)
+            print(f"\r{done} / {len(model)} bytes, {rate / 1024:.1f} KiB/s", end="", flush=True)
+            continue
+        if code == ACK:
+            # Late answer to a frame since resent.
+            continue
+        if code == CAN:
+            print()
+            sys.exit(f"Board abandoned the update at frame {seq}")
+        retries += 1
+        if retries > RETRIES:
+            print()
+            sys.exit(f"Too many retries at frame {index + 1}")
+        # The board drained the line before a NAK; without an answer, resend
+        # the window.
+        if code == NAK and index < seq <= queued:
+            index = seq - 1
+        queued = index
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("port", help="Serial port of the board's console")
+    parser.add_argument("model", help=".tflite file, after Vela for NPU targets")
+    parser.add_argument(
+        "--baudrate",
+        type=int,
+        default=921600,
+        help="Line rate during the transfer (MODEL_UPDATE_BAUDRATE)",
+    )
+    parser.add_argument(
+        "--wait", type=float, default=60.0, help="Seconds to wait for the board"
+    )
+    args = parser.parse_args()
+
+    with open(args.model, "rb") as f:
+        model = f.read()
+
+    with serial.Serial(args.port, CONSOLE_BAUDRATE) as port:
+        start(port, model, args.baudrate, args.wait)
+        # The board switches once its acknowledgement is out.
+        time.sleep(0.02)
+        port.baudrate = args.baudrate
+        send(port, model, args.baudrate)
+        port.baudrate = CONSOLE_BAUDRATE
+
+    print(f"Model sent ({len(model)} bytes, CRC-32 0x{zlib.crc32(model):08x}): "
+          "the board uses it after its next reset")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,156 @@
+#  SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+#  affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+"""
+Finds the tensor arena size a model needs and writes it as ACTIVATION_BUF_SZ
+into a project's .cproject.yml.
+
+The size comes from one of:
+
+  --log     The UART output of an example. After inference, main_static and
+            main_wav print how much of the arena the model used, as held by
+            the TFLM allocator, plus any temporary buffers Model::Init wrote
+            past the head (common/include/ArenaUsage.hpp):
+
+                ARENA_USAGE size=2097152 head=55296 tail=6128 used=61424
+
+            This is measured on the target, including Vela models.
+
+  --model   A .tflite file or generated .tflite.cpp/.tflite.cc source. The
+            model is allocated on the host with the TFLM Python interpreter
+            (pip install tflite-micro), bisecting the smallest arena it fits
+            in. The host build has 64-bit pointers, so the persistent part is
+            somewhat larger than on the target: the result is an upper bound.
+            Models with custom operators (e.g. ethos-u after Vela) cannot be
+            allocated on the host; use --log for those.
+
+Examples:
+
+    python scripts/size_tensor_arena.py --log uart.log --project kws/kws.cproject.yml
+    python scripts/size_tensor_arena.py \\
+        --model object-detection/src/yolo-fastest_192_face_v4.tflite.cpp \\
+        --project object-detection/object-detection.cproject.yml
+
+Without --project the size is only printed. Run the example once with a large
+enough arena (e.g. the 2 MB default of BufAttributes.hpp) to get the log.
+"""
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+from gen_op_resolver import read_model, used_operators
+
+# TFLM aligns buffers in the arena to 16 bytes.
+ARENA_ALIGNMENT = 16
+
+# Limits of the host bisection.
+MIN_ARENA_SIZE = 1024
+MAX_ARENA_SIZE = 64 * 1024 * 1024
+
+ARENA_USAGE_RE = re.compile(r"ARENA_USAGE size=(\d+) head=(\d+) tail=(\d+) used=(\d+)")
+DEFINE_RE = re.compile(r"^(\s*)#?\s*-\s*ACTIVATION_BUF_SZ\s*:.*$", re.M)
+
+
+def size_from_log(path):
+    """Returns the largest arena use reported in a UART log."""
+    usages = [tuple(map(int, m)) for m in ARENA_USAGE_RE.findall(path.read_text(errors="replace"))]
+    if not usages:
+        raise ValueError("no ARENA_USAGE line found")
+    size, head, tail, used = max(usages, key=lambda u: u[3])
+    if not head + tail:
+        raise ValueError("arena usage is zero: was the inference run?")
+    print(f"Target: {used} of {size} bytes used (head {head}, tail {tail})")
+    return used
+
+
+def size_from_model(path):
+    """Returns the smallest arena the TFLM host interpreter allocates the model in."""
+    buf = read_model(path)
+    custom = [c for _, c in used_operators(buf) if c is not None]
+    if custom:
+        raise ValueError(f"custom operators {', '.join(custom)} cannot run on the host, "
+                         "use --log")
+
+    try:
+        from tflite_micro import runtime
+    except ImportError:
+        raise ValueError("the tflite-micro Python package is needed for --model")
+
+    def fits(size):
+        try:
+            runtime.Interpreter.from_bytes(buf, arena_size=size)
+            return True
+        except RuntimeError:
+            return False
+
+    if not fits(MAX_ARENA_SIZE):
+        raise ValueError(f"model does not fit in {MAX_ARENA_SIZE} bytes")
+
+    low, high = MIN_ARENA_SIZE, MAX_ARENA_SIZE
+    while high - low > ARENA_ALIGNMENT:
+        mid = (low + high) // 2
+        if fits(mid):
+            high = mid
+        else:
+            low = mid
+    print(f"Host: model fits in {high} bytes")
+    return high
+
+
+def update_project(path, size):
+    """Sets ACTIVATION_BUF_SZ in the define list of a .cproject.yml."""
+    text = path.read_text()
+    line = f"- ACTIVATION_BUF_SZ: {size}"
+
+    match = DEFINE_RE.search(text)
+    if match:
+        text = text[: match.start()] + match.group(1) + line + text[match.end() :]
+    else:
+        define = re.search(r"^(\s*)define:\s*\n", text, re.M)
+        if not define:
+            raise ValueError("no define list found")
+        indent = define.group(1) + "  "
+        text = text[: define.end()] + indent + line + "\n" + text[define.end() :]
+    path.write_text(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--log", type=Path, help="UART log with an ARENA_USAGE line")
+    source.add_argument("--model", type=Path, help=".tflite, .tflite.cpp or .tflite.cc file")
+    parser.add_argument("--project", type=Path, help=".cproject.yml to update")
+    parser.add_argument("--margin", type=int, default=256,
+                        help="Bytes added to the measured size (default: %(default)s)")
+    args = parser.parse_args()
+
+    try:
+        used = size_from_log(args.log) if args.log else size_from_model(args.model)
+        size = -(-(used + args.margin) // ARENA_ALIGNMENT) * ARENA_ALIGNMENT
+        print(f"ACTIVATION_BUF_SZ: {size}")
+        if args.project:
+            update_project(args.project, size)
+            print(f"Written to {args.project}")
+    except (OSError, ValueError, struct.error) as e:
+        print(f"error: {e}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())